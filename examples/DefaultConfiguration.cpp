@@ -1,5 +1,6 @@
 #include <ee/Log.hpp>
 #include <iostream>
+#include <list>
 
 int main() {
     // Apply the default logging configuration
@@ -0,0 +1,272 @@
+#ifndef EASY_EXCEPTION_ASYNCWRITER_H
+#define EASY_EXCEPTION_ASYNCWRITER_H
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+namespace ee {
+
+    /**
+     * @brief Writes blocks of files in the background, so the thread that formats the logs never waits for the disk.
+     *
+     * The writer owns a few buffers of BufferSize bytes. A block is copied into a free buffer and submitted, the
+     * buffer is recycled once the kernel completed the write, a writer only waits if all buffers are in flight. On
+     * Linux the blocks are submitted through io_uring with registered buffers, a durable write links an fsync to its
+     * last block. Where io_uring is not available a small pool of threads writes the blocks with pwrite. Every block
+     * is written at its own offset, so the order in which the writes complete does not matter. Until the writer is
+     * started every block is written on the calling thread.
+     */
+    class AsyncWriter {
+    public:
+        /**
+         * @brief The number of bytes of a buffer.
+         */
+        static constexpr size_t BufferSize = 1024 * 1024;
+
+        /**
+         * @brief The number of buffers that may be in flight at once.
+         */
+        static constexpr size_t NumberOfBuffers = 8;
+
+        /**
+         * @brief The number of writes and fsyncs that may be in flight at once.
+         */
+        static constexpr size_t MaxNumberOfOperations = 32;
+
+        /**
+         * @brief The number of threads that write the blocks if io_uring is not available.
+         */
+        static constexpr size_t NumberOfThreads = 2;
+
+        /**
+         * @brief The way the blocks are written.
+         */
+        enum class Backend : uint8_t {
+            None, IoUring, ThreadPool
+        };
+
+        /**
+         * @brief A file the writer writes into, it is closed once the last write that uses it completed.
+         */
+        class File {
+        public:
+            /**
+             * @brief Constructor, takes over the given descriptor.
+             *
+             * @param fileDescriptor The descriptor of a file that is open for writing.
+             */
+            explicit File(int fileDescriptor) noexcept;
+
+            File(const File&) = delete;
+            File& operator=(const File&) = delete;
+
+            /**
+             * @brief Destructor, closes the file.
+             */
+            ~File() noexcept;
+
+            /**
+             * @brief Returns the descriptor of the file.
+             *
+             * @return The file descriptor.
+             */
+            int getFileDescriptor() const noexcept;
+
+            /**
+             * @brief Waits until all writes of the file that were submitted so far completed.
+             *
+             * @return False if a write failed since the last call.
+             */
+            bool wait() noexcept;
+
+        private:
+            friend class AsyncWriter;
+
+            /**
+             * @brief The descriptor of the file.
+             */
+            int mFileDescriptor;
+
+            /**
+             * @brief The number of writes and fsyncs submitted for the file.
+             */
+            size_t mNumberOfSubmitted = 0;
+
+            /**
+             * @brief The number of writes and fsyncs of the file that completed.
+             */
+            size_t mNumberOfCompleted = 0;
+
+            /**
+             * @brief The number of writes a thread of the pool executes right now, an fsync waits for them.
+             */
+            size_t mNumberOfRunningWrites = 0;
+
+            /**
+             * @brief True if a write failed since the last call of wait().
+             */
+            bool mFailed = false;
+        };
+
+        /**
+         * @brief Starts the writer, a running writer is stopped before.
+         *
+         * @param backend The preferred backend, the thread pool is used if io_uring is not available.
+         * @return The backend that is used, None if neither could be started.
+         */
+        static Backend start(Backend backend = Backend::IoUring) noexcept;
+
+        /**
+         * @brief Waits for all writes in flight and stops the writer.
+         */
+        static void stop() noexcept;
+
+        /**
+         * @brief Returns the way the blocks are written right now.
+         *
+         * @return The backend or None if the writer is not started.
+         */
+        static Backend getBackend() noexcept;
+
+        /**
+         * @brief Submits the given bytes and returns once they are copied, large blocks are split into buffers.
+         *
+         * @param file The file to write into.
+         * @param data The first byte or nullptr.
+         * @param size The number of bytes.
+         * @param offset The position in the file of the first byte.
+         * @param sync True to fsync the file once these bytes and all bytes submitted before are written.
+         * @return False if the bytes could not be submitted, or could not be written while the writer is stopped.
+         */
+        static bool write(
+                const std::shared_ptr<File>& file,
+                const char* data,
+                size_t size,
+                uint64_t offset,
+                bool sync = false) noexcept;
+
+        /**
+         * @brief Waits until all writes submitted so far completed.
+         */
+        static void flush() noexcept;
+
+        /**
+         * @brief Returns the number of writes and fsyncs that completed in the background.
+         *
+         * @return The number of completions.
+         */
+        static size_t getNumberOfCompletions() noexcept;
+
+    private:
+        /**
+         * @brief A write or fsync in flight.
+         *
+         * A write and the fsync linked to it name each other. A short or failed write cancels its linked fsync, so the
+         * thread that reaps the completions runs the fsync itself once the write is finished, or fails it with the
+         * write. The flags of the fsync track which of the two completions arrived first and how the write ended.
+         */
+        struct Operation {
+            std::shared_ptr<File> file;
+            uint64_t offset;
+            size_t size;
+            size_t buffer;
+            bool sync;
+            size_t linked;
+            bool reaped;
+            bool succeeded;
+            bool cancelled;
+        };
+
+        /**
+         * @brief Submits the given operations, operations the kernel refuses are executed on the calling thread.
+         *
+         * @param lock The lock of the mutex the caller holds, it is released while refused operations are executed.
+         * @param first The index of the first operation.
+         * @param second The index of an operation that follows the first one or SIZE_MAX.
+         */
+        static void submit(std::unique_lock<std::mutex>& lock, size_t first, size_t second) noexcept;
+
+        /**
+         * @brief Executes an operation on the calling thread.
+         *
+         * @param operation The operation.
+         * @return True if the operation succeeded.
+         */
+        static bool execute(const Operation& operation) noexcept;
+
+        /**
+         * @brief Marks an operation as completed and recycles its buffer.
+         *
+         * @param index The index of the operation.
+         * @param result True if the operation succeeded.
+         */
+        static void complete(size_t index, bool result) noexcept;
+
+        /**
+         * @brief Guards the state of the writer.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Wakes up the threads of the pool when an operation is queued or they should stop.
+         */
+        static std::condition_variable Condition;
+
+        /**
+         * @brief Notifies waiting writers whenever an operation completed.
+         */
+        static std::condition_variable Recycled;
+
+        /**
+         * @brief The way the blocks are written right now.
+         */
+        static Backend CurrentBackend;
+
+        /**
+         * @brief The memory of all buffers.
+         */
+        static std::vector<char> Memory;
+
+        /**
+         * @brief The indices of the buffers that are not in flight.
+         */
+        static std::vector<size_t> FreeBuffers;
+
+        /**
+         * @brief The operations, an index is only in use while it is in flight.
+         */
+        static std::vector<Operation> Operations;
+
+        /**
+         * @brief The indices of the operations that are not in flight.
+         */
+        static std::vector<size_t> FreeOperations;
+
+        /**
+         * @brief The number of operations that are in flight.
+         */
+        static size_t NumberOfPendingOperations;
+
+        /**
+         * @brief The operations the threads of the pool still have to execute, in the order they were submitted.
+         */
+        static std::vector<size_t> Queue;
+
+        /**
+         * @brief The threads of the pool or the thread that reaps the completions of io_uring.
+         */
+        static std::vector<std::thread> Threads;
+
+        /**
+         * @brief The number of writes and fsyncs that completed in the background.
+         */
+        static std::atomic_size_t NumberOfCompletions;
+    };
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef EASY_EXCEPTION_EMERGENCYRESERVE_H
+#define EASY_EXCEPTION_EMERGENCYRESERVE_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace ee {
+
+#ifndef EASY_EXCEPTION_EMERGENCY_RESERVE
+#define EASY_EXCEPTION_EMERGENCY_RESERVE 1048576
+#endif
+
+    /**
+     * @brief Holds a preallocated memory reserve that is handed back to the heap when operator new fails.
+     *
+     * The reserve is split into chunks. Every time an allocation fails the installed new-handler releases one chunk
+     * and operator new retries, so exceptions, log entries and the crash file can still be created while the
+     * process is out of memory.
+     */
+    class EmergencyReserve {
+    public:
+        /**
+         * @brief Allocates the reserve and installs the new-handler.
+         *
+         * A previously allocated reserve will be released first.
+         * @param bytes The total size of the reserve in bytes.
+         * @param numberOfChunks The number of chunks the reserve is split into.
+         * @return True if the whole reserve could be allocated.
+         */
+        static bool reserve(size_t bytes, size_t numberOfChunks = 8) noexcept;
+
+        /**
+         * @brief Tries to allocate all chunks again that have been released by the new-handler.
+         *
+         * @return True if the reserve is complete again.
+         */
+        static bool refill() noexcept;
+
+        /**
+         * @brief Frees the whole reserve and restores the previous new-handler.
+         */
+        static void release() noexcept;
+
+        /**
+         * @brief Returns the number of bytes currently held by the reserve.
+         *
+         * @return Number of bytes held by the reserve.
+         */
+        static size_t getReservedSize() noexcept;
+
+        /**
+         * @brief Returns how often the new-handler had to release a chunk since the reserve was created.
+         *
+         * @return Number of released chunks.
+         */
+        static size_t getNumberOfReleases() noexcept;
+
+    private:
+        /**
+         * @brief The new-handler that releases one chunk for every failed allocation.
+         */
+        static void newHandler();
+
+    private:
+        /**
+         * @brief The maximum number of chunks the reserve can be split into.
+         */
+        static constexpr size_t MaxNumberOfChunks = 64;
+
+        /**
+         * @brief The mutex that must be locked every time the chunks are modified.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Holds the chunks, the first NumberOfChunks are allocated.
+         */
+        static void* Chunks[MaxNumberOfChunks];
+
+        /**
+         * @brief The number of chunks that are currently allocated.
+         */
+        static size_t NumberOfChunks;
+
+        /**
+         * @brief The number of chunks the reserve consists of when complete.
+         */
+        static size_t TotalNumberOfChunks;
+
+        /**
+         * @brief The size of a single chunk in bytes.
+         */
+        static size_t ChunkSize;
+
+        /**
+         * @brief Counts how often a chunk was released by the new-handler.
+         */
+        static size_t NumberOfReleases;
+
+        /**
+         * @brief The new-handler that was installed before ours.
+         */
+        static std::new_handler PreviousHandler;
+    };
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <chrono>
 #include <vector>
 #include <cstring>
+#include <typeinfo>
 
 #include "Note.hpp"
 #include "Stacktrace.hpp"
@@ -41,6 +42,24 @@ namespace ee {
                 OutputFormat format = OutputFormat::EASY_EXCEPTION_OUTPUT_FORMAT
                         ) noexcept;
 
+    protected:
+        /**
+         * @brief Constructor for derived exceptions that names their own type.
+         *
+         * @param type The type of the derived exception, used for the throw statistics.
+         * @param caller The caller of this exception (typically __PRETTY_FUNCTION__).
+         * @param message The message of this exception.
+         * @param infos A list of infos
+         */
+        Exception(
+                const std::type_info& type,
+                std::string caller,
+                std::string message,
+                std::vector<ee::Note> infos,
+                OutputFormat format = OutputFormat::EASY_EXCEPTION_OUTPUT_FORMAT
+                        ) noexcept;
+
+    public:
         /**
          * @brief Reads an key-value-pair in and stores the values.
          *
@@ -138,6 +157,6 @@ namespace ee {
 /**
  * @brief Helps defining an custom exception.
  */
-#define DEFINE_EXCEPTION(name) class name : public ee::Exception {public:explicit name(const std::string &caller, const std::string& message, const std::vector<ee::Note>& info):ee::Exception(caller,message,info){}}
+#define DEFINE_EXCEPTION(name) class name : public ee::Exception {public:explicit name(const std::string &caller, const std::string& message, const std::vector<ee::Note>& info):ee::Exception(typeid(name),caller,message,info){}}
 
 #endif
\ No newline at end of file
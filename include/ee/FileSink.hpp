@@ -0,0 +1,226 @@
+#ifndef EASY_EXCEPTION_FILESINK_H
+#define EASY_EXCEPTION_FILESINK_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+
+#include "AsyncWriter.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Appends formatted logs to a file that stays open across incidents.
+     *
+     * The logs are formatted directly into a large buffer that is handed to the kernel in few large calls instead of
+     * one call per log entry. Nothing reaches the file until the buffer is full or flush() is called. The sink checks
+     * on every open() whether its path still refers to the open file, so a file that has been removed or rotated is
+     * created again. While the AsyncWriter is running, a newly opened file is written in the background at explicit
+     * offsets, flush() then only submits the bytes and wait() returns once they are written.
+     */
+    class FileSink {
+    public:
+        /**
+         * @brief The number of bytes that are collected before they are written.
+         */
+        static constexpr size_t BufferSize = 1024 * 1024;
+
+        /**
+         * @brief The number of sinks get() keeps open.
+         */
+        static constexpr size_t MaxNumberOfSinks = 8;
+
+        /**
+         * @brief Constructor, the file is not opened yet.
+         *
+         * @param filename The name of the file.
+         */
+        explicit FileSink(std::string filename) noexcept;
+
+        FileSink(const FileSink&) = delete;
+        FileSink& operator=(const FileSink&) = delete;
+
+        /**
+         * @brief Destructor, flushes and closes the file.
+         */
+        ~FileSink() noexcept;
+
+        /**
+         * @brief Returns the shared sink of the given file and creates it if necessary.
+         *
+         * The sinks stay open until they are evicted because too many files are in use or closeAll() is called.
+         * @param filename The name of the file.
+         * @return The sink or nullptr if there was not enough memory to create it.
+         */
+        static std::shared_ptr<FileSink> get(const std::string& filename) noexcept;
+
+        /**
+         * @brief Flushes and closes all sinks created by get().
+         */
+        static void closeAll() noexcept;
+
+        /**
+         * @brief Flushes and closes the sink of the given file and removes it from the shared sinks.
+         *
+         * @param filename The name of the file.
+         */
+        static void release(const std::string& filename) noexcept;
+
+        /**
+         * @brief Opens the file for appending, or opens it again if the path refers to another file by now.
+         *
+         * @return True if the file is open.
+         */
+        bool open() noexcept;
+
+        /**
+         * @brief Flushes and closes the file, waits for the bytes written in the background.
+         */
+        void close() noexcept;
+
+        /**
+         * @brief Returns whether the file is open.
+         *
+         * @return True if the file is open.
+         */
+        bool isOpen() const noexcept;
+
+        /**
+         * @brief Returns the buffer the caller formats into, commit() hands it over to the file.
+         *
+         * @return The buffer.
+         */
+        std::string& getBuffer() noexcept;
+
+        /**
+         * @brief Writes the buffer if it has grown to at least BufferSize bytes.
+         *
+         * @return False if the file could not be written.
+         */
+        bool commit() noexcept;
+
+        /**
+         * @brief Appends the given bytes, a large block is written together with the buffer without copying it.
+         *
+         * @param data The first byte.
+         * @param size The number of bytes.
+         * @return False if the file could not be written.
+         */
+        bool write(const char* data, size_t size) noexcept;
+
+        /**
+         * @brief Writes all buffered bytes to the file.
+         *
+         * @return False if the file could not be written.
+         */
+        bool flush() noexcept;
+
+        /**
+         * @brief Writes all buffered bytes and makes everything written so far durable with fsync.
+         *
+         * In the background the fsync is linked to the last block and this call does not wait for it.
+         * @return False if the file could not be written.
+         */
+        bool sync() noexcept;
+
+        /**
+         * @brief Waits until all bytes written in the background reached the file.
+         *
+         * @return False if a write in the background failed since the last call.
+         */
+        bool wait() noexcept;
+
+        /**
+         * @brief Returns the position in the file of the next byte handed to the sink.
+         *
+         * @return The size of the file once everything buffered so far is written.
+         */
+        uint64_t getPosition() const noexcept;
+
+        /**
+         * @brief Returns the mutex the caller has to hold while using a shared sink.
+         *
+         * @return The mutex of this sink.
+         */
+        std::mutex& getMutex() noexcept;
+
+        /**
+         * @brief Returns the name of the file.
+         *
+         * @return The filename.
+         */
+        const std::string& getFilename() const noexcept;
+
+        /**
+         * @brief Returns the number of calls that handed bytes over to the kernel.
+         *
+         * @return The number of write calls.
+         */
+        size_t getNumberOfWrites() const noexcept;
+
+    private:
+        /**
+         * @brief Writes the buffer and the given bytes with as few calls as possible and clears the buffer.
+         *
+         * @param data The first byte behind the buffer or nullptr.
+         * @param size The number of bytes behind the buffer.
+         * @param sync True to make the file durable afterwards.
+         * @return False if the file could not be written.
+         */
+        bool writeBuffer(const char* data, size_t size, bool sync = false) noexcept;
+
+        /**
+         * @brief Guards the shared sinks.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief The sinks created by get().
+         */
+        static std::map<std::string, std::shared_ptr<FileSink>> Sinks;
+
+        /**
+         * @brief Guards the sink against concurrent writers.
+         */
+        std::mutex mMutex;
+
+        /**
+         * @brief The name of the file.
+         */
+        std::string mFilename;
+
+        /**
+         * @brief The descriptor of the open file or -1.
+         */
+        int mFileDescriptor = -1;
+
+        /**
+         * @brief True if the sink created the file and has not marked it as dirty yet.
+         */
+        bool mCreated = false;
+
+        /**
+         * @brief The file while it is written in the background, it owns the descriptor then.
+         */
+        std::shared_ptr<AsyncWriter::File> mFile;
+
+        /**
+         * @brief The position of the next byte written to the file, blocks written in the background are written there.
+         */
+        uint64_t mOffset = 0;
+
+        /**
+         * @brief The bytes that are not written yet.
+         */
+        std::string mBuffer;
+
+        /**
+         * @brief The number of calls that handed bytes over to the kernel.
+         */
+        size_t mNumberOfWrites = 0;
+    };
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef EASY_EXCEPTION_FLIGHTRECORDER_H
+#define EASY_EXCEPTION_FLIGHTRECORDER_H
+
+#include <mutex>
+#include <atomic>
+#include <string>
+
+#include "LogEntry.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Keeps the recent log entries of every thread in a memory mapped file that survives a killed process.
+     *
+     * Every thread owns a slot of the file with a ring of records created by the LogCodec, so recording a log entry
+     * needs no lock. The pages belong to the file, the kernel keeps them even if the process is killed without a
+     * chance to run any handler. A clean shutdown removes the file, a file that is still there at the next start
+     * belongs to a run that died and recover() converts it into a normal log file.
+     */
+    class FlightRecorder {
+    public:
+        /**
+         * @brief The number of bytes of the file header and of every slot header.
+         */
+        static constexpr size_t HeaderSize = 64;
+
+        /**
+         * @brief The smallest number of bytes of the ring of a slot.
+         */
+        static constexpr size_t MinSlotSize = 4096;
+
+        /**
+         * @brief The largest number of threads that can be recorded.
+         */
+        static constexpr size_t MaxNumberOfSlots = 256;
+
+        /**
+         * @brief Creates the file, maps it and starts recording.
+         *
+         * An existing file is overwritten, call recover() before to keep its log entries. The file is removed by
+         * close(), which is also called when the program exits normally.
+         * @param filename The name of the file, every process should use its own file.
+         * @param slotSize The number of bytes of the ring of every thread.
+         * @param numberOfSlots The number of threads that can be recorded, further threads are not recorded.
+         * @return True if the file could be created and mapped.
+         */
+        static bool open(const std::string& filename, size_t slotSize, size_t numberOfSlots = 64) noexcept;
+
+        /**
+         * @brief Stops recording, unmaps the file and removes it.
+         */
+        static void close() noexcept;
+
+        /**
+         * @brief Returns whether log entries are recorded.
+         *
+         * @return True if the file is open.
+         */
+        static bool isOpen() noexcept;
+
+        /**
+         * @brief Appends the given log entry to the slot of the calling thread.
+         *
+         * @param logEntry The log entry.
+         */
+        static void record(const LogEntry& logEntry) noexcept;
+
+        /**
+         * @brief Converts the rings of a file left behind by a previous run into a log file.
+         *
+         * The log entries of all threads are merged chronologically and appended to the log file. The recorder file
+         * is removed afterwards, a file that is open in this process is not touched.
+         * @param filename The name of the recorder file.
+         * @param logFilename The name of the log file.
+         * @return The number of recovered log entries, zero if there is no valid recorder file.
+         */
+        static size_t recover(const std::string& filename, const std::string& logFilename) noexcept;
+
+        /**
+         * @brief Returns the number of log entries recorded since the program started.
+         *
+         * @return The number of recorded log entries.
+         */
+        static size_t getNumberOfRecordedLogEntries() noexcept;
+
+    private:
+        /**
+         * @brief Guards opening and closing.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief True while log entries are recorded.
+         */
+        static std::atomic_bool Open;
+
+        /**
+         * @brief Incremented on every open(), the threads claim a new slot when it changes.
+         */
+        static std::atomic_size_t Generation;
+
+        /**
+         * @brief The index of the next free slot.
+         */
+        static std::atomic_size_t NextSlot;
+
+        /**
+         * @brief The name of the open file.
+         */
+        static std::string Filename;
+
+        /**
+         * @brief The first byte of the mapped file or nullptr.
+         */
+        static char* Mapping;
+
+        /**
+         * @brief The number of mapped bytes.
+         */
+        static size_t MappingSize;
+
+        /**
+         * @brief The number of bytes of the ring of every slot.
+         */
+        static size_t SlotSize;
+
+        /**
+         * @brief The number of slots of the file.
+         */
+        static size_t NumberOfSlots;
+
+        /**
+         * @brief The number of log entries recorded since the program started.
+         */
+        static std::atomic_size_t NumberOfRecordedLogEntries;
+    };
+
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef EASY_EXCEPTION_FORMATTER_H
+#define EASY_EXCEPTION_FORMATTER_H
+
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <thread>
+
+#include "Exception.hpp"
+#include "LogEntry.hpp"
+
+namespace ee {
+
+    /**
+     * @brief The formatter engine that is shared by exceptions, log entries, files and outstreams.
+     *
+     * Every method appends directly to a caller provided buffer and never clears it. A buffer that is reused will
+     * stop allocating as soon as it has grown large enough. The methods may throw std::bad_alloc when the buffer
+     * can not grow anymore. The json layout writes every object into a single line (JSON Lines).
+     */
+    class Formatter {
+    public:
+        /**
+         * @brief The time zone of the timestamps.
+         */
+        enum class Timezone : uint8_t {
+            Utc, Local
+        };
+
+        /**
+         * @brief Appends the given log entry in the given format.
+         *
+         * @param buffer The buffer to append to.
+         * @param logEntry The log entry to format.
+         * @param format The output format to use.
+         */
+        static void write(std::string& buffer, const LogEntry& logEntry, OutputFormat format);
+
+        /**
+         * @brief Appends the given log entry in the given format and names the thread it belongs to.
+         *
+         * The string format names the thread by its hash in angle brackets behind the date.
+         * @param buffer The buffer to append to.
+         * @param logEntry The log entry to format.
+         * @param format The output format to use.
+         * @param threadId The id of the thread that created the log entry or nullptr if unknown.
+         */
+        static void write(
+                std::string& buffer,
+                const LogEntry& logEntry,
+                OutputFormat format,
+                const std::thread::id* threadId);
+
+        /**
+         * @brief Appends the given log entry in the given format and names the thread by its hash.
+         *
+         * The string format names the thread in angle brackets behind the date.
+         * @param buffer The buffer to append to.
+         * @param logEntry The log entry to format.
+         * @param format The output format to use.
+         * @param threadHash The hash of the id of the thread that created the log entry.
+         */
+        static void write(std::string& buffer, const LogEntry& logEntry, OutputFormat format, size_t threadHash);
+
+        /**
+         * @brief Appends the given exception in the given format.
+         *
+         * @param buffer The buffer to append to.
+         * @param exception The exception to format.
+         * @param format The output format to use.
+         */
+        static void write(std::string& buffer, const Exception& exception, OutputFormat format);
+
+        /**
+         * @brief Appends the lines of the given stacktrace, one line per frame or as json array.
+         *
+         * @param buffer The buffer to append to.
+         * @param stacktrace The stacktrace to format.
+         * @param format The output format to use.
+         */
+        static void write(std::string& buffer, const Stacktrace& stacktrace, OutputFormat format = String);
+
+        /**
+         * @brief Appends the headline that separates the log entries of different threads.
+         *
+         * @param buffer The buffer to append to.
+         * @param threadId The id of the thread.
+         */
+        static void writeThreadHeadline(std::string& buffer, const std::thread::id& threadId);
+
+        /**
+         * @brief Appends the headline that separates the log entries of different threads.
+         *
+         * @param buffer The buffer to append to.
+         * @param threadHash The hash of the id of the thread.
+         */
+        static void writeThreadHeadline(std::string& buffer, size_t threadHash);
+
+        /**
+         * @brief Appends the given characters as quoted json string and escapes them where necessary.
+         *
+         * @param buffer The buffer to append to.
+         * @param data The characters to append.
+         * @param length The number of characters.
+         */
+        static void appendJsonString(std::string& buffer, const char* data, size_t length);
+
+        /**
+         * @brief Appends the given string as quoted json string and escapes it where necessary.
+         *
+         * @param buffer The buffer to append to.
+         * @param string The string to append.
+         */
+        static void appendJsonString(std::string& buffer, const std::string& string);
+
+        /**
+         * @brief Appends the given null-terminated string as quoted json string and escapes it where necessary.
+         *
+         * @param buffer The buffer to append to.
+         * @param string The string to append.
+         */
+        static void appendJsonString(std::string& buffer, const char* string);
+
+        /**
+         * @brief Appends the decimal representation of the given number.
+         *
+         * @param buffer The buffer to append to.
+         * @param number The number to append.
+         */
+        static void appendNumber(std::string& buffer, uint64_t number);
+
+        /**
+         * @brief Appends the given time point in local time using the given strftime() pattern.
+         *
+         * @param buffer The buffer to append to.
+         * @param timepoint The time point to format.
+         * @param pattern The strftime() pattern.
+         */
+        static void appendDatetime(
+                std::string& buffer,
+                const std::chrono::system_clock::time_point& timepoint,
+                const char* pattern);
+
+        /**
+         * @brief Appends the given time point as ISO-8601 timestamp with microseconds, like 2021-03-04T05:06:07.123456Z.
+         *
+         * Every thread caches the date and time of the latest second it formatted, so only the fraction is formatted
+         * for further time points of the same second. Local timestamps end with their offset to UTC.
+         * @param buffer The buffer to append to.
+         * @param timepoint The time point to format.
+         */
+        static void appendTimestamp(std::string& buffer, const std::chrono::system_clock::time_point& timepoint);
+
+        /**
+         * @brief Sets the time zone of all timestamps.
+         *
+         * @param timezone The time zone, local time by default.
+         */
+        static void setTimezone(Timezone timezone) noexcept;
+
+        /**
+         * @brief Returns the time zone of all timestamps.
+         *
+         * @return The time zone.
+         */
+        static Timezone getTimezone() noexcept;
+
+    private:
+        /**
+         * @brief Appends the given log entry in the given format.
+         *
+         * @param buffer The buffer to append to.
+         * @param logEntry The log entry to format.
+         * @param format The output format to use.
+         * @param threadHash The hash of the thread that created the log entry or nullptr if unknown.
+         */
+        static void writeLogEntry(
+                std::string& buffer,
+                const LogEntry& logEntry,
+                OutputFormat format,
+                const size_t* threadHash);
+
+        /**
+         * @brief The time zone of all timestamps.
+         */
+        static std::atomic<Timezone> CurrentTimezone;
+    };
+
+}
+
+#endif
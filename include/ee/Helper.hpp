@@ -19,6 +19,15 @@ namespace ee {
          * @return A vector containing the names of logfiles found.
          */
         static std::vector<std::string> findLogFiles(const std::string& folder = ".", const std::string& fileprefix = "ee-log-") noexcept;
+
+        /**
+         * @brief Returns the number of bytes the given string allocated on the heap.
+         *
+         * Short strings are stored inside the string object and allocate nothing.
+         * @param string The string to measure.
+         * @return The number of heap bytes.
+         */
+        static size_t getNumberOfBytes(const std::string& string) noexcept;
     };
 
 }
@@ -0,0 +1,150 @@
+#ifndef EASY_EXCEPTION_INCIDENTCOORDINATOR_H
+#define EASY_EXCEPTION_INCIDENTCOORDINATOR_H
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+
+#include "LogEntry.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Coalesces cascading warnings and errors into a single incident file.
+     *
+     * The first warning opens an incident, every further warning extends it. The incident is written once no
+     * warning occurred for the quiet period, but not later than the maximum delay after the first warning. The tail
+     * keeps the incident open for a while after the first warning, so the log entries that follow the trigger end up
+     * in the same file. Until the coordinator is started every warning writes its incident immediately.
+     */
+    class IncidentCoordinator {
+    public:
+        /**
+         * @brief Starts the thread that writes the coalesced incidents.
+         *
+         * An already running coordinator is restarted with the new timing, a pending incident is written first.
+         * @param quietPeriod The time without a further warning after which the incident is written.
+         * @param maxDelay The longest time between the first warning and writing the incident.
+         * @param tail The shortest time between the first warning and writing the incident.
+         */
+        static void start(
+                const std::chrono::milliseconds& quietPeriod,
+                const std::chrono::milliseconds& maxDelay,
+                const std::chrono::milliseconds& tail = std::chrono::milliseconds::zero()) noexcept;
+
+        /**
+         * @brief Stops the thread, a pending incident is written before.
+         */
+        static void stop() noexcept;
+
+        /**
+         * @brief Returns whether warnings are coalesced.
+         *
+         * @return True if the thread is running.
+         */
+        static bool isRunning() noexcept;
+
+        /**
+         * @brief Opens or extends an incident for the given log entry.
+         *
+         * Fatal log entries and all log entries while the coordinator is stopped write the incident immediately,
+         * the process may not survive long enough to wait. Fatal log entries also wait for the IncidentWriter.
+         * @param logEntry The log entry that triggered the incident.
+         */
+        static void trigger(const LogEntry& logEntry) noexcept;
+
+        /**
+         * @brief Writes a pending incident immediately.
+         */
+        static void flush() noexcept;
+
+        /**
+         * @brief Returns whether an incident is waiting to be written.
+         *
+         * @return True if an incident is pending.
+         */
+        static bool isPending() noexcept;
+
+        /**
+         * @brief Returns the number of incidents written since the program started.
+         *
+         * @return The number of incidents.
+         */
+        static size_t getNumberOfIncidents() noexcept;
+
+    private:
+        /**
+         * @brief Writes the incident and counts it.
+         *
+         * @param wait True to return only after the incident writer has written the incident.
+         */
+        static void write(bool wait) noexcept;
+
+        /**
+         * @brief Returns the time the pending incident is due, the caller has to hold the mutex.
+         *
+         * @return The deadline.
+         */
+        static std::chrono::steady_clock::time_point getDeadline() noexcept;
+
+        /**
+         * @brief Guards the state of the coordinator.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Wakes up the thread when an incident is opened or the thread should stop.
+         */
+        static std::condition_variable Condition;
+
+        /**
+         * @brief The thread that writes the coalesced incidents.
+         */
+        static std::thread Thread;
+
+        /**
+         * @brief True while the thread should keep running.
+         */
+        static bool Running;
+
+        /**
+         * @brief True while an incident is open.
+         */
+        static bool Pending;
+
+        /**
+         * @brief The time of the first warning of the pending incident.
+         */
+        static std::chrono::steady_clock::time_point FirstTrigger;
+
+        /**
+         * @brief The time of the latest warning of the pending incident.
+         */
+        static std::chrono::steady_clock::time_point LastTrigger;
+
+        /**
+         * @brief The time without a further warning after which the incident is written.
+         */
+        static std::chrono::milliseconds QuietPeriod;
+
+        /**
+         * @brief The longest time between the first warning and writing the incident.
+         */
+        static std::chrono::milliseconds MaxDelay;
+
+        /**
+         * @brief The shortest time between the first warning and writing the incident.
+         */
+        static std::chrono::milliseconds Tail;
+
+        /**
+         * @brief The number of incidents written since the program started.
+         */
+        static std::atomic_size_t NumberOfIncidents;
+    };
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef EASY_EXCEPTION_INCIDENTWRITER_H
+#define EASY_EXCEPTION_INCIDENTWRITER_H
+
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <condition_variable>
+
+#include "LogSnapshot.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Writes the snapshots of incidents to their files on a dedicated thread.
+     *
+     * The thread that triggered an incident only moves the log entries into a snapshot and hands it over, so a
+     * warning returns without doing any file I/O. The snapshots are written in the order they were submitted. Until
+     * the writer is started every snapshot is written on the thread that submits it.
+     */
+    class IncidentWriter {
+    public:
+        /**
+         * @brief Starts the thread that writes the snapshots, an already running writer keeps running.
+         */
+        static void start() noexcept;
+
+        /**
+         * @brief Stops the thread, all submitted snapshots are written before.
+         */
+        static void stop() noexcept;
+
+        /**
+         * @brief Returns whether snapshots are written on the dedicated thread.
+         *
+         * @return True if the thread is running.
+         */
+        static bool isRunning() noexcept;
+
+        /**
+         * @brief Hands a snapshot over to the writer.
+         *
+         * The snapshot is written immediately if the writer is stopped or the snapshot could not be queued.
+         * @param filename The name of the file the snapshot is appended to.
+         * @param snapshot The snapshot to write.
+         */
+        static void submit(const std::string& filename, std::shared_ptr<const LogSnapshot> snapshot) noexcept;
+
+        /**
+         * @brief Waits until all submitted snapshots are written.
+         */
+        static void flush() noexcept;
+
+        /**
+         * @brief Returns the number of snapshots that are submitted but not completely written.
+         *
+         * @return The number of snapshots.
+         */
+        static size_t getNumberOfPendingSnapshots() noexcept;
+
+    private:
+        /**
+         * @brief Writes a snapshot, only one snapshot is written at a time.
+         *
+         * @param filename The name of the file the snapshot is appended to.
+         * @param snapshot The snapshot to write.
+         */
+        static void write(const std::string& filename, const LogSnapshot& snapshot) noexcept;
+
+        /**
+         * @brief Guards the state of the writer.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Wakes up the thread when a snapshot is submitted or the thread should stop.
+         */
+        static std::condition_variable Condition;
+
+        /**
+         * @brief Wakes up the callers of flush() when a snapshot has been written.
+         */
+        static std::condition_variable Written;
+
+        /**
+         * @brief The thread that writes the snapshots.
+         */
+        static std::thread Thread;
+
+        /**
+         * @brief True while the thread should keep running.
+         */
+        static bool Running;
+
+        /**
+         * @brief The submitted snapshots and the names of their files, the oldest first.
+         */
+        static std::deque<std::pair<std::string, std::shared_ptr<const LogSnapshot>>> Queue;
+
+        /**
+         * @brief The number of snapshots that are submitted but not completely written.
+         */
+        static size_t NumberOfPendingSnapshots;
+    };
+
+}
+
+#endif
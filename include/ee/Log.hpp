@@ -2,15 +2,18 @@
 #define EASY_EXCEPTION_LOG_H
 
 #include <map>
-#include <list>
 #include <thread>
 #include <mutex>
 #include <functional>
 #include <atomic>
+#include <condition_variable>
 
 #include "Exception.hpp"
+#include "EmergencyReserve.hpp"
 #include "SuspendLogging.hpp"
 #include "LogEntry.hpp"
+#include "LogBuffer.hpp"
+#include "LogSnapshot.hpp"
 #include "LogRetentionPolicy.hpp"
 
 namespace ee {
@@ -23,8 +26,18 @@ namespace ee {
     public:
         /**
          * @brief This method applies the default configuration of this framework.
+         *
+         * The IncidentWriter is started, so warnings and errors write their incidents on its thread. It drains its
+         * queue at exit, Log::flush() waits for it earlier.
+         * @param logFolder The folder where log files are written to.
+         * @param emergencyReserve The number of bytes preallocated for creating diagnostics when out of memory.
+         * @param flightRecorderSize The number of bytes of the flight recorder of every thread, zero disables it. The
+         * flight recorder of a previous run that has been killed is converted into a log file first.
          */
-        static void applyDefaultConfiguration(const std::string& logFolder = "") noexcept;
+        static void applyDefaultConfiguration(
+                const std::string& logFolder = "",
+                size_t emergencyReserve = EASY_EXCEPTION_EMERGENCY_RESERVE,
+                size_t flightRecorderSize = 0) noexcept;
 
         /**
          * @brief The basic log method, that stores a log entry for the caller thread in the log-thread map.
@@ -82,13 +95,13 @@ namespace ee {
          *
          * @return Reference to the log-thread map.
          */
-        static const std::map<std::thread::id, std::list<LogEntry>>& getLogThreadMap() noexcept;
+        static const std::map<std::thread::id, LogBuffer>& getLogThreadMap() noexcept;
 
         /**
          * @brief Resets the log-thread map and removes all previously stored log entries.
          *
-         * The log lists for each thread will remain because we can not remove them. Every thread stores a pointer to
-         * its log list and we cant remove that pointer afterwards.
+         * The log buffers for each thread will remain because we can not remove them. Every thread stores a pointer to
+         * its log buffer and we cant remove that pointer afterwards.
          */
         static void reset() noexcept;
 
@@ -123,12 +136,51 @@ namespace ee {
         /**
          * @brief Writes all logs into a file with the given name.
          *
-         * The file will be created if it not exists and override all previously created content.
+         * The file will be created if it not exists, new content is appended. The log entries of all threads are
+         * merged into a single chronological stream and every log entry names its thread. The json format writes one
+         * entry per line (JSON Lines). An incremental write only appends the log entries that no incremental write
+         * has written before, every thread remembers the sequence number up to which its log entries are persisted.
          * @param filename The name of the file.
          * @param format The output format to use when writing into the file.
+         * @param incremental True to write only the log entries created since the last incremental write.
          * @return True if writing was successfully.
          */
-        static bool writeToFile(const std::string& filename, OutputFormat format = EASY_EXCEPTION_OUTPUT_FORMAT) noexcept;
+        static bool writeToFile(
+                const std::string& filename,
+                OutputFormat format = EASY_EXCEPTION_OUTPUT_FORMAT,
+                bool incremental = false) noexcept;
+
+        /**
+         * @brief Writes all logs into the incident file of the log folder and clears them.
+         *
+         * The logs are released by the retention policies first and moved into a snapshot that is handed to the
+         * IncidentWriter. If the spill tier is open, the logs spilled since the previous incident are merged with the
+         * logs in memory.
+         * @param wait True to return only after the incident has been written.
+         */
+        static void writeIncident(bool wait = false) noexcept;
+
+        /**
+         * @brief Writes a pending incident and waits until all incidents reached their files.
+         *
+         * @param durable True to wait until the files are synced to the disk as well, see LogDurability.
+         * @return False if a file could not be synced.
+         */
+        static bool flush(bool durable = true) noexcept;
+
+        /**
+         * @brief Moves all logs into a new snapshot and leaves the log empty.
+         *
+         * Only the chains of segments change hands, so the duration does not depend on the number of log entries. A
+         * thread that is still recording or formatting its youngest log entry holds the mutex of its buffer, so the
+         * snapshot waits for it.
+         * @param spillSince The oldest date of creation of the spilled log entries the snapshot writes.
+         * @param spillUntil The spilled log entries created at or after this date are not written by the snapshot.
+         * @return The snapshot or nullptr if there was not enough memory to create it.
+         */
+        static std::shared_ptr<LogSnapshot> takeSnapshot(
+                const std::chrono::system_clock::time_point& spillSince = std::chrono::system_clock::time_point::max(),
+                const std::chrono::system_clock::time_point& spillUntil = std::chrono::system_clock::time_point::max()) noexcept;
 
         /**
          * @brief Registers the given outstream with a specific log level.
@@ -136,8 +188,12 @@ namespace ee {
          * All future logs in this loglevel will be printed into that outstream.
          * @param logLevel The log level where the printing should be executed.
          * @param outstream The out stream where the output should go into.
+         * @param format The output format, json writes one entry per line, plain text unless given.
          */
-        static void registerOutstream(LogLevel logLevel, std::ostream& outstream) noexcept;
+        static void registerOutstream(
+                LogLevel logLevel,
+                std::ostream& outstream,
+                OutputFormat format = OutputFormat::String) noexcept;
 
         /**
          * @brief Removes all registered out streams.
@@ -154,6 +210,8 @@ namespace ee {
         /**
          * @brief Registers a log retention policy.
          *
+         * A previously registered policy of the same kind for the same log levels is replaced, so different log
+         * levels can be retained for different times.
          * @param policy The policy to register.
          */
         static void registerLogRententionPolicy(std::shared_ptr<LogRetentionPolicy> policy) noexcept;
@@ -168,12 +226,64 @@ namespace ee {
          *
          * @return Reference to the map of log retention policies.
          */
-        static const std::map<uint8_t,std::shared_ptr<LogRetentionPolicy>>& getLogRetentionPolicies() noexcept;
+        static const std::multimap<uint8_t,std::shared_ptr<LogRetentionPolicy>>& getLogRetentionPolicies() noexcept;
 
         /**
          * @brief Releases all logs that are not retained by the retention policies.
+         *
+         * Logging is not suspended, the threads are processed one after another and only the thread whose log
+         * buffer is currently processed has to wait.
+         * @return The number of released log entries.
          */
-        static void releaseLogs() noexcept;
+        static size_t releaseLogs() noexcept;
+
+        /**
+         * @brief Returns the number of bytes all log entries of all threads hold in memory.
+         *
+         * A stacktrace shared by multiple log entries of the same thread is counted only once.
+         * @return The number of bytes.
+         */
+        static size_t getNumberOfBytes() noexcept;
+
+        /**
+         * @brief Returns the total number of log entries released by the log retention policies.
+         *
+         * @return The number of released log entries.
+         */
+        static size_t getNumberOfReleasedLogEntries() noexcept;
+
+        /**
+         * @brief Compresses all segments whose log entries are older than the given age.
+         *
+         * The log entries are thawed again when they are read, e.g. by writeToFile().
+         * @param age The age of the youngest log entry of a segment to compress.
+         * @return The number of compressed segments.
+         */
+        static size_t compressLogs(const std::chrono::milliseconds& age) noexcept;
+
+        /**
+         * @brief Starts a housekeeping thread that periodically releases logs.
+         *
+         * An already running housekeeping thread is restarted with the new period.
+         * @param period The time between two retention cycles.
+         * @param compressionAge If not zero, the housekeeping thread compresses the logs older than this age after
+         * releasing logs.
+         */
+        static void startRetentionThread(
+                const std::chrono::milliseconds& period,
+                const std::chrono::milliseconds& compressionAge = std::chrono::milliseconds::zero()) noexcept;
+
+        /**
+         * @brief Stops the housekeeping thread and waits until it has finished.
+         */
+        static void stopRetentionThread() noexcept;
+
+        /**
+         * @brief Returns whether the housekeeping thread is running.
+         *
+         * @return True if the housekeeping thread is running.
+         */
+        static bool isRetentionThreadRunning() noexcept;
 
         /**
          * @brief Counts all log levels and returns a map containing the different amounts.
@@ -190,9 +300,9 @@ namespace ee {
         static std::recursive_mutex Mutex;
 
         /**
-         * @brief The log-thread map that contains a list of LogEntries for each thread.
+         * @brief The log-thread map that contains a segmented buffer of LogEntries for each thread.
          */
-        static std::map<std::thread::id, std::list<LogEntry>> LogThreadMap;
+        static std::map<std::thread::id, LogBuffer> LogThreadMap;
 
         /**
          * @brief This map can hold a single callback for each LogLevel.
@@ -211,10 +321,45 @@ namespace ee {
          */
         static std::map<LogLevel, std::ostream*> OutStreamMap;
 
+        /**
+         * @brief This map contains the output format for every registered output stream.
+         */
+        static std::map<LogLevel, OutputFormat> OutStreamFormatMap;
+
         /**
          * @brief This map holds the log retention policies.
          */
-        static std::map<uint8_t,std::shared_ptr<LogRetentionPolicy>> LogRetentionPolicies;
+        static std::multimap<uint8_t,std::shared_ptr<LogRetentionPolicy>> LogRetentionPolicies;
+
+        /**
+         * @brief Guards the log retention policies, they have a state while the logs are released.
+         */
+        static std::recursive_mutex RetentionMutex;
+
+        /**
+         * @brief The total number of released log entries.
+         */
+        static std::atomic_size_t NumberOfReleasedLogEntries;
+
+        /**
+         * @brief The housekeeping thread that periodically releases logs.
+         */
+        static std::thread RetentionThread;
+
+        /**
+         * @brief Guards the state of the housekeeping thread.
+         */
+        static std::mutex RetentionThreadMutex;
+
+        /**
+         * @brief Wakes up the housekeeping thread when it should stop.
+         */
+        static std::condition_variable RetentionThreadCondition;
+
+        /**
+         * @brief True while the housekeeping thread should keep running.
+         */
+        static bool RetentionThreadRunning;
     };
 
 }
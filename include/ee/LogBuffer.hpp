@@ -0,0 +1,343 @@
+#ifndef EASY_EXCEPTION_LOGBUFFER_H
+#define EASY_EXCEPTION_LOGBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+#include "LogSegment.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Stores the log entries of a single thread partitioned into time-ordered segments.
+     *
+     * Every log level has its own chain of segments, so a log level can expire without touching the others. New log
+     * entries are appended to the youngest segment of their chain. The log retention can release whole segments at
+     * once and only has to look into single log entries of the segments at the boundary. Cold segments can be
+     * compressed, iterating through the buffer thaws them again.
+     */
+    class LogBuffer {
+    public:
+        /**
+         * @brief The number of log levels, every log level has its own chain of segments.
+         */
+        static constexpr size_t NumberOfLogLevels = LogLevel::Fatal + 1;
+
+        /**
+         * @brief The chains of segments, one for every log level.
+         */
+        typedef std::array<std::deque<LogSegment>, NumberOfLogLevels> Chains;
+
+        /**
+         * @brief Iterates through all log entries of a buffer in the order they were created.
+         *
+         * The chains of the different log levels are merged by the sequence numbers of their log entries.
+         */
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = LogEntry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const LogEntry*;
+            using reference = const LogEntry&;
+
+            /**
+             * @brief Constructor.
+             *
+             * @param chains The chains to iterate through.
+             * @param end True to create the iterator pointing behind the last log entry.
+             */
+            const_iterator(const Chains* chains, bool end) noexcept;
+
+            /**
+             * @brief Constructor, points to the oldest log entry whose sequence number is not smaller than the given one.
+             *
+             * @param chains The chains to iterate through.
+             * @param from The smallest sequence number to visit.
+             */
+            const_iterator(const Chains* chains, uint64_t from) noexcept;
+
+            reference operator*() const noexcept;
+            pointer operator->() const noexcept;
+            const_iterator& operator++() noexcept;
+            const_iterator operator++(int) noexcept;
+            bool operator==(const const_iterator& other) const noexcept;
+            bool operator!=(const const_iterator& other) const noexcept;
+
+        private:
+            /**
+             * @brief Skips all empty segments of the given chain.
+             *
+             * @param level The index of the chain.
+             */
+            void skipEmptySegments(size_t level) noexcept;
+
+            /**
+             * @brief Selects the chain whose current log entry has the smallest sequence number.
+             */
+            void select() noexcept;
+
+            /**
+             * @brief The position of a chain, the index of the segment and the index of the log entry.
+             */
+            struct Position {
+                size_t segment;
+                size_t entry;
+            };
+
+            const Chains* mChains;
+            std::array<Position, NumberOfLogLevels> mPositions;
+            size_t mLevel;
+        };
+
+        /**
+         * @brief Constructor.
+         */
+        LogBuffer() noexcept = default;
+
+        /**
+         * @brief Copy constructor, copies the log entries but not the mutex.
+         *
+         * @param other The buffer to copy.
+         */
+        LogBuffer(const LogBuffer& other);
+
+        /**
+         * @brief Appends a new log entry to the youngest segment of its log level and creates a new segment if
+         * necessary.
+         *
+         * Locks the mutex of this buffer.
+         * @return Reference to the new log entry. Other threads may release or move it as soon as the mutex is
+         * unlocked, so a caller that keeps using it has to hold the mutex.
+         */
+        LogEntry& emplace_back(
+                LogLevel logLevel,
+                const std::string& classname,
+                const std::string& method,
+                const std::string& message,
+                const std::vector<Note>& notes,
+                const std::optional<std::shared_ptr<Stacktrace>>& stacktrace,
+                const std::chrono::system_clock::time_point& dateOfCreation);
+
+        /**
+         * @brief Releases all log entries.
+         *
+         * Locks the mutex of this buffer.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Moves all log entries into the given buffer and leaves this buffer empty.
+         *
+         * Only the chains change hands, so the duration does not depend on the number of log entries. Locks the
+         * mutexes of both buffers, so it waits for an owning thread that still uses its youngest log entry.
+         * @param target The buffer that receives the log entries, it has to be empty.
+         */
+        void moveTo(LogBuffer& target) noexcept;
+
+        /**
+         * @brief Returns the number of log entries.
+         *
+         * @return Number of log entries.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * @brief Returns the number of log entries of the given log level.
+         *
+         * @param logLevel The log level.
+         * @return Number of log entries.
+         */
+        size_t size(LogLevel logLevel) const noexcept;
+
+        /**
+         * @brief Returns whether this buffer contains no log entries.
+         *
+         * @return True if there are no log entries.
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Returns an iterator to the oldest log entry, compressed segments are thawed first.
+         *
+         * Locks the mutex of this buffer while thawing.
+         * @return The iterator.
+         */
+        const_iterator begin() const noexcept;
+
+        /**
+         * @brief Returns an iterator to the oldest log entry whose sequence number is not smaller than the given one.
+         *
+         * Segments that only hold older log entries are skipped without thawing them. Locks the mutex of this buffer
+         * while thawing.
+         * @param from The smallest sequence number to visit.
+         * @return The iterator.
+         */
+        const_iterator begin(uint64_t from) const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        /**
+         * @brief Returns the segments of the given log level, the oldest first.
+         *
+         * @param logLevel The log level.
+         * @return The segments of the log level.
+         */
+        const std::deque<LogSegment>& getSegments(LogLevel logLevel) const noexcept;
+
+        /**
+         * @brief Returns the number of log entries whose sequence number is not smaller than the given one.
+         *
+         * Whole segments are counted, so the result may include a few older log entries.
+         * @param from The smallest sequence number to count.
+         * @return The number of log entries.
+         */
+        size_t size(uint64_t from) const noexcept;
+
+        /**
+         * @brief Returns the sequence number of the youngest log entry.
+         *
+         * @return The sequence number or 0 if the buffer is empty.
+         */
+        uint64_t getMaxSequenceNumber() const noexcept;
+
+        /**
+         * @brief Returns the watermark, all log entries with a smaller sequence number have been written incrementally.
+         *
+         * @return The sequence number of the oldest log entry that has not been written yet.
+         */
+        uint64_t getWatermark() const noexcept;
+
+        /**
+         * @brief Sets the watermark after the log entries have been written incrementally.
+         *
+         * @param watermark The sequence number of the oldest log entry that has not been written yet.
+         */
+        void setWatermark(uint64_t watermark) noexcept;
+
+        /**
+         * @brief Returns the number of bytes this buffer holds in memory.
+         *
+         * Includes the reserved capacity of the segments and counts every stacktrace only once, even if multiple
+         * log entries of this buffer share it.
+         * @return The number of bytes.
+         */
+        size_t getNumberOfBytes() const noexcept;
+
+        /**
+         * @brief Returns the mutex that guards the segments against concurrent appending and releasing.
+         *
+         * The caller has to hold it while calling release(). The mutex is recursive, so a caller that holds it can
+         * still append to the buffer and iterate through it.
+         * @return The mutex of this buffer.
+         */
+        std::recursive_mutex& getMutex() const noexcept;
+
+        /**
+         * @brief Releases the log entries of the segment with the given index that are marked in the given mask.
+         *
+         * Segments that become empty are removed.
+         * @param logLevel The log level of the segment.
+         * @param segment The index of the segment.
+         * @param release One flag per log entry, true releases the log entry.
+         * @return The number of released log entries.
+         */
+        size_t release(LogLevel logLevel, size_t segment, const std::vector<bool>& release) noexcept;
+
+        /**
+         * @brief Releases the whole segment with the given index.
+         *
+         * @param logLevel The log level of the segment.
+         * @param segment The index of the segment.
+         * @return The number of released log entries.
+         */
+        size_t release(LogLevel logLevel, size_t segment) noexcept;
+
+        /**
+         * @brief Compresses the segment with the given index.
+         *
+         * The caller has to hold the mutex. The youngest segment of a chain is only compressed if it is full.
+         * @param logLevel The log level of the segment.
+         * @param segment The index of the segment.
+         * @return True if the segment has been compressed.
+         */
+        bool compress(LogLevel logLevel, size_t segment) noexcept;
+
+        /**
+         * @brief Restores the log entries of the segment with the given index if it is compressed.
+         *
+         * The caller has to hold the mutex.
+         * @param logLevel The log level of the segment.
+         * @param segment The index of the segment.
+         * @return False if the log entries could not be restored.
+         */
+        bool thaw(LogLevel logLevel, size_t segment) const noexcept;
+
+    private:
+        /**
+         * @brief Adds the bytes of the given log entry that has been added to a segment.
+         *
+         * @param logEntry The log entry.
+         */
+        void account(const LogEntry& logEntry) const;
+
+        /**
+         * @brief Removes the bytes of the given log entry that is about to be released.
+         *
+         * @param logEntry The log entry.
+         */
+        void unaccount(const LogEntry& logEntry) const noexcept;
+
+        /**
+         * @brief The sequence number of the next log entry of any thread, it orders log entries with the same date.
+         */
+        static std::atomic<uint64_t> NextSequenceNumber;
+
+        /**
+         * @brief Guards the segments.
+         */
+        mutable std::recursive_mutex mMutex;
+
+        /**
+         * @brief The segments of every log level, the oldest first.
+         *
+         * Thawing a segment does not change the log entries a reader sees, so it is allowed for const buffers while
+         * holding the mutex.
+         */
+        mutable Chains mChains;
+
+        /**
+         * @brief The number of log entries of every log level.
+         */
+        std::array<size_t, NumberOfLogLevels> mSizes{};
+
+        /**
+         * @brief The total number of log entries in all segments.
+         */
+        size_t mSize = 0;
+
+        /**
+         * @brief The sequence number of the oldest log entry that has not been written incrementally yet.
+         */
+        uint64_t mWatermark = 0;
+
+
+        /**
+         * @brief The number of bytes of all segments, log entries and stacktraces.
+         */
+        mutable size_t mNumberOfBytes = 0;
+
+        /**
+         * @brief Counts the log entries that share a stacktrace, so every stacktrace is counted only once.
+         */
+        mutable std::unordered_map<const Stacktrace*, size_t> mStacktraces;
+    };
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef EASY_EXCEPTION_LOGCODEC_H
+#define EASY_EXCEPTION_LOGCODEC_H
+
+#include <string>
+#include <optional>
+
+#include "LogEntry.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Converts log entries into a compact binary form and back.
+     *
+     * A record starts with its version and log level, followed by the hash of the thread, the date of creation in
+     * nanoseconds, the sequence number and the length-prefixed strings of the log entry. All numbers are stored in
+     * host byte order, the records are meant to be read back on the same machine.
+     */
+    class LogCodec {
+    public:
+        /**
+         * @brief The version of the record layout.
+         */
+        static constexpr uint8_t Version = 1;
+
+        /**
+         * @brief Appends the binary form of the given log entry to the given buffer.
+         *
+         * @param buffer The buffer to append to.
+         * @param logEntry The log entry to encode.
+         * @param threadHash The hash of the id of the thread that created the log entry.
+         */
+        static void encode(std::string& buffer, const LogEntry& logEntry, size_t threadHash);
+
+        /**
+         * @brief Decodes a single record that was created by encode().
+         *
+         * @param data The first byte of the record.
+         * @param size The number of bytes of the record.
+         * @param threadHash Receives the hash of the id of the thread that created the log entry.
+         * @param previous The previously decoded log entry, its stacktrace is shared if it has the same lines.
+         * @return The log entry or an empty optional if the record is damaged or of an unknown version.
+         */
+        static std::optional<LogEntry> decode(
+                const char* data,
+                size_t size,
+                size_t& threadHash,
+                const LogEntry* previous = nullptr) noexcept;
+    };
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef EASY_EXCEPTION_LOGDURABILITY_H
+#define EASY_EXCEPTION_LOGDURABILITY_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+
+namespace ee {
+
+    /**
+     * @brief Decides when the written log files are forced to the disk with fdatasync.
+     *
+     * Every FileSink marks the files it wrote as dirty. A sync makes all dirty files durable at once, together with the
+     * folders of the files that have been created, so the new names survive a crash as well. Callers that
+     * request a sync while another one is running share the next one, so many concurrent requests cost a single
+     * fdatasync per file. Without a mode nothing is synced unless requested, the periodic mode syncs the dirty files
+     * in the background and syncs immediately for fatal log entries, the group commit mode syncs after every incident.
+     */
+    class LogDurability {
+    public:
+        /**
+         * @brief When the log files are synced.
+         */
+        enum class Mode : uint8_t {
+            None, Periodic, GroupCommit
+        };
+
+        /**
+         * @brief Sets the mode, the background thread of the periodic mode is started or stopped as needed.
+         *
+         * @param mode The mode.
+         * @param interval The time between two syncs of the periodic mode.
+         */
+        static void setMode(Mode mode, const std::chrono::milliseconds& interval = std::chrono::seconds(1)) noexcept;
+
+        /**
+         * @brief Returns the mode.
+         *
+         * @return The mode.
+         */
+        static Mode getMode() noexcept;
+
+        /**
+         * @brief Remembers that the given file has been written since the last sync.
+         *
+         * A file that could not be remembered makes the next sync fail.
+         * @param filename The name of the file.
+         * @param created True if the file has been created since the last sync, its folder is synced as well then.
+         */
+        static void markDirty(const std::string& filename, bool created = false) noexcept;
+
+        /**
+         * @brief Forgets the given dirty file, it has been removed on purpose and has nothing left to sync.
+         *
+         * A dirty file that is missing while it is synced is reported as a failure.
+         * @param filename The name of the file.
+         */
+        static void markRemoved(const std::string& filename) noexcept;
+
+        /**
+         * @brief Syncs if the mode demands it after an incident has been written.
+         *
+         * @param urgent True if the incident contains a fatal log entry, the periodic mode syncs immediately then.
+         * @return False if a file could not be synced.
+         */
+        static bool commit(bool urgent = false) noexcept;
+
+        /**
+         * @brief Makes all files written before this call durable, concurrent callers share a single sync.
+         *
+         * The blocks in flight on the AsyncWriter are written before.
+         * @return False if a file could not be synced.
+         */
+        static bool sync() noexcept;
+
+        /**
+         * @brief Returns the number of files written since the last sync.
+         *
+         * @return The number of dirty files.
+         */
+        static size_t getNumberOfDirtyFiles() noexcept;
+
+        /**
+         * @brief Returns the number of syncs executed since the program started, a shared sync counts once.
+         *
+         * @return The number of syncs.
+         */
+        static size_t getNumberOfSyncs() noexcept;
+
+    private:
+        /**
+         * @brief Guards the state of the syncs.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Notifies the waiting callers once a sync completed and wakes up the periodic thread.
+         */
+        static std::condition_variable Condition;
+
+        /**
+         * @brief The thread of the periodic mode.
+         */
+        static std::thread Thread;
+
+        /**
+         * @brief The mode.
+         */
+        static Mode CurrentMode;
+
+        /**
+         * @brief The time between two syncs of the periodic mode.
+         */
+        static std::chrono::milliseconds Interval;
+
+        /**
+         * @brief The files written since the last sync, mapped to whether they have been created since then.
+         */
+        static std::map<std::string, bool> DirtyFiles;
+
+        /**
+         * @brief True if a written file could not be remembered, the next sync reports a failure then.
+         */
+        static bool LostDirtyFile;
+
+        /**
+         * @brief The number of the latest request, every call of sync() is a request.
+         */
+        static uint64_t RequestedSync;
+
+        /**
+         * @brief The number of the latest request that is durable.
+         */
+        static uint64_t CompletedSync;
+
+        /**
+         * @brief True while a caller syncs on behalf of all others.
+         */
+        static bool Syncing;
+
+        /**
+         * @brief The result of the latest sync.
+         */
+        static bool SyncResult;
+
+        /**
+         * @brief The number of syncs executed since the program started.
+         */
+        static std::atomic_size_t NumberOfSyncs;
+    };
+
+}
+
+#endif
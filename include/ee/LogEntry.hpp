@@ -29,6 +29,7 @@ namespace ee {
          * @param notes A list of notes containing variables and other usful information.
          * @param stacktrace Can hold a stacktrace.
          * @param dateOfCreation The date of occurrence.
+         * @param sequenceNumber The position of this LogEntry among all log entries of its thread.
          */
         LogEntry(
                 LogLevel logLevel,
@@ -37,7 +38,8 @@ namespace ee {
                 const std::string& message,
                 const std::vector<Note>& notes,
                 const std::optional<std::shared_ptr<Stacktrace>>& stacktrace,
-                const std::chrono::system_clock::time_point& dateOfCreation) noexcept;
+                const std::chrono::system_clock::time_point& dateOfCreation,
+                uint64_t sequenceNumber = 0);
 
         /**
          * @brief Returns the LogLevel of this LogEntry.
@@ -88,6 +90,22 @@ namespace ee {
          */
         const std::chrono::system_clock::time_point& getDateOfCreation() const noexcept;
 
+        /**
+         * @brief Returns the number of bytes this log entry holds in memory.
+         *
+         * The stacktrace is not included because it can be shared between multiple log entries.
+         * @return The number of bytes.
+         */
+        size_t getNumberOfBytes() const noexcept;
+
+        /**
+         * @brief Returns the position of this LogEntry among all log entries of its thread.
+         *
+         * Log entries of different log levels are stored apart, the sequence number restores their order.
+         * @return The sequence number.
+         */
+        uint64_t getSequenceNumber() const noexcept;
+
         /**
          * @brief Writes the LogEntry to an outstream .
          *
@@ -130,6 +148,11 @@ namespace ee {
          * @brief Holds the date of occurrence.
          */
         std::chrono::system_clock::time_point mDateOfCreation;
+
+        /**
+         * @brief Holds the position among all log entries of the thread.
+         */
+        uint64_t mSequenceNumber;
     };
 
 }
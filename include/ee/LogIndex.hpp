@@ -0,0 +1,189 @@
+#ifndef EASY_EXCEPTION_LOGINDEX_H
+#define EASY_EXCEPTION_LOGINDEX_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <optional>
+
+#include "FileSink.hpp"
+#include "LogEntry.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Indexes the log files, so a reader can seek to the log entries of a time range without scanning the file.
+     *
+     * While enabled, every merge written into a file is cut into blocks of about EntriesPerBlock log entries. Every
+     * block records its byte range, the time range, the log levels and the thread hashes of its log entries. After
+     * BlocksPerIndex blocks and at the end of the merge, the blocks are written as a single JSON line between the log
+     * entries. The merge ends with a footer of FooterSize bytes that points to its last index line. Every index line
+     * points to the previous one of its merge, the first one to where the merge started, which is the end of the
+     * footer of the merge before. A reader starts at the end of the file and follows this chain back to the start.
+     */
+    class LogIndex {
+    public:
+        /**
+         * @brief The number of log entries after which a new block is started.
+         */
+        static constexpr size_t EntriesPerBlock = 1024;
+
+        /**
+         * @brief The number of blocks that are written as one index line.
+         */
+        static constexpr size_t BlocksPerIndex = 64;
+
+        /**
+         * @brief The number of bytes of the footer, including the line break.
+         */
+        static constexpr size_t FooterSize = 36;
+
+        /**
+         * @brief The largest index line a reader accepts.
+         */
+        static constexpr size_t MaxIndexSize = 16 * 1024 * 1024;
+
+        /**
+         * @brief A range of the file that holds formatted log entries.
+         */
+        struct Block {
+            uint64_t offset;
+            uint64_t size;
+            std::chrono::system_clock::time_point since;
+            std::chrono::system_clock::time_point until;
+            uint8_t logLevels;
+            std::vector<size_t> threadHashes;
+        };
+
+        /**
+         * @brief Enables or disables the index of the merges written from now on.
+         *
+         * @param enabled True to index the files.
+         */
+        static void setEnabled(bool enabled) noexcept;
+
+        /**
+         * @brief Returns whether the files are indexed.
+         *
+         * @return True if the merges are indexed, false by default.
+         */
+        static bool isEnabled() noexcept;
+
+        /**
+         * @brief Constructor, starts the index of a merge at the current position of the sink.
+         *
+         * @param sink The sink the merge is written into, the caller holds its mutex.
+         */
+        explicit LogIndex(FileSink& sink) noexcept;
+
+        /**
+         * @brief Adds the given log entry before it is formatted into the sink.
+         *
+         * A new block starts at the current position of the sink once the block is full.
+         * @param logEntry The log entry.
+         * @param threadHash The hash of the id of the thread that created the log entry.
+         */
+        void add(const LogEntry& logEntry, size_t threadHash) noexcept;
+
+        /**
+         * @brief Ends the current block, the next log entry starts a new one.
+         *
+         * The log entries added while the position of the sink does not move stay in the same block.
+         */
+        void split() noexcept;
+
+        /**
+         * @brief Writes the last index line and the footer into the sink after the last log entry.
+         *
+         * @return False if the merge had no log entries or there was not enough memory to index it.
+         */
+        bool finish() noexcept;
+
+        /**
+         * @brief Reads the blocks of all indexed merges at the end of the given file.
+         *
+         * The chain stops at the first merge that has not been indexed.
+         * @param filename The name of the file.
+         * @param blocks Receives the blocks ordered by their offsets.
+         * @return False if the file could not be read or does not end with a footer.
+         */
+        static bool readBlocks(const std::string& filename, std::vector<Block>& blocks) noexcept;
+
+        /**
+         * @brief Returns the blocks of the given file that may hold log entries of the given kind.
+         *
+         * @param filename The name of the file.
+         * @param since The earliest date of creation.
+         * @param until The latest date of creation.
+         * @param minimum The lowest log level.
+         * @param threadHash The hash of the id of the thread, or nullopt for all threads.
+         * @return The matching blocks ordered by their offsets.
+         */
+        static std::vector<Block> find(
+                const std::string& filename,
+                const std::chrono::system_clock::time_point& since,
+                const std::chrono::system_clock::time_point& until,
+                LogLevel minimum = LogLevel::Trace,
+                std::optional<size_t> threadHash = std::nullopt) noexcept;
+
+        /**
+         * @brief Reads the formatted log entries of the given block.
+         *
+         * @param filename The name of the file.
+         * @param block The block.
+         * @param content Receives the content of the block.
+         * @return False if the block could not be read.
+         */
+        static bool readContent(const std::string& filename, const Block& block, std::string& content) noexcept;
+
+    private:
+        /**
+         * @brief Writes all blocks as one index line into the sink and forgets them.
+         */
+        void writeIndex();
+
+        /**
+         * @brief Whether the merges are indexed.
+         */
+        static std::atomic_bool Enabled;
+
+        /**
+         * @brief The sink the merge is written into.
+         */
+        FileSink& mSink;
+
+        /**
+         * @brief The position of the sink where the merge started.
+         */
+        uint64_t mStart;
+
+        /**
+         * @brief The position of the previous index line of the merge or -1.
+         */
+        int64_t mPrevious = -1;
+
+        /**
+         * @brief The blocks that have not been written yet, the last one is still filled.
+         */
+        std::vector<Block> mBlocks;
+
+        /**
+         * @brief The number of log entries of the last block.
+         */
+        size_t mNumberOfLogEntries = 0;
+
+        /**
+         * @brief True if the next log entry starts a new block.
+         */
+        bool mSplit = true;
+
+        /**
+         * @brief True if there was not enough memory, the merge is not indexed then.
+         */
+        bool mFailed = false;
+    };
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef EASY_EXCEPTION_LOGMERGE_H
+#define EASY_EXCEPTION_LOGMERGE_H
+
+#include <map>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "Exception.hpp"
+#include "FileSink.hpp"
+#include "LogBuffer.hpp"
+#include "LogIndex.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Merges the log entries of many threads into a single stream ordered by their date of creation.
+     *
+     * Every thread contributes a cursor into its buffer, a binary heap always provides the cursor with the oldest
+     * current log entry. Log entries with the same date are ordered by their sequence numbers, which are unique
+     * across all threads. The cursors and the heap are allocated by the constructor, iterating allocates nothing.
+     * The buffers must not be modified while the merge is in use.
+     *
+     * Large merges are formatted by a few workers. The calling thread collects the next chunk of every worker in
+     * chronological order, the workers format their chunks into their own buffers and the buffers are written in
+     * order, so the output is the same as with a single thread.
+     */
+    class LogMerge {
+    public:
+        /**
+         * @brief The number of log entries a worker formats at once.
+         */
+        static constexpr size_t ChunkSize = 16 * 1024;
+
+        /**
+         * @brief The largest number of threads that format a merge.
+         */
+        static constexpr size_t MaxNumberOfWorkers = 8;
+
+        /**
+         * @brief Log entries of the spill tier as pairs of the hash of the thread id and the log entry.
+         */
+        typedef std::vector<std::pair<size_t, LogEntry>> SpilledLogEntries;
+
+        /**
+         * @brief Constructor, positions the merge in front of the oldest log entry.
+         *
+         * Compressed segments of the buffers are thawed here.
+         * @param threads The buffers of the threads.
+         * @param spilled Log entries ordered by their date of creation that are merged as well, or nullptr.
+         * @param incremental True to skip the log entries of every buffer below its watermark, which have been
+         * written before. Only the segments holding younger log entries are thawed then.
+         */
+        explicit LogMerge(
+                const std::map<std::thread::id, LogBuffer>& threads,
+                const SpilledLogEntries* spilled = nullptr,
+                bool incremental = false);
+
+        /**
+         * @brief Moves to the next log entry in chronological order.
+         *
+         * The log entry remains valid until the next call.
+         * @param threadHash Receives the hash of the id of the thread that created the log entry.
+         * @return The log entry or nullptr if all log entries have been visited.
+         */
+        const LogEntry* next(size_t& threadHash) noexcept;
+
+        /**
+         * @brief Formats all remaining log entries into the given sink, every log entry names its thread.
+         *
+         * The buffer of the sink is committed after every log entry but not flushed. While the LogIndex is enabled,
+         * the merge is indexed and ends with a footer.
+         * @param sink The sink to write into.
+         * @param format The output format to use.
+         */
+        void write(FileSink& sink, OutputFormat format);
+
+        /**
+         * @brief Sets the number of threads that format a merge, including the calling thread.
+         *
+         * A merge only uses as many workers as it has chunks, one worker formats everything on the calling thread.
+         * @param numberOfWorkers The number of workers, limited to MaxNumberOfWorkers.
+         */
+        static void setNumberOfWorkers(size_t numberOfWorkers) noexcept;
+
+        /**
+         * @brief Returns the number of threads that format a merge.
+         *
+         * @return The number of workers, by default the number of cores limited to MaxNumberOfWorkers.
+         */
+        static size_t getNumberOfWorkers() noexcept;
+
+    private:
+        /**
+         * @brief Formats the next chunks of the merge on several threads until all log entries are written.
+         *
+         * @param sink The sink to write into.
+         * @param format The output format to use.
+         * @param numberOfWorkers The number of chunks formatted at once.
+         * @param index The index of the merge or nullptr.
+         * @return False if there was not enough memory, nothing was written then.
+         */
+        bool writeParallel(FileSink& sink, OutputFormat format, size_t numberOfWorkers, LogIndex* index);
+
+        /**
+         * @brief The position in the log entries of a single thread or in the spilled log entries.
+         */
+        struct Cursor {
+            LogBuffer::const_iterator current;
+            LogBuffer::const_iterator end;
+            const std::pair<size_t, LogEntry>* spilled;
+            const std::pair<size_t, LogEntry>* spilledEnd;
+            size_t threadHash;
+
+            /**
+             * @brief Returns the current log entry.
+             *
+             * @return The log entry.
+             */
+            const LogEntry& get() const noexcept;
+
+            /**
+             * @brief Moves to the next log entry.
+             *
+             * @return False if there is no further log entry.
+             */
+            bool advance() noexcept;
+        };
+
+        /**
+         * @brief Returns whether the current log entry of the first cursor is younger than the one of the second.
+         *
+         * @param a The index of the first cursor.
+         * @param b The index of the second cursor.
+         * @return True if the first cursor comes later.
+         */
+        bool later(size_t a, size_t b) const noexcept;
+
+        /**
+         * @brief One cursor for every thread that has log entries and one for the spilled log entries.
+         */
+        std::vector<Cursor> mCursors;
+
+        /**
+         * @brief The indices of the cursors that have log entries left, the oldest log entry on top.
+         */
+        std::vector<size_t> mHeap;
+
+        /**
+         * @brief The index of the cursor whose log entry was returned last, it is advanced by the next call.
+         */
+        size_t mCurrent;
+
+        /**
+         * @brief The number of log entries of all cursors.
+         */
+        size_t mNumberOfLogEntries;
+
+        /**
+         * @brief The number of threads that format a merge.
+         */
+        static std::atomic_size_t NumberOfWorkers;
+    };
+
+}
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef EASY_EXCEPTION_LOGRETENTIONPOLICY_H
 #define EASY_EXCEPTION_LOGRETENTIONPOLICY_H
 
+#include <unordered_set>
+
 #include "LogEntry.hpp"
+#include "LogSegment.hpp"
 
 namespace ee {
 
@@ -26,19 +29,108 @@ namespace ee {
          */
         virtual bool retain(const LogEntry& logEntry) noexcept = 0;
 
+        /**
+         * @brief Decides whether all log entries of the given segment can be released at once.
+         *
+         * This method must not change the state of the policy. The default implementation can not decide.
+         * @param segment The segment to decide for.
+         * @return True if every log entry of the segment would be released.
+         */
+        virtual bool releaseSegment(const LogSegment& segment) noexcept;
+
+        /**
+         * @brief Decides whether all log entries of the given segment can be retained at once.
+         *
+         * If the whole segment is retained the policy has to update its state as if retain() was called for every
+         * log entry. The default implementation can not decide.
+         * @param segment The segment to decide for.
+         * @return True if every log entry of the segment would be retained.
+         */
+        virtual bool retainSegment(const LogSegment& segment) noexcept;
+
+        /**
+         * @brief Is called once before the log entries of the given segment are decided one by one or in spans.
+         *
+         * The segment is not compressed then. The default implementation does nothing.
+         * @param segment The segment whose log entries follow.
+         */
+        virtual void enterSegment(const LogSegment& segment) noexcept;
+
+        /**
+         * @brief Decides for a contiguous span of log entries at once.
+         *
+         * The log entries are ordered from the oldest to the youngest. The policy decides from the youngest log
+         * entry on and releases the first rejected log entry together with all older ones, so the decision is a
+         * single cut. The policy has to update its state for the retained log entries. The default implementation
+         * calls retain() until it rejects a log entry.
+         * @param entries The oldest log entry of the span.
+         * @param size The number of log entries.
+         * @return The number of log entries at the front of the span that should be released.
+         */
+        virtual size_t releaseSpan(const LogEntry* entries, size_t size) noexcept;
+
+        /**
+         * @brief Returns whether this policy decides across all threads at once.
+         *
+         * Global policies are initialized once per cycle and see the log entries of all threads merged in
+         * chronological order, the youngest first. They have to be budgets: as soon as they release a log entry, all
+         * older log entries are released too. All other policies are initialized for every thread. The default
+         * implementation returns false.
+         * @return True if this policy is global.
+         */
+        virtual bool isGlobal() const noexcept;
+
+        /**
+         * @brief Returns the lowest log level this policy applies to.
+         *
+         * @return The lowest log level.
+         */
+        LogLevel getMinLogLevel() const noexcept;
+
+        /**
+         * @brief Returns the highest log level this policy applies to.
+         *
+         * @return The highest log level.
+         */
+        LogLevel getMaxLogLevel() const noexcept;
+
+        /**
+         * @brief Returns whether this policy decides for log entries of the given log level.
+         *
+         * Log entries of other log levels are ignored by this policy and do not change its state.
+         * @param logLevel The log level.
+         * @return True if the policy applies to the log level.
+         */
+        bool appliesTo(LogLevel logLevel) const noexcept;
+
     protected:
         /**
          * @brief Constructor.
          *
          * @param priority The priority of this log retention policy.
+         * @param minLogLevel The lowest log level this policy applies to.
+         * @param maxLogLevel The highest log level this policy applies to.
          */
-        explicit LogRetentionPolicy(uint8_t priority) noexcept;
+        explicit LogRetentionPolicy(
+                uint8_t priority,
+                LogLevel minLogLevel = LogLevel::Trace,
+                LogLevel maxLogLevel = LogLevel::Fatal) noexcept;
 
     private:
         /**
          * @brief The priority marks how important this log retention policy is.
          */
         const uint8_t mPriority;
+
+        /**
+         * @brief The lowest log level this policy applies to.
+         */
+        const LogLevel mMinLogLevel;
+
+        /**
+         * @brief The highest log level this policy applies to.
+         */
+        const LogLevel mMaxLogLevel;
     };
 
     /**
@@ -50,8 +142,13 @@ namespace ee {
          * @brief Constructor.
          *
          * @param maxNumber The maximum number of logs that should be retained.
+         * @param minLogLevel The lowest log level this policy applies to.
+         * @param maxLogLevel The highest log level this policy applies to.
          */
-        explicit LogRetentionMaxNumber(size_t maxNumber) noexcept;
+        explicit LogRetentionMaxNumber(
+                size_t maxNumber,
+                LogLevel minLogLevel = LogLevel::Trace,
+                LogLevel maxLogLevel = LogLevel::Fatal) noexcept;
 
         /**
          * @brief Initializes this class before every cycle.
@@ -66,6 +163,42 @@ namespace ee {
          */
         bool retain(const LogEntry &logEntry) noexcept override;
 
+        /**
+         * @brief Releases the whole segment if the maximum number is already reached.
+         *
+         * @param segment The segment to decide for.
+         * @return True if the segment should be released.
+         */
+        bool releaseSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Retains the whole segment if it fits into the maximum number.
+         *
+         * @param segment The segment to decide for.
+         * @return True if the segment should be retained.
+         */
+        bool retainSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Retains as many of the youngest log entries as still fit into the maximum number.
+         *
+         * @param entries The oldest log entry of the span.
+         * @param size The number of log entries.
+         * @return The number of log entries at the front of the span that should be released.
+         */
+        size_t releaseSpan(const LogEntry* entries, size_t size) noexcept override;
+
+    protected:
+        /**
+         * @brief Constructor for derived policies with their own priority.
+         *
+         * @param priority The priority of this log retention policy.
+         * @param maxNumber The maximum number of logs that should be retained.
+         * @param minLogLevel The lowest log level this policy applies to.
+         * @param maxLogLevel The highest log level this policy applies to.
+         */
+        LogRetentionMaxNumber(uint8_t priority, size_t maxNumber, LogLevel minLogLevel, LogLevel maxLogLevel) noexcept;
+
     private:
         /**
          * @brief The maximum number of logs we want to retain.
@@ -78,6 +211,32 @@ namespace ee {
         size_t mCounter = 0;
     };
 
+    /**
+     * @brief This class decides how much logs of all threads together should be retained, the oldest ones will be
+     * released.
+     */
+    class LogRetentionGlobalMaxNumber : public LogRetentionMaxNumber {
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param maxNumber The maximum number of logs of all threads that should be retained.
+         * @param minLogLevel The lowest log level this policy applies to.
+         * @param maxLogLevel The highest log level this policy applies to.
+         */
+        explicit LogRetentionGlobalMaxNumber(
+                size_t maxNumber,
+                LogLevel minLogLevel = LogLevel::Trace,
+                LogLevel maxLogLevel = LogLevel::Fatal) noexcept;
+
+        /**
+         * @brief The maximum number is shared by all threads.
+         *
+         * @return Always true.
+         */
+        bool isGlobal() const noexcept override;
+    };
+
     /**
      * @brief This class will release all logs older than the given datetime.
      */
@@ -87,8 +246,13 @@ namespace ee {
          * @brief Constructor.
          *
          * @param dateLimit This date limit will mark the line where older logs are released.
+         * @param minLogLevel The lowest log level this policy applies to.
+         * @param maxLogLevel The highest log level this policy applies to.
          */
-        explicit LogRetentionOlderThan(const std::chrono::milliseconds& lifetime) noexcept;
+        explicit LogRetentionOlderThan(
+                const std::chrono::milliseconds& lifetime,
+                LogLevel minLogLevel = LogLevel::Trace,
+                LogLevel maxLogLevel = LogLevel::Fatal) noexcept;
 
         /**
          * @brief Initializes this class before execution of a cycle.
@@ -103,6 +267,34 @@ namespace ee {
          */
         bool retain(const LogEntry& logEntry) noexcept override;
 
+        /**
+         * @brief Releases the whole segment if its youngest log entry is too old.
+         *
+         * @param segment The segment to decide for.
+         * @return True if the segment should be released.
+         */
+        bool releaseSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Retains the whole segment if its oldest log entry is young enough.
+         *
+         * @param segment The segment to decide for.
+         * @return True if the segment should be retained.
+         */
+        bool retainSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Releases the youngest log entry that is too old and all log entries before it.
+         *
+         * The log entries are ordered by creation, but their dates are not sorted if the system clock was set back.
+         * Like deciding for the log entries one by one from the youngest, a log entry that is young enough is released
+         * as well if a log entry created after it has a date that is too old.
+         * @param entries The oldest log entry of the span.
+         * @param size The number of log entries.
+         * @return The number of log entries at the front of the span that should be released.
+         */
+        size_t releaseSpan(const LogEntry* entries, size_t size) noexcept override;
+
     private:
         /**
          * @brief Specifies the time between the start of the cycle and the oldest log entry.
@@ -115,6 +307,106 @@ namespace ee {
         std::chrono::system_clock::time_point mDatetime;
     };
 
+    /**
+     * @brief This class limits the memory held by all log entries of all threads, the oldest ones will be released.
+     *
+     * Like LogBuffer::getNumberOfBytes, every segment that keeps a log entry counts with its reserved capacity, so the
+     * maximum is a ceiling of the memory the retained log entries hold. Every log entry counts its strings and notes
+     * and a stacktrace is counted once per cycle, but a segment retained as a whole counts a stacktrace again for every
+     * run of adjacent log entries that share it, see LogSegment::getNumberOfBytes. So log entries that share
+     * stacktraces across segments may be released before the memory they hold reaches the maximum.
+     */
+    class LogRetentionMaxBytes : public LogRetentionPolicy {
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param maxBytes The maximum number of bytes the retained log entries may hold.
+         * @param minLogLevel The lowest log level this policy applies to.
+         * @param maxLogLevel The highest log level this policy applies to.
+         */
+        explicit LogRetentionMaxBytes(
+                size_t maxBytes,
+                LogLevel minLogLevel = LogLevel::Trace,
+                LogLevel maxLogLevel = LogLevel::Fatal) noexcept;
+
+        /**
+         * @brief Initializes this class before every cycle.
+         */
+        void init() noexcept override;
+
+        /**
+         * @brief Retains the log entry if its bytes fit into the remaining budget.
+         *
+         * A stacktrace shared by multiple log entries is counted only once per cycle.
+         * @param logEntry The log entry to decide for.
+         * @return True if the log entry should be retained.
+         */
+        bool retain(const LogEntry& logEntry) noexcept override;
+
+        /**
+         * @brief Releases the whole segment if the budget is already exhausted.
+         *
+         * @param segment The segment to decide for.
+         * @return True if the segment should be released.
+         */
+        bool releaseSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Retains the whole segment if it fits into the remaining budget, including its reserved capacity.
+         *
+         * @param segment The segment to decide for.
+         * @return True if the segment should be retained.
+         */
+        bool retainSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Counts the segment with its whole reserved capacity.
+         *
+         * The capacity stays reserved as long as one log entry of the segment is retained, so the log entries that
+         * follow only count the memory they own.
+         * @param segment The segment whose log entries follow.
+         */
+        void enterSegment(const LogSegment& segment) noexcept override;
+
+        /**
+         * @brief Retains the youngest log entries until the budget is exhausted.
+         *
+         * @param entries The oldest log entry of the span.
+         * @param size The number of log entries.
+         * @return The number of log entries at the front of the span that should be released.
+         */
+        size_t releaseSpan(const LogEntry* entries, size_t size) noexcept override;
+
+        /**
+         * @brief The budget is shared by all threads.
+         *
+         * @return Always true.
+         */
+        bool isGlobal() const noexcept override;
+
+    private:
+        /**
+         * @brief The maximum number of bytes we want to retain.
+         */
+        const size_t mMaxBytes;
+
+        /**
+         * @brief The number of bytes counted in this cycle.
+         */
+        size_t mBytes = 0;
+
+        /**
+         * @brief The number of log entries whose slot was already counted with the capacity of their segment.
+         */
+        size_t mReservedEntries = 0;
+
+        /**
+         * @brief The stacktraces already counted in this cycle.
+         */
+        std::unordered_set<const Stacktrace*> mStacktraces;
+    };
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+#ifndef EASY_EXCEPTION_LOGROTATION_H
+#define EASY_EXCEPTION_LOGROTATION_H
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+
+namespace ee {
+
+    /**
+     * @brief Rotates the incident file by size and age, compresses closed files and caps the disk usage.
+     *
+     * While the rotation is running, an incident file that has grown too large or too old is closed and the next
+     * incident starts a new file. A background thread compresses the closed files with the LzCodec in independent
+     * blocks and deletes the oldest log files of the folder as long as they take more than the allowed space. The
+     * youngest log file is never deleted. Until the rotation is started the incident file grows forever.
+     */
+    class LogRotation {
+    public:
+        /**
+         * @brief The number of bytes of a file that are compressed as one block.
+         */
+        static constexpr size_t BlockSize = 1024 * 1024;
+
+        /**
+         * @brief The extension appended to the name of a compressed file.
+         */
+        static constexpr const char* Extension = ".lz";
+
+        /**
+         * @brief Starts the thread that compresses the closed files, a running rotation is restarted.
+         *
+         * @param maxFileSize The size from which on an incident file is closed, zero ignores the size.
+         * @param maxFileAge The age from which on an incident file is closed, zero ignores the age.
+         * @param maxTotalSize The number of bytes all log files of the folder may take, zero keeps all files.
+         */
+        static void start(
+                size_t maxFileSize,
+                const std::chrono::seconds& maxFileAge,
+                size_t maxTotalSize) noexcept;
+
+        /**
+         * @brief Stops the thread, the files closed before are compressed first.
+         */
+        static void stop() noexcept;
+
+        /**
+         * @brief Returns whether incident files are rotated.
+         *
+         * @return True if the thread is running.
+         */
+        static bool isRunning() noexcept;
+
+        /**
+         * @brief Returns whether the given incident file should be closed.
+         *
+         * @param filename The name of the incident file.
+         * @param dateOfCreation The date the incident file has been created.
+         * @return True if the rotation is running and the file is too large or too old.
+         */
+        static bool isDue(const std::string& filename, const std::chrono::system_clock::time_point& dateOfCreation) noexcept;
+
+        /**
+         * @brief Hands a closed incident file over to the background thread.
+         *
+         * The file is compressed after all incidents that were submitted to the IncidentWriter before are written.
+         * @param filename The name of the closed file.
+         */
+        static void close(const std::string& filename) noexcept;
+
+        /**
+         * @brief Waits until all closed files are compressed.
+         */
+        static void flush() noexcept;
+
+        /**
+         * @brief Compresses a file in blocks into a file with the extension appended and removes the original.
+         *
+         * @param filename The name of the file.
+         * @return False if the file could not be compressed, the original is kept then.
+         */
+        static bool compress(const std::string& filename) noexcept;
+
+        /**
+         * @brief Restores a file created by compress().
+         *
+         * @param filename The name of the compressed file.
+         * @param target The name of the restored file, it is overwritten.
+         * @return False if the file is damaged or could not be written.
+         */
+        static bool decompress(const std::string& filename, const std::string& target) noexcept;
+
+        /**
+         * @brief Deletes the oldest log files of the given folder until they take at most the given space.
+         *
+         * @param folder The folder of the log files.
+         * @param maxTotalSize The number of bytes all log files may take.
+         * @return The number of deleted files.
+         */
+        static size_t enforceLimit(const std::string& folder, size_t maxTotalSize) noexcept;
+
+        /**
+         * @brief Returns the number of files compressed since the program started.
+         *
+         * @return The number of compressed files.
+         */
+        static size_t getNumberOfCompressedFiles() noexcept;
+
+    private:
+        /**
+         * @brief Guards the state of the rotation.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Wakes up the thread when a file is closed or the thread should stop.
+         */
+        static std::condition_variable Condition;
+
+        /**
+         * @brief Wakes up the callers of flush() when a file has been compressed.
+         */
+        static std::condition_variable Compressed;
+
+        /**
+         * @brief The thread that compresses the closed files.
+         */
+        static std::thread Thread;
+
+        /**
+         * @brief True while the thread should keep running.
+         */
+        static bool Running;
+
+        /**
+         * @brief The closed files that are not compressed yet, the oldest first.
+         */
+        static std::deque<std::string> Queue;
+
+        /**
+         * @brief The number of closed files that are not completely processed.
+         */
+        static size_t NumberOfPendingFiles;
+
+        /**
+         * @brief The size from which on an incident file is closed.
+         */
+        static size_t MaxFileSize;
+
+        /**
+         * @brief The age from which on an incident file is closed.
+         */
+        static std::chrono::seconds MaxFileAge;
+
+        /**
+         * @brief The number of bytes all log files of the folder may take.
+         */
+        static size_t MaxTotalSize;
+
+        /**
+         * @brief The number of files compressed since the program started.
+         */
+        static std::atomic_size_t NumberOfCompressedFiles;
+    };
+
+}
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef EASY_EXCEPTION_LOGSEGMENT_H
+#define EASY_EXCEPTION_LOGSEGMENT_H
+
+#include <vector>
+#include <chrono>
+
+#include "LogEntry.hpp"
+
+namespace ee {
+
+    /**
+     * @brief A time-ordered chunk of log entries of a single thread.
+     *
+     * The segment reserves its capacity on creation and never grows beyond it, so references to its log entries
+     * remain valid while entries are appended. It keeps track of the oldest and youngest date of creation, which
+     * allows the log retention to decide for the whole segment at once.
+     *
+     * A segment that is not appended to anymore can be compressed into a single block. Its log entries are only
+     * available again after thawing it, but its size, dates and sequence numbers remain available meanwhile.
+     */
+    class LogSegment {
+    public:
+        /**
+         * @brief The maximum number of log entries a segment can hold.
+         */
+        static constexpr size_t MaxCapacity = 1024;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param capacity The number of log entries this segment can hold.
+         */
+        explicit LogSegment(size_t capacity = MaxCapacity);
+
+        /**
+         * @brief Copy constructor, the copy reserves the same capacity.
+         *
+         * @param other The segment to copy.
+         */
+        LogSegment(const LogSegment& other);
+
+        /**
+         * @brief Move constructor.
+         *
+         * @param other The segment to move.
+         */
+        LogSegment(LogSegment&& other) noexcept = default;
+
+        /**
+         * @brief Move assignment.
+         *
+         * @param other The segment to move.
+         * @return Reference to this.
+         */
+        LogSegment& operator=(LogSegment&& other) noexcept = default;
+
+        /**
+         * @brief Appends a new log entry.
+         *
+         * @return Reference to the new log entry.
+         */
+        LogEntry& emplace_back(
+                LogLevel logLevel,
+                const std::string& classname,
+                const std::string& method,
+                const std::string& message,
+                const std::vector<Note>& notes,
+                const std::optional<std::shared_ptr<Stacktrace>>& stacktrace,
+                const std::chrono::system_clock::time_point& dateOfCreation,
+                uint64_t sequenceNumber = 0);
+
+        /**
+         * @brief Releases all log entries that are marked in the given mask.
+         *
+         * A compressed segment releases nothing.
+         * @param release One flag per log entry, true releases the log entry.
+         * @return The number of released log entries.
+         */
+        size_t release(const std::vector<bool>& release) noexcept;
+
+        /**
+         * @brief Encodes all log entries into a compressed block and frees them.
+         *
+         * Nothing happens if the block would not be smaller than the log entries.
+         * @param entries Receives the log entries that were removed from this segment.
+         * @return True if the segment has been compressed.
+         */
+        bool compress(std::vector<LogEntry>& entries);
+
+        /**
+         * @brief Restores the log entries of a compressed segment.
+         *
+         * @return False if the log entries could not be restored, the segment remains compressed then.
+         */
+        bool thaw() noexcept;
+
+        /**
+         * @brief Returns whether the log entries of this segment are compressed.
+         *
+         * @return True if the segment has to be thawed before its log entries can be read.
+         */
+        bool isCompressed() const noexcept;
+
+        /**
+         * @brief Returns the log entries, the oldest first.
+         *
+         * A compressed segment returns no log entries.
+         * @return The log entries of this segment.
+         */
+        const std::vector<LogEntry>& getEntries() const noexcept;
+
+        /**
+         * @brief Returns the number of log entries.
+         *
+         * @return Number of log entries.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * @brief Returns whether this segment contains no log entries.
+         *
+         * @return True if there are no log entries.
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Returns whether this segment can not hold another log entry.
+         *
+         * @return True if the capacity is reached or the segment is compressed.
+         */
+        bool full() const noexcept;
+
+        /**
+         * @brief Returns the number of log entries this segment can hold.
+         *
+         * @return The capacity.
+         */
+        size_t getCapacity() const noexcept;
+
+        /**
+         * @brief Returns the number of bytes the log entries of this segment hold in memory.
+         *
+         * A stacktrace is counted for every log entry unless the previous log entry shares it, so the number
+         * never underestimates the memory that would be freed by releasing this segment. A compressed segment
+         * returns the size of its block.
+         * @return The number of bytes.
+         */
+        size_t getNumberOfBytes() const noexcept;
+
+        /**
+         * @brief Returns the number of bytes this segment reserved for its log entries or its compressed block.
+         *
+         * @return The number of bytes.
+         */
+        size_t getNumberOfReservedBytes() const noexcept;
+
+        /**
+         * @brief Returns the sequence number of the oldest log entry.
+         *
+         * @return The sequence number.
+         */
+        uint64_t getMinSequenceNumber() const noexcept;
+
+        /**
+         * @brief Returns the sequence number of the youngest log entry.
+         *
+         * @return The sequence number.
+         */
+        uint64_t getMaxSequenceNumber() const noexcept;
+
+        /**
+         * @brief Returns the oldest date of creation of all log entries.
+         *
+         * @return The oldest date of creation.
+         */
+        const std::chrono::system_clock::time_point& getMinDateOfCreation() const noexcept;
+
+        /**
+         * @brief Returns the youngest date of creation of all log entries.
+         *
+         * @return The youngest date of creation.
+         */
+        const std::chrono::system_clock::time_point& getMaxDateOfCreation() const noexcept;
+
+    private:
+        /**
+         * @brief Returns the number of bytes of the log entry at the given index.
+         *
+         * @param index The index of the log entry.
+         * @return The number of bytes.
+         */
+        size_t getNumberOfBytes(size_t index) const noexcept;
+
+        /**
+         * @brief The number of log entries this segment can hold.
+         */
+        size_t mCapacity;
+
+        /**
+         * @brief Holds the log entries, the oldest first.
+         */
+        std::vector<LogEntry> mEntries;
+
+        /**
+         * @brief The number of bytes of all log entries including their stacktraces.
+         */
+        size_t mNumberOfBytes = 0;
+
+        /**
+         * @brief The oldest date of creation.
+         */
+        std::chrono::system_clock::time_point mMinDateOfCreation;
+
+        /**
+         * @brief The youngest date of creation.
+         */
+        std::chrono::system_clock::time_point mMaxDateOfCreation;
+
+        /**
+         * @brief The sequence number of the oldest log entry.
+         */
+        uint64_t mMinSequenceNumber = 0;
+
+        /**
+         * @brief The sequence number of the youngest log entry.
+         */
+        uint64_t mMaxSequenceNumber = 0;
+
+        /**
+         * @brief True if the log entries are stored in the compressed block.
+         */
+        bool mCompressed = false;
+
+        /**
+         * @brief The compressed log entries.
+         */
+        std::string mBlock;
+
+        /**
+         * @brief The number of bytes of the encoded log entries before the compression.
+         */
+        size_t mUncompressedSize = 0;
+
+        /**
+         * @brief The number of log entries in the compressed block.
+         */
+        size_t mNumberOfCompressedEntries = 0;
+    };
+
+}
+
+#endif
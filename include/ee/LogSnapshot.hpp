@@ -0,0 +1,103 @@
+#ifndef EASY_EXCEPTION_LOGSNAPSHOT_H
+#define EASY_EXCEPTION_LOGSNAPSHOT_H
+
+#include <map>
+#include <thread>
+#include <chrono>
+
+#include "Exception.hpp"
+#include "LogBuffer.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Owns the log entries that were moved out of the log for an incident.
+     *
+     * The snapshot is created in the time it takes to swap the chains of every thread, afterwards it is independent
+     * of the log. Formatting and writing it needs no lock of the log, so it can happen on another thread while the
+     * program keeps logging. The snapshot also remembers the window of the spill tier that belongs to the incident.
+     */
+    class LogSnapshot {
+    public:
+        /**
+         * @brief The log entries of every thread.
+         */
+        typedef std::map<std::thread::id, LogBuffer> ThreadMap;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param spillSince The oldest date of creation of the spilled log entries to write, the maximum writes none.
+         * @param spillUntil The spilled log entries created at or after this date are skipped.
+         */
+        explicit LogSnapshot(
+                const std::chrono::system_clock::time_point& spillSince = std::chrono::system_clock::time_point::max(),
+                const std::chrono::system_clock::time_point& spillUntil = std::chrono::system_clock::time_point::max()) noexcept;
+
+        /**
+         * @brief Returns the buffer of the given thread and creates it if necessary.
+         *
+         * @param threadId The id of the thread.
+         * @return The buffer of the thread.
+         */
+        LogBuffer& emplace(const std::thread::id& threadId);
+
+        /**
+         * @brief Returns the log entries of every thread.
+         *
+         * @return The map of thread ids to buffers.
+         */
+        const ThreadMap& getThreads() const noexcept;
+
+        /**
+         * @brief Returns the number of log entries of all threads, the spilled log entries are not counted.
+         *
+         * @return Number of log entries.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * @brief Returns the oldest date of creation of the spilled log entries to write.
+         *
+         * @return The date or the maximum if no spilled log entries are written.
+         */
+        const std::chrono::system_clock::time_point& getSpillSince() const noexcept;
+
+        /**
+         * @brief Returns the date from which on spilled log entries are skipped.
+         *
+         * @return The date.
+         */
+        const std::chrono::system_clock::time_point& getSpillUntil() const noexcept;
+
+        /**
+         * @brief Appends the spilled log entries of the window and all log entries of the snapshot to a file.
+         *
+         * The file will be created if it not exists. The spilled log entries and the ones in memory are merged into
+         * a single chronological stream.
+         * @param filename The name of the file.
+         * @param format The output format to use when writing into the file.
+         * @return True if writing was successfully.
+         */
+        bool writeToFile(const std::string& filename, OutputFormat format = EASY_EXCEPTION_OUTPUT_FORMAT) const noexcept;
+
+    private:
+        /**
+         * @brief The log entries of every thread.
+         */
+        ThreadMap mThreads;
+
+        /**
+         * @brief The oldest date of creation of the spilled log entries to write.
+         */
+        std::chrono::system_clock::time_point mSpillSince;
+
+        /**
+         * @brief The spilled log entries created at or after this date are skipped.
+         */
+        std::chrono::system_clock::time_point mSpillUntil;
+    };
+
+}
+
+#endif
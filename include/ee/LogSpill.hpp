@@ -0,0 +1,208 @@
+#ifndef EASY_EXCEPTION_LOGSPILL_H
+#define EASY_EXCEPTION_LOGSPILL_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "Formatter.hpp"
+#include "LogSegment.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Keeps the log entries the log retention released in a bounded ring file on disk.
+     *
+     * The file consists of a small header and a data region of fixed capacity that holds length-prefixed records
+     * created by the LogCodec. New records are appended at the head, the oldest records are overwritten when the
+     * data region is full. The incident handler reads the most recent window back, so an incident file can contain
+     * more history than the memory holds. The spill tier is disabled until open() is called.
+     */
+    class LogSpill {
+    public:
+        /**
+         * @brief The number of bytes of the file header in front of the data region.
+         */
+        static constexpr size_t HeaderSize = 64;
+
+        /**
+         * @brief The smallest capacity of the data region.
+         */
+        static constexpr size_t MinCapacity = 4096;
+
+        /**
+         * @brief Opens the ring file and enables the spill tier.
+         *
+         * A file that was created with the same capacity is continued, so the history of a previous run survives.
+         * Any other file is overwritten.
+         * @param filename The name of the ring file, every process should use its own file.
+         * @param capacity The number of bytes of the data region.
+         * @param incidentWindow How far the incident handler looks back into the ring file.
+         * @return True if the file could be opened.
+         */
+        static bool open(
+                const std::string& filename,
+                size_t capacity,
+                const std::chrono::milliseconds& incidentWindow = std::chrono::minutes(30)) noexcept;
+
+        /**
+         * @brief Closes the ring file and disables the spill tier.
+         */
+        static void close() noexcept;
+
+        /**
+         * @brief Returns whether the spill tier is enabled.
+         *
+         * @return True if the ring file is open.
+         */
+        static bool isOpen() noexcept;
+
+        /**
+         * @brief Appends log entries of the given segment to the ring file.
+         *
+         * @param threadId The id of the thread that created the log entries.
+         * @param segment The segment.
+         * @param release One flag per log entry, true spills the log entry. An empty mask spills all log entries.
+         */
+        static void append(
+                const std::thread::id& threadId,
+                const LogSegment& segment,
+                const std::vector<bool>& release) noexcept;
+
+        /**
+         * @brief Reads all log entries of the ring file that were created at or after the given date.
+         *
+         * @param since The oldest date of creation to read.
+         * @param until The log entries created at or after this date are skipped.
+         * @return Pairs of the hash of the thread id and the log entry, ordered by date of creation.
+         */
+        static std::vector<std::pair<size_t, LogEntry>> read(
+                const std::chrono::system_clock::time_point& since,
+                const std::chrono::system_clock::time_point& until = std::chrono::system_clock::time_point::max()) noexcept;
+
+        /**
+         * @brief Appends all log entries of the ring file that were created at or after the given date to a file.
+         *
+         * @param filename The name of the file.
+         * @param since The oldest date of creation to write.
+         * @param format The output format.
+         * @param until The log entries created at or after this date are skipped.
+         * @return True if the log entries could be written.
+         */
+        static bool writeToFile(
+                const std::string& filename,
+                const std::chrono::system_clock::time_point& since,
+                OutputFormat format = EASY_EXCEPTION_OUTPUT_FORMAT,
+                const std::chrono::system_clock::time_point& until = std::chrono::system_clock::time_point::max()) noexcept;
+
+        /**
+         * @brief Returns the number of bytes of the data region.
+         *
+         * @return The capacity or zero if the ring file is not open.
+         */
+        static size_t getCapacity() noexcept;
+
+        /**
+         * @brief Returns the number of bytes the records in the ring file occupy.
+         *
+         * @return The number of bytes.
+         */
+        static size_t getNumberOfBytes() noexcept;
+
+        /**
+         * @brief Returns the number of log entries that were spilled since the program started.
+         *
+         * @return The number of log entries.
+         */
+        static size_t getNumberOfSpilledLogEntries() noexcept;
+
+        /**
+         * @brief Returns how far the incident handler looks back into the ring file.
+         *
+         * @return The incident window.
+         */
+        static std::chrono::milliseconds getIncidentWindow() noexcept;
+
+    private:
+        /**
+         * @brief Makes room for the given number of bytes at the head and appends the record.
+         *
+         * The caller has to hold the mutex.
+         * @param record The length-prefixed record.
+         * @param pending The bytes that are not written yet, they start at the physical offset pendingOffset.
+         * @param pendingOffset The physical offset of the pending bytes.
+         * @return False if the file could not be read or written.
+         */
+        static bool place(const std::string& record, std::string& pending, uint64_t& pendingOffset) noexcept;
+
+        /**
+         * @brief Moves the tail behind the oldest record.
+         *
+         * The caller has to hold the mutex.
+         * @param pending The bytes that are not written yet.
+         * @param pendingOffset The physical offset of the pending bytes.
+         * @return False if the file could not be read.
+         */
+        static bool evict(const std::string& pending, uint64_t pendingOffset) noexcept;
+
+        /**
+         * @brief Writes the pending bytes to the file.
+         *
+         * @return False if the file could not be written.
+         */
+        static bool flush(std::string& pending, uint64_t& pendingOffset) noexcept;
+
+        /**
+         * @brief Writes the header with the current head and tail.
+         *
+         * @return False if the file could not be written.
+         */
+        static bool writeHeader() noexcept;
+
+        /**
+         * @brief Guards the file and its positions.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Allows checking for the spill tier without locking.
+         */
+        static std::atomic_bool Open;
+
+        /**
+         * @brief The file descriptor of the ring file.
+         */
+        static int FileDescriptor;
+
+        /**
+         * @brief The number of bytes of the data region.
+         */
+        static uint64_t Capacity;
+
+        /**
+         * @brief The logical position of the next record, it only grows.
+         */
+        static uint64_t Head;
+
+        /**
+         * @brief The logical position of the oldest record, it only grows.
+         */
+        static uint64_t Tail;
+
+        /**
+         * @brief How far the incident handler looks back into the ring file.
+         */
+        static std::chrono::milliseconds IncidentWindow;
+
+        /**
+         * @brief The number of log entries that were spilled since the program started.
+         */
+        static std::atomic_size_t NumberOfSpilledLogEntries;
+    };
+
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef EASY_EXCEPTION_LZCODEC_H
+#define EASY_EXCEPTION_LZCODEC_H
+
+#include <string>
+
+namespace ee {
+
+    /**
+     * @brief A small LZ77 block compressor that favours speed over ratio.
+     *
+     * A block is a list of sequences. Every sequence starts with a token that holds the number of literals in its
+     * upper and the length of the match in its lower four bits, followed by the literals, the 16 bit distance to the
+     * match and the remaining length bytes. The last sequence has no match. Log entries repeat their classnames,
+     * methods and stacktraces a lot, which is exactly what such a compressor finds cheaply.
+     */
+    class LzCodec {
+    public:
+        /**
+         * @brief Appends the compressed form of the given bytes to the given buffer.
+         *
+         * @param data The bytes to compress.
+         * @param size The number of bytes.
+         * @param buffer The buffer to append to.
+         */
+        static void compress(const char* data, size_t size, std::string& buffer);
+
+        /**
+         * @brief Appends the original bytes of a block that was created by compress() to the given buffer.
+         *
+         * @param data The compressed block.
+         * @param size The number of bytes of the block.
+         * @param originalSize The number of bytes before the compression.
+         * @param buffer The buffer to append to.
+         * @return False if the block is damaged or the memory could not be allocated, the buffer is left unchanged.
+         */
+        static bool decompress(const char* data, size_t size, size_t originalSize, std::string& buffer) noexcept;
+    };
+
+}
+
+#endif
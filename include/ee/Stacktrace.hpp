@@ -15,6 +15,26 @@ namespace ee {
     public:
         static std::optional<std::shared_ptr<Stacktrace>> create(size_t numberOfLines = 32) noexcept;
 
+        /**
+         * @brief Creates a stacktrace by resolving the given return addresses.
+         *
+         * @param addresses The return addresses, the innermost first.
+         * @param numberOfAddresses The number of addresses.
+         * @return An optional that can contain the stacktrace.
+         */
+        static std::optional<std::shared_ptr<Stacktrace>> create(
+                void* const* addresses,
+                size_t numberOfAddresses) noexcept;
+
+        /**
+         * @brief Unwinds the stack of the caller and stores the raw return addresses without resolving them.
+         *
+         * @param addresses The buffer that receives the addresses.
+         * @param numberOfAddresses The capacity of the buffer.
+         * @return The number of addresses stored.
+         */
+        static size_t capture(void** addresses, size_t numberOfAddresses) noexcept;
+
         /**
          * @brief Constructor.
          */
@@ -30,6 +50,13 @@ namespace ee {
          */
         std::string asString() const noexcept;
 
+        /**
+         * @brief Returns the number of bytes this stacktrace holds in memory, including its shared control block.
+         *
+         * @return The number of bytes.
+         */
+        size_t getNumberOfBytes() const noexcept;
+
     private:
         /**
          * @brief This map holds the lines of the stacktrace.
@@ -0,0 +1,93 @@
+#ifndef EASY_EXCEPTION_THROWHOOK_H
+#define EASY_EXCEPTION_THROWHOOK_H
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <exception>
+
+#include "Stacktrace.hpp"
+
+namespace ee {
+
+    /**
+     * @brief Captures the stack at the point where an exception is thrown.
+     *
+     * When the library is built with EASY_EXCEPTION_THROW_HOOK it interposes __cxa_throw, the entry point of the
+     * C++ runtime for every throw expression. While enabled, the raw return addresses of every n-th thrown object are
+     * stored in a slot of the throwing thread. Catch sites can then ask for the stacktrace of the origin instead of
+     * creating one of the handler.
+     */
+    class ThrowHook {
+    public:
+        /**
+         * @brief Starts capturing the stack of thrown objects.
+         *
+         * @param samplingRate Only every n-th throw of a thread is captured, 1 captures every throw.
+         */
+        static void enable(uint32_t samplingRate = 1) noexcept;
+
+        /**
+         * @brief Stops capturing the stack of thrown objects.
+         */
+        static void disable() noexcept;
+
+        /**
+         * @brief Returns whether the stack of thrown objects is captured.
+         *
+         * @return True if enabled.
+         */
+        static bool isEnabled() noexcept;
+
+        /**
+         * @brief Returns whether the hook has been compiled into the library.
+         *
+         * @return True if __cxa_throw is interposed.
+         */
+        static bool isAvailable() noexcept;
+
+        /**
+         * @brief Returns the sampling rate.
+         *
+         * @return The sampling rate.
+         */
+        static uint32_t getSamplingRate() noexcept;
+
+        /**
+         * @brief Returns the stacktrace of the origin of the given exception if it was captured by this thread.
+         *
+         * @param exception The exception that has been caught.
+         * @return An optional that can contain the stacktrace of the throw site.
+         */
+        static std::optional<std::shared_ptr<Stacktrace>> getStacktrace(const std::exception& exception) noexcept;
+
+        /**
+         * @brief Returns the stacktrace of the origin of the given thrown object if it was captured by this thread.
+         *
+         * @param thrownObject The address of the complete thrown object.
+         * @return An optional that can contain the stacktrace of the throw site.
+         */
+        static std::optional<std::shared_ptr<Stacktrace>> getStacktrace(const void* thrownObject) noexcept;
+
+        /**
+         * @brief Stores the stack of the given thrown object in the slot of the calling thread, if it is sampled.
+         *
+         * @param thrownObject The address of the thrown object.
+         */
+        static void capture(const void* thrownObject) noexcept;
+
+    private:
+        /**
+         * @brief The flag that enables the capturing.
+         */
+        static std::atomic_bool Enabled;
+
+        /**
+         * @brief Every n-th throw of a thread will be captured.
+         */
+        static std::atomic_uint32_t SamplingRate;
+    };
+
+}
+
+#endif
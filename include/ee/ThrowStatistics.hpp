@@ -0,0 +1,182 @@
+#ifndef EASY_EXCEPTION_THROWSTATISTICS_H
+#define EASY_EXCEPTION_THROWSTATISTICS_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+#include <typeinfo>
+
+#include "Exception.hpp"
+#include "Stacktrace.hpp"
+
+namespace ee {
+
+    /**
+     * @brief A snapshot of the statistics of a single throw site.
+     */
+    class ThrowSite {
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param type The demangled name of the exception type.
+         * @param caller The caller that created the exception.
+         * @param count The number of exceptions created at this site.
+         * @param firstOccurrence The date of the first exception.
+         * @param lastOccurrence The date of the latest exception.
+         * @param stacktrace The stacktrace of the first exception.
+         */
+        ThrowSite(
+                std::string type,
+                std::string caller,
+                uint64_t count,
+                const std::chrono::system_clock::time_point& firstOccurrence,
+                const std::chrono::system_clock::time_point& lastOccurrence,
+                std::optional<std::shared_ptr<Stacktrace>> stacktrace) noexcept;
+
+        /**
+         * @brief Returns the demangled name of the exception type.
+         *
+         * @return Name of the exception type.
+         */
+        const std::string& getType() const noexcept;
+
+        /**
+         * @brief Returns the caller that created the exceptions.
+         *
+         * @return The caller of the exceptions.
+         */
+        const std::string& getCaller() const noexcept;
+
+        /**
+         * @brief Returns the number of exceptions created at this site.
+         *
+         * @return Number of exceptions.
+         */
+        uint64_t getCount() const noexcept;
+
+        /**
+         * @brief Returns the date of the first exception.
+         *
+         * @return Date of the first exception.
+         */
+        const std::chrono::system_clock::time_point& getFirstOccurrence() const noexcept;
+
+        /**
+         * @brief Returns the date of the latest exception.
+         *
+         * @return Date of the latest exception.
+         */
+        const std::chrono::system_clock::time_point& getLastOccurrence() const noexcept;
+
+        /**
+         * @brief Returns the stacktrace of the first exception, that represents all exceptions of this site.
+         *
+         * @return Optional that can contain a stacktrace.
+         */
+        const std::optional<std::shared_ptr<Stacktrace>>& getStacktrace() const noexcept;
+
+    private:
+        std::string mType;
+        std::string mCaller;
+        uint64_t mCount;
+        std::chrono::system_clock::time_point mFirstOccurrence;
+        std::chrono::system_clock::time_point mLastOccurrence;
+        std::optional<std::shared_ptr<Stacktrace>> mStacktrace;
+    };
+
+    /**
+     * @brief Process-wide registry that counts the created exceptions per type and caller.
+     *
+     * Every ee::Exception reports itself on construction. Each thread caches the sites it has already seen, so
+     * repeated exceptions only cost a hash lookup and some atomic operations.
+     */
+    class ThrowStatistics {
+    public:
+        /**
+         * @brief Counts an exception of the given type created by the given caller.
+         *
+         * @param type The type of the exception.
+         * @param caller The caller that created the exception.
+         * @param stacktrace The stacktrace that is kept if this is the first exception of the site.
+         */
+        static void record(
+                const std::type_info& type,
+                const std::string& caller,
+                const std::optional<std::shared_ptr<Stacktrace>>& stacktrace) noexcept;
+
+        /**
+         * @brief Returns all throw sites that have been recorded, the most frequent first.
+         *
+         * @return List of throw sites.
+         */
+        static std::vector<ThrowSite> getThrowSites() noexcept;
+
+        /**
+         * @brief Resets the counters of all throw sites.
+         */
+        static void reset() noexcept;
+
+        /**
+         * @brief Enables or disables recording.
+         *
+         * @param enabled True to record exceptions.
+         */
+        static void setEnabled(bool enabled) noexcept;
+
+        /**
+         * @brief Returns whether exceptions are recorded.
+         *
+         * @return True if exceptions are recorded.
+         */
+        static bool isEnabled() noexcept;
+
+        /**
+         * @brief Writes all throw sites into a file with the given name, the most frequent first.
+         *
+         * The file will be created if it not exists, new content is appended.
+         * @param filename The name of the file.
+         * @param format The output format to use when writing into the file.
+         * @return True if writing was successfully.
+         */
+        static bool writeToFile(
+                const std::string& filename,
+                OutputFormat format = EASY_EXCEPTION_OUTPUT_FORMAT) noexcept;
+
+    private:
+        /**
+         * @brief The live counters of a single throw site.
+         */
+        struct Site {
+            const std::type_info* type;
+            std::string caller;
+            std::optional<std::shared_ptr<Stacktrace>> stacktrace;
+            std::atomic_uint64_t count{0};
+            std::atomic_int64_t firstOccurrence{0};
+            std::atomic_int64_t lastOccurrence{0};
+        };
+
+        /**
+         * @brief The mutex that must be locked every time the map of sites is queried or modified.
+         */
+        static std::mutex Mutex;
+
+        /**
+         * @brief Holds all sites by type and caller, sites are never removed because threads cache pointers to them.
+         */
+        static std::map<std::pair<std::string, std::string>, std::unique_ptr<Site>> Sites;
+
+        /**
+         * @brief Recording can be switched off with this flag.
+         */
+        static std::atomic_bool Enabled;
+    };
+
+}
+
+#endif
@@ -0,0 +1,630 @@
+#include <ee/AsyncWriter.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_FEAT_EXT_ARG
+#define EASY_EXCEPTION_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace ee {
+
+    std::mutex AsyncWriter::Mutex;
+    std::condition_variable AsyncWriter::Condition;
+    std::condition_variable AsyncWriter::Recycled;
+    AsyncWriter::Backend AsyncWriter::CurrentBackend = AsyncWriter::Backend::None;
+    std::vector<char> AsyncWriter::Memory;
+    std::vector<size_t> AsyncWriter::FreeBuffers;
+    std::vector<AsyncWriter::Operation> AsyncWriter::Operations;
+    std::vector<size_t> AsyncWriter::FreeOperations;
+    size_t AsyncWriter::NumberOfPendingOperations = 0;
+    std::vector<size_t> AsyncWriter::Queue;
+    std::vector<std::thread> AsyncWriter::Threads;
+    std::atomic_size_t AsyncWriter::NumberOfCompletions = 0;
+
+    /**
+     * @brief The backend the threads serve, it stays set until they are stopped while new writes already bypass them.
+     */
+    static AsyncWriter::Backend runningBackend = AsyncWriter::Backend::None;
+
+    /**
+     * @brief True once the threads should exit after the queue is drained.
+     */
+    static bool stopping = false;
+
+    /**
+     * @brief Ensures only one caller stops the threads at a time.
+     */
+    static std::mutex stopMutex;
+
+    /**
+     * @brief Ensures the writer is stopped at exit only once.
+     */
+    static std::once_flag atExitFlag;
+
+    /**
+     * @brief Writes all given bytes at the given position and retries interrupted calls.
+     *
+     * @param fileDescriptor The file to write into.
+     * @param data The first byte.
+     * @param size The number of bytes.
+     * @param offset The position in the file.
+     * @return True if all bytes were written.
+     */
+    static bool writeFully(int fileDescriptor, const char *data, size_t size, uint64_t offset) noexcept {
+        while (size > 0) {
+            auto written = ::pwrite(fileDescriptor, data, size, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return true;
+    }
+
+#ifdef EASY_EXCEPTION_IO_URING
+    /**
+     * @brief The user data of the no-op that stops the thread that reaps the completions.
+     */
+    static constexpr uint64_t stopToken = UINT64_MAX;
+
+    /**
+     * @brief True once stop() could not submit the no-op, the reaping thread then stops after its next wait.
+     */
+    static std::atomic_bool abandoned = false;
+
+    /**
+     * @brief The longest time the reaping thread waits for a completion before it checks whether it should stop.
+     */
+    static constexpr long reapTimeout = 100 * 1000 * 1000;
+
+    /**
+     * @brief The submission and completion queues shared with the kernel.
+     */
+    static struct Ring {
+        int fileDescriptor = -1;
+        void *submissionMemory = MAP_FAILED;
+        size_t submissionSize = 0;
+        void *completionMemory = MAP_FAILED;
+        size_t completionSize = 0;
+        io_uring_sqe *entries = static_cast<io_uring_sqe *>(MAP_FAILED);
+        size_t entriesSize = 0;
+        unsigned *submissionHead = nullptr;
+        unsigned *submissionTail = nullptr;
+        unsigned *submissionMask = nullptr;
+        unsigned *submissionArray = nullptr;
+        unsigned *completionHead = nullptr;
+        unsigned *completionTail = nullptr;
+        unsigned *completionMask = nullptr;
+        io_uring_cqe *completions = nullptr;
+        bool registered = false;
+    } ring;
+
+    /**
+     * @brief Unmaps the queues and closes the ring.
+     */
+    static void closeRing() noexcept {
+        if (ring.entries != MAP_FAILED) {
+            ::munmap(ring.entries, ring.entriesSize);
+        }
+        if (ring.completionMemory != MAP_FAILED && ring.completionMemory != ring.submissionMemory) {
+            ::munmap(ring.completionMemory, ring.completionSize);
+        }
+        if (ring.submissionMemory != MAP_FAILED) {
+            ::munmap(ring.submissionMemory, ring.submissionSize);
+        }
+        if (ring.fileDescriptor >= 0) {
+            ::close(ring.fileDescriptor);
+        }
+        ring = Ring();
+    }
+
+    /**
+     * @brief Sets up the ring and registers the buffers.
+     *
+     * @param memory The memory of the buffers.
+     * @return False if the kernel does not support io_uring or is too old for waits with a timeout.
+     */
+    static bool openRing(char *memory) noexcept {
+        io_uring_params params{};
+        ring.fileDescriptor = static_cast<int>(::syscall(
+                __NR_io_uring_setup, static_cast<unsigned>(2 * AsyncWriter::MaxNumberOfOperations), &params));
+        if (ring.fileDescriptor < 0) {
+            return false;
+        }
+
+        // Kernels that support waits with a timeout also know plain writes and forced asynchronous submissions
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0 || (params.features & IORING_FEAT_EXT_ARG) == 0) {
+            closeRing();
+            return false;
+        }
+
+        ring.submissionSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring.completionSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            ring.submissionSize = ring.completionSize = std::max(ring.submissionSize, ring.completionSize);
+        }
+        ring.submissionMemory = ::mmap(nullptr, ring.submissionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       ring.fileDescriptor, IORING_OFF_SQ_RING);
+        ring.completionMemory = single ? ring.submissionMemory :
+                                ::mmap(nullptr, ring.completionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       ring.fileDescriptor, IORING_OFF_CQ_RING);
+        ring.entriesSize = params.sq_entries * sizeof(io_uring_sqe);
+        ring.entries = static_cast<io_uring_sqe *>(::mmap(nullptr, ring.entriesSize, PROT_READ | PROT_WRITE,
+                                                           MAP_SHARED | MAP_POPULATE, ring.fileDescriptor,
+                                                           IORING_OFF_SQES));
+        if (ring.submissionMemory == MAP_FAILED || ring.completionMemory == MAP_FAILED || ring.entries == MAP_FAILED) {
+            closeRing();
+            return false;
+        }
+
+        auto submission = static_cast<char *>(ring.submissionMemory);
+        ring.submissionHead = reinterpret_cast<unsigned *>(submission + params.sq_off.head);
+        ring.submissionTail = reinterpret_cast<unsigned *>(submission + params.sq_off.tail);
+        ring.submissionMask = reinterpret_cast<unsigned *>(submission + params.sq_off.ring_mask);
+        ring.submissionArray = reinterpret_cast<unsigned *>(submission + params.sq_off.array);
+        auto completion = static_cast<char *>(ring.completionMemory);
+        ring.completionHead = reinterpret_cast<unsigned *>(completion + params.cq_off.head);
+        ring.completionTail = reinterpret_cast<unsigned *>(completion + params.cq_off.tail);
+        ring.completionMask = reinterpret_cast<unsigned *>(completion + params.cq_off.ring_mask);
+        ring.completions = reinterpret_cast<io_uring_cqe *>(completion + params.cq_off.cqes);
+
+        // Registered buffers are pinned once instead of on every write, a low memlock limit only costs that speedup
+        iovec buffers[AsyncWriter::NumberOfBuffers];
+        for (size_t i = 0; i < AsyncWriter::NumberOfBuffers; i++) {
+            buffers[i] = {memory + i * AsyncWriter::BufferSize, AsyncWriter::BufferSize};
+        }
+        ring.registered = ::syscall(__NR_io_uring_register, ring.fileDescriptor, IORING_REGISTER_BUFFERS, buffers,
+                                    static_cast<unsigned>(AsyncWriter::NumberOfBuffers)) == 0;
+        return true;
+    }
+
+    /**
+     * @brief Returns the next free submission entry, the caller has to hold the mutex.
+     *
+     * @param tail The local tail of the submission queue, it is advanced.
+     * @return The cleared entry.
+     */
+    static io_uring_sqe *nextEntry(unsigned &tail) noexcept {
+        auto index = tail & *ring.submissionMask;
+        auto entry = &ring.entries[index];
+        std::memset(entry, 0, sizeof(io_uring_sqe));
+        ring.submissionArray[index] = index;
+        tail++;
+        return entry;
+    }
+
+    /**
+     * @brief Publishes the entries up to the given tail and hands them over to the kernel.
+     *
+     * @param tail The new tail of the submission queue.
+     * @param count The number of new entries.
+     * @return The number of new entries the kernel refused, they are taken back from the queue.
+     */
+    static unsigned enter(unsigned tail, unsigned count) noexcept {
+        __atomic_store_n(ring.submissionTail, tail, __ATOMIC_RELEASE);
+        while (count > 0) {
+            auto submitted = ::syscall(__NR_io_uring_enter, ring.fileDescriptor, count, 0, 0, nullptr, 0);
+            if (submitted > 0) {
+                count -= static_cast<unsigned>(submitted);
+                continue;
+            }
+            if (submitted < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // The kernel only consumes entries while we call it, so the ones it did not take can be withdrawn
+            auto head = __atomic_load_n(ring.submissionHead, __ATOMIC_ACQUIRE);
+            __atomic_store_n(ring.submissionTail, head, __ATOMIC_RELEASE);
+            return tail - head;
+        }
+        return 0;
+    }
+#endif
+
+    AsyncWriter::File::File(int fileDescriptor) noexcept : mFileDescriptor(fileDescriptor) {}
+
+    AsyncWriter::File::~File() noexcept {
+        if (this->mFileDescriptor >= 0) {
+            ::close(this->mFileDescriptor);
+        }
+    }
+
+    int AsyncWriter::File::getFileDescriptor() const noexcept {
+        return this->mFileDescriptor;
+    }
+
+    bool AsyncWriter::File::wait() noexcept {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Recycled.wait(lock, [this]() { return this->mNumberOfCompleted == this->mNumberOfSubmitted; });
+        auto failed = this->mFailed;
+        this->mFailed = false;
+        return !failed;
+    }
+
+    AsyncWriter::Backend AsyncWriter::start(Backend backend) noexcept {
+        stop();
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (runningBackend != Backend::None || backend == Backend::None) {
+                // Another caller started the writer meanwhile
+                return CurrentBackend;
+            }
+
+            // The buffers and operations are allocated once, recycling them never allocates
+            try {
+                Memory.resize(NumberOfBuffers * BufferSize);
+                Operations.resize(MaxNumberOfOperations);
+                FreeBuffers.clear();
+                FreeBuffers.reserve(NumberOfBuffers);
+                for (size_t i = 0; i < NumberOfBuffers; i++) {
+                    FreeBuffers.push_back(i);
+                }
+                FreeOperations.clear();
+                FreeOperations.reserve(MaxNumberOfOperations);
+                for (size_t i = 0; i < MaxNumberOfOperations; i++) {
+                    FreeOperations.push_back(i);
+                }
+                Queue.clear();
+                Queue.reserve(MaxNumberOfOperations);
+                Threads.reserve(NumberOfThreads);
+            } catch (...) {
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not allocate the buffers" << std::endl;
+                return Backend::None;
+            }
+            stopping = false;
+
+#ifdef EASY_EXCEPTION_IO_URING
+            if (backend == Backend::IoUring && openRing(Memory.data())) {
+                try {
+                    abandoned = false;
+                    Threads.emplace_back([]() {
+                        __kernel_timespec timeout{0, reapTimeout};
+                        io_uring_getevents_arg argument{};
+                        argument.ts = reinterpret_cast<uint64_t>(&timeout);
+                        while (true) {
+                            // The submitting threads never wait for completions, this thread is the only consumer
+                            if (::syscall(__NR_io_uring_enter, ring.fileDescriptor, 0, 1,
+                                          IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &argument,
+                                          sizeof(argument)) < 0 && errno != EINTR && errno != EAGAIN &&
+                                errno != EBUSY && errno != ETIME) {
+                                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                            }
+                            auto head = *ring.completionHead;
+                            auto tail = __atomic_load_n(ring.completionTail, __ATOMIC_ACQUIRE);
+                            bool stopped = false;
+                            for (; head != tail; head++) {
+                                auto &completion = ring.completions[head & *ring.completionMask];
+                                if (completion.user_data == stopToken) {
+                                    stopped = true;
+                                    continue;
+                                }
+
+                                // The operations do not change while in flight, only this thread touches their flags
+                                auto index = static_cast<size_t>(completion.user_data);
+                                auto &operation = Operations[index];
+                                if (operation.sync) {
+                                    if (completion.res != -ECANCELED || operation.linked == SIZE_MAX) {
+                                        complete(index, completion.res >= 0);
+                                    } else if (operation.reaped) {
+                                        // Its write was short or failed and has been finished, the fsync runs now
+                                        complete(index, operation.succeeded &&
+                                                        ::fsync(operation.file->mFileDescriptor) == 0);
+                                    } else {
+                                        // Its write has not been reaped yet, it completes us
+                                        operation.cancelled = true;
+                                    }
+                                    continue;
+                                }
+
+                                // A short or failed write cancelled the fsync linked to it, a short one is finished here
+                                bool result = completion.res >= 0;
+                                bool shortWrite = static_cast<size_t>(std::max(completion.res, 0)) < operation.size;
+                                if (result && shortWrite) {
+                                    auto written = static_cast<size_t>(completion.res);
+                                    result = writeFully(operation.file->mFileDescriptor,
+                                                        Memory.data() + operation.buffer * BufferSize + written,
+                                                        operation.size - written, operation.offset + written);
+                                }
+                                if (operation.linked != SIZE_MAX && shortWrite) {
+                                    auto &fsync = Operations[operation.linked];
+                                    if (fsync.cancelled) {
+                                        complete(operation.linked,
+                                                 result && ::fsync(operation.file->mFileDescriptor) == 0);
+                                    } else {
+                                        fsync.reaped = true;
+                                        fsync.succeeded = result;
+                                    }
+                                }
+                                complete(index, result);
+                            }
+                            __atomic_store_n(ring.completionHead, head, __ATOMIC_RELEASE);
+                            if (stopped || abandoned) {
+                                break;
+                            }
+                        }
+                    });
+                    CurrentBackend = runningBackend = Backend::IoUring;
+                } catch (...) {
+                    closeRing();
+                }
+            }
+#endif
+
+            // Without io_uring a few threads write the blocks with pwrite
+            if (runningBackend == Backend::None) {
+                for (size_t i = 0; i < NumberOfThreads; i++) {
+                    try {
+                        Threads.emplace_back([]() {
+                            std::unique_lock<std::mutex> lock(Mutex);
+                            while (true) {
+                                Condition.wait(lock, []() { return stopping || !Queue.empty(); });
+                                if (Queue.empty()) {
+                                    // We only stop after the queue is drained
+                                    break;
+                                }
+                                auto index = Queue.front();
+                                Queue.erase(Queue.begin());
+                                auto &operation = Operations[index];
+
+                                // The writes submitted before an fsync were taken from the queue before it
+                                if (operation.sync) {
+                                    Recycled.wait(lock, [&operation]() {
+                                        return operation.file->mNumberOfRunningWrites == 0;
+                                    });
+                                } else {
+                                    operation.file->mNumberOfRunningWrites++;
+                                }
+                                lock.unlock();
+                                complete(index, execute(operation));
+                                lock.lock();
+                            }
+                        });
+                    } catch (...) {
+                        // A single thread is enough to keep writing
+                        break;
+                    }
+                }
+                if (Threads.empty()) {
+                    std::cerr << __PRETTY_FUNCTION__ << ": Could not start asynchronous writer" << std::endl;
+                    return Backend::None;
+                }
+                CurrentBackend = runningBackend = Backend::ThreadPool;
+            }
+        }
+
+        // The statics of the logging are created before the program calls us, so they outlive this handler
+        try {
+            std::call_once(atExitFlag, []() {
+                std::atexit([]() {
+                    AsyncWriter::stop();
+                });
+            });
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not register exit handler" << std::endl;
+        }
+        return getBackend();
+    }
+
+    void AsyncWriter::stop() noexcept {
+        std::lock_guard<std::mutex> stopLock(stopMutex);
+        std::unique_lock<std::mutex> lock(Mutex);
+        if (runningBackend == Backend::None) {
+            return;
+        }
+
+        // New writes are written by their callers, the writes in flight are finished by the threads
+        CurrentBackend = Backend::None;
+        Recycled.notify_all();
+        Recycled.wait(lock, []() { return NumberOfPendingOperations == 0; });
+        stopping = true;
+#ifdef EASY_EXCEPTION_IO_URING
+        if (runningBackend == Backend::IoUring) {
+            auto tail = *ring.submissionTail;
+            auto entry = nextEntry(tail);
+            entry->opcode = IORING_OP_NOP;
+            entry->user_data = stopToken;
+            if (enter(tail, 1) > 0) {
+                // Nothing is in flight, so the thread stops once its wait times out
+                abandoned = true;
+            }
+        }
+#endif
+        lock.unlock();
+        Condition.notify_all();
+
+        // None of the threads calls this method, so joining can not deadlock
+        for (auto &thread : Threads) {
+            thread.join();
+        }
+        Threads.clear();
+#ifdef EASY_EXCEPTION_IO_URING
+        if (runningBackend == Backend::IoUring) {
+            closeRing();
+        }
+#endif
+        runningBackend = Backend::None;
+    }
+
+    AsyncWriter::Backend AsyncWriter::getBackend() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return CurrentBackend;
+    }
+
+    bool AsyncWriter::write(
+            const std::shared_ptr<File> &file,
+            const char *data,
+            size_t size,
+            uint64_t offset,
+            bool sync) noexcept {
+        if (!file || (size == 0 && !sync)) {
+            return file != nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(Mutex);
+        size_t position = 0;
+        do {
+            // A writer only waits if all buffers are in flight
+            auto block = std::min(size - position, BufferSize);
+            auto last = position + block == size;
+            size_t numberOfOperations = (block > 0 ? 1 : 0) + (last && sync ? 1 : 0);
+            Recycled.wait(lock, [block, numberOfOperations]() {
+                return CurrentBackend == Backend::None ||
+                       (FreeOperations.size() >= numberOfOperations && (block == 0 || !FreeBuffers.empty()));
+            });
+            if (CurrentBackend == Backend::None) {
+                // The writer is stopped, the remaining bytes are written right here
+                lock.unlock();
+                auto result = writeFully(file->mFileDescriptor, data + position, size - position, offset + position);
+                return result && (!sync || ::fsync(file->mFileDescriptor) == 0);
+            }
+
+            size_t first = SIZE_MAX, second = SIZE_MAX, buffer = SIZE_MAX, fsync = SIZE_MAX;
+            if (last && sync) {
+                fsync = FreeOperations.back();
+                FreeOperations.pop_back();
+            }
+            if (block > 0) {
+                first = FreeOperations.back();
+                FreeOperations.pop_back();
+                buffer = FreeBuffers.back();
+                FreeBuffers.pop_back();
+                Operations[first] = {file, offset + position, block, buffer, false, fsync, false, false, false};
+            }
+            if (fsync != SIZE_MAX) {
+                Operations[fsync] = {file, 0, 0, SIZE_MAX, true, first, false, false, false};
+                (first == SIZE_MAX ? first : second) = fsync;
+            }
+            NumberOfPendingOperations += numberOfOperations;
+            file->mNumberOfSubmitted += numberOfOperations;
+
+            // Other writers may submit while we copy, stop() waits for our pending operations
+            if (block > 0) {
+                lock.unlock();
+                std::memcpy(Memory.data() + buffer * BufferSize, data + position, block);
+                lock.lock();
+            }
+            submit(lock, first, second);
+            position += block;
+        } while (position < size);
+        return true;
+    }
+
+    void AsyncWriter::flush() noexcept {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Recycled.wait(lock, []() { return NumberOfPendingOperations == 0; });
+    }
+
+    size_t AsyncWriter::getNumberOfCompletions() noexcept {
+        return NumberOfCompletions;
+    }
+
+    void AsyncWriter::submit(std::unique_lock<std::mutex> &lock, size_t first, size_t second) noexcept {
+#ifdef EASY_EXCEPTION_IO_URING
+        if (runningBackend == Backend::IoUring) {
+            // We are the only producer, the mutex serializes the submitting threads
+            auto tail = *ring.submissionTail;
+            size_t indices[2];
+            unsigned count = 0;
+            for (auto index : {first, second}) {
+                if (index == SIZE_MAX) {
+                    continue;
+                }
+                auto &operation = Operations[index];
+                auto entry = nextEntry(tail);
+                indices[count++] = index;
+                entry->fd = operation.file->mFileDescriptor;
+                entry->user_data = index;
+                entry->flags = IOSQE_ASYNC;
+                if (operation.sync) {
+                    // A linked fsync runs after its write, a single one after everything submitted before
+                    entry->opcode = IORING_OP_FSYNC;
+                    entry->flags |= second == index ? 0 : IOSQE_IO_DRAIN;
+                    continue;
+                }
+                entry->opcode = ring.registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                entry->addr = reinterpret_cast<uint64_t>(Memory.data() + operation.buffer * BufferSize);
+                entry->len = static_cast<uint32_t>(operation.size);
+                entry->off = operation.offset;
+                entry->buf_index = static_cast<uint16_t>(operation.buffer);
+                if (operation.linked != SIZE_MAX) {
+                    entry->flags |= IOSQE_IO_DRAIN | IOSQE_IO_LINK;
+                }
+            }
+            auto refused = enter(tail, count);
+            if (refused == 0) {
+                return;
+            }
+
+            // Nobody would ever complete the refused operations, so we execute them after the others of their file
+            std::cerr << __PRETTY_FUNCTION__ << ": io_uring refused " << refused << " operations" << std::endl;
+            auto file = Operations[indices[count - refused]].file;
+            Recycled.wait(lock, [&file, refused]() {
+                return file->mNumberOfCompleted + refused == file->mNumberOfSubmitted;
+            });
+            for (auto i = count - refused; i < count; i++) {
+                lock.unlock();
+                complete(indices[i], execute(Operations[indices[i]]));
+                lock.lock();
+            }
+            return;
+        }
+#endif
+        // The queue never holds more than all operations, so it does not allocate
+        for (auto index : {first, second}) {
+            if (index != SIZE_MAX) {
+                Queue.push_back(index);
+            }
+        }
+        Condition.notify_all();
+    }
+
+    bool AsyncWriter::execute(const Operation &operation) noexcept {
+        if (operation.sync) {
+            return ::fsync(operation.file->mFileDescriptor) == 0;
+        }
+        return writeFully(operation.file->mFileDescriptor, Memory.data() + operation.buffer * BufferSize,
+                          operation.size, operation.offset);
+    }
+
+    void AsyncWriter::complete(size_t index, bool result) noexcept {
+        // The file may be closed by the last operation that uses it, we do that after releasing the lock
+        std::shared_ptr<File> file;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            auto &operation = Operations[index];
+            file = std::move(operation.file);
+            file->mFailed = file->mFailed || !result;
+            file->mNumberOfCompleted++;
+            if (!operation.sync && file->mNumberOfRunningWrites > 0) {
+                file->mNumberOfRunningWrites--;
+            }
+            if (operation.buffer != SIZE_MAX) {
+                FreeBuffers.push_back(operation.buffer);
+            }
+            FreeOperations.push_back(index);
+            NumberOfPendingOperations--;
+        }
+        NumberOfCompletions++;
+        Recycled.notify_all();
+    }
+
+}
@@ -0,0 +1,109 @@
+#include <ee/EmergencyReserve.hpp>
+#include <cstdlib>
+#include <algorithm>
+
+namespace ee {
+
+    std::mutex EmergencyReserve::Mutex;
+    void* EmergencyReserve::Chunks[EmergencyReserve::MaxNumberOfChunks] = {};
+    size_t EmergencyReserve::NumberOfChunks = 0;
+    size_t EmergencyReserve::TotalNumberOfChunks = 0;
+    size_t EmergencyReserve::ChunkSize = 0;
+    size_t EmergencyReserve::NumberOfReleases = 0;
+    std::new_handler EmergencyReserve::PreviousHandler = nullptr;
+
+    bool EmergencyReserve::reserve(size_t bytes, size_t numberOfChunks) noexcept {
+        // Drop a previously allocated reserve, that also restores the previous handler
+        release();
+
+        std::lock_guard<std::mutex> mutex(EmergencyReserve::Mutex);
+
+        // Determine the layout of the reserve
+        TotalNumberOfChunks = std::min(std::max<size_t>(numberOfChunks, 1), MaxNumberOfChunks);
+        ChunkSize = bytes / TotalNumberOfChunks;
+        NumberOfReleases = 0;
+        if (ChunkSize == 0) {
+            TotalNumberOfChunks = 0;
+            return false;
+        }
+
+        // We use malloc directly because operator new retries with the same allocator after the handler returns
+        while (NumberOfChunks < TotalNumberOfChunks) {
+            void* chunk = std::malloc(ChunkSize);
+            if (chunk == nullptr) {
+                break;
+            }
+            Chunks[NumberOfChunks++] = chunk;
+        }
+
+        // Install our handler and remember the previous one so we can chain to it
+        PreviousHandler = std::set_new_handler(&EmergencyReserve::newHandler);
+        return NumberOfChunks == TotalNumberOfChunks;
+    }
+
+    bool EmergencyReserve::refill() noexcept {
+        std::lock_guard<std::mutex> mutex(EmergencyReserve::Mutex);
+
+        // Try to get back every chunk that was released
+        while (NumberOfChunks < TotalNumberOfChunks) {
+            void* chunk = std::malloc(ChunkSize);
+            if (chunk == nullptr) {
+                return false;
+            }
+            Chunks[NumberOfChunks++] = chunk;
+        }
+        return true;
+    }
+
+    void EmergencyReserve::release() noexcept {
+        std::lock_guard<std::mutex> mutex(EmergencyReserve::Mutex);
+
+        // Restore the handler only if we installed one
+        if (TotalNumberOfChunks > 0) {
+            std::set_new_handler(PreviousHandler);
+            PreviousHandler = nullptr;
+        }
+
+        // Free all remaining chunks
+        while (NumberOfChunks > 0) {
+            std::free(Chunks[--NumberOfChunks]);
+            Chunks[NumberOfChunks] = nullptr;
+        }
+        TotalNumberOfChunks = 0;
+        ChunkSize = 0;
+    }
+
+    size_t EmergencyReserve::getReservedSize() noexcept {
+        std::lock_guard<std::mutex> mutex(EmergencyReserve::Mutex);
+        return NumberOfChunks * ChunkSize;
+    }
+
+    size_t EmergencyReserve::getNumberOfReleases() noexcept {
+        std::lock_guard<std::mutex> mutex(EmergencyReserve::Mutex);
+        return NumberOfReleases;
+    }
+
+    void EmergencyReserve::newHandler() {
+        std::new_handler previousHandler;
+        {
+            std::lock_guard<std::mutex> mutex(EmergencyReserve::Mutex);
+
+            // Hand one chunk back to the heap, operator new will then retry the allocation
+            if (NumberOfChunks > 0) {
+                std::free(Chunks[--NumberOfChunks]);
+                Chunks[NumberOfChunks] = nullptr;
+                NumberOfReleases++;
+                return;
+            }
+            previousHandler = PreviousHandler;
+        }
+
+        // The reserve is exhausted, so we behave like there was no handler of ours
+        if (previousHandler != nullptr) {
+            previousHandler();
+        } else {
+            throw std::bad_alloc();
+        }
+    }
+
+}
@@ -0,0 +1,251 @@
+#include <ee/FileSink.hpp>
+#include <ee/LogDurability.hpp>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+namespace ee {
+
+    std::mutex FileSink::Mutex;
+    std::map<std::string, std::shared_ptr<FileSink>> FileSink::Sinks;
+
+    FileSink::FileSink(std::string filename) noexcept : mFilename(std::move(filename)) {}
+
+    FileSink::~FileSink() noexcept {
+        this->close();
+    }
+
+    std::shared_ptr<FileSink> FileSink::get(const std::string &filename) noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        try {
+            auto it = Sinks.find(filename);
+            if (it != Sinks.end()) {
+                return it->second;
+            }
+
+            // Only sinks nobody else uses right now are evicted
+            if (Sinks.size() >= MaxNumberOfSinks) {
+                for (auto sink = Sinks.begin(); sink != Sinks.end();) {
+                    sink = sink->second.use_count() == 1 ? Sinks.erase(sink) : std::next(sink);
+                }
+            }
+            auto sink = std::make_shared<FileSink>(filename);
+            Sinks.emplace(filename, sink);
+            return sink;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    void FileSink::closeAll() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        for (auto &sink : Sinks) {
+            std::lock_guard<std::mutex> sinkLock(sink.second->getMutex());
+            sink.second->close();
+        }
+        Sinks.clear();
+    }
+
+    void FileSink::release(const std::string &filename) noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        auto sink = Sinks.find(filename);
+        if (sink == Sinks.end()) {
+            return;
+        }
+
+        // A writer that still holds the sink finishes its block before we close the file
+        std::lock_guard<std::mutex> sinkLock(sink->second->getMutex());
+        sink->second->close();
+        Sinks.erase(sink);
+    }
+
+    bool FileSink::open() noexcept {
+        if (this->mFileDescriptor >= 0) {
+            // A single stat tells us whether the file has been removed or replaced since we opened it
+            struct stat path{}, descriptor{};
+            if (::stat(this->mFilename.c_str(), &path) == 0 && ::fstat(this->mFileDescriptor, &descriptor) == 0 &&
+                path.st_dev == descriptor.st_dev && path.st_ino == descriptor.st_ino) {
+                return true;
+            }
+            this->close();
+        }
+
+        // Blocks written in the background may complete in any order, so they need explicit offsets instead of appending
+        bool background = AsyncWriter::getBackend() != AsyncWriter::Backend::None;
+        int flags = O_WRONLY | (background ? 0 : O_APPEND) | O_CREAT | O_CLOEXEC;
+
+        // The durability needs to know whether we created the file, its folder has to be synced then
+        this->mFileDescriptor = ::open(this->mFilename.c_str(), flags | O_EXCL, 0644);
+        this->mCreated = this->mFileDescriptor >= 0;
+        if (this->mFileDescriptor < 0 && errno == EEXIST) {
+            this->mFileDescriptor = ::open(this->mFilename.c_str(), flags, 0644);
+        }
+        if (this->mFileDescriptor < 0) {
+            return false;
+        }
+        struct stat status{};
+        bool known = ::fstat(this->mFileDescriptor, &status) == 0;
+        this->mOffset = known ? static_cast<uint64_t>(status.st_size) : 0;
+        if (background && known) {
+            try {
+                this->mFile = std::make_shared<AsyncWriter::File>(this->mFileDescriptor);
+            } catch (...) {
+                // We write on the calling thread instead
+            }
+        }
+        if (background && !this->mFile) {
+            ::fcntl(this->mFileDescriptor, F_SETFL, O_APPEND);
+        }
+        try {
+            this->mBuffer.reserve(BufferSize);
+        } catch (...) {
+            // The buffer grows while formatting
+        }
+        return true;
+    }
+
+    void FileSink::close() noexcept {
+        if (this->mFileDescriptor < 0) {
+            return;
+        }
+        this->flush();
+        if (this->mFile) {
+            // The file closes its descriptor once the last write that uses it completed
+            this->mFile->wait();
+            this->mFile.reset();
+        } else {
+            ::close(this->mFileDescriptor);
+        }
+        this->mFileDescriptor = -1;
+    }
+
+    bool FileSink::isOpen() const noexcept {
+        return this->mFileDescriptor >= 0;
+    }
+
+    std::string &FileSink::getBuffer() noexcept {
+        return this->mBuffer;
+    }
+
+    bool FileSink::commit() noexcept {
+        if (this->mBuffer.size() < BufferSize) {
+            return true;
+        }
+        return this->writeBuffer(nullptr, 0);
+    }
+
+    bool FileSink::write(const char *data, size_t size) noexcept {
+        // Small blocks are collected, a large block is not worth copying
+        if (this->mBuffer.size() + size < BufferSize) {
+            try {
+                this->mBuffer.append(data, size);
+                return true;
+            } catch (...) {
+                // We write the block directly
+            }
+        }
+        return this->writeBuffer(data, size);
+    }
+
+    bool FileSink::flush() noexcept {
+        if (this->mBuffer.empty()) {
+            return true;
+        }
+        return this->writeBuffer(nullptr, 0);
+    }
+
+    bool FileSink::sync() noexcept {
+        return this->writeBuffer(nullptr, 0, true);
+    }
+
+    bool FileSink::wait() noexcept {
+        return !this->mFile || this->mFile->wait();
+    }
+
+    uint64_t FileSink::getPosition() const noexcept {
+        return this->mOffset + this->mBuffer.size();
+    }
+
+    std::mutex &FileSink::getMutex() noexcept {
+        return this->mMutex;
+    }
+
+    const std::string &FileSink::getFilename() const noexcept {
+        return this->mFilename;
+    }
+
+    size_t FileSink::getNumberOfWrites() const noexcept {
+        return this->mNumberOfWrites;
+    }
+
+    bool FileSink::writeBuffer(const char *data, size_t size, bool sync) noexcept {
+        if (this->mFileDescriptor < 0 && !this->open()) {
+            this->mBuffer.clear();
+            return false;
+        }
+
+        // The asynchronous writer copies the bytes, so the buffer can be reused right away
+        if (this->mFile) {
+            bool withData = data != nullptr && size > 0;
+            bool result = AsyncWriter::write(this->mFile, this->mBuffer.data(), this->mBuffer.size(), this->mOffset,
+                                             sync && !withData);
+            this->mOffset += this->mBuffer.size();
+            if (withData) {
+                result = AsyncWriter::write(this->mFile, data, size, this->mOffset, sync) && result;
+                this->mOffset += size;
+            }
+            this->mNumberOfWrites++;
+            this->mBuffer.clear();
+            LogDurability::markDirty(this->mFilename, this->mCreated);
+            this->mCreated = false;
+            return result;
+        }
+
+        // The buffer and the block are written with a single call unless the kernel takes only a part of them
+        iovec vectors[2] = {
+                {const_cast<char *>(this->mBuffer.data()), this->mBuffer.size()},
+                {const_cast<char *>(data), size}
+        };
+        int first = 0;
+        int count = data != nullptr && size > 0 ? 2 : 1;
+        while (first < count && vectors[first].iov_len == 0) {
+            first++;
+        }
+        bool result = true;
+        while (first < count) {
+            auto written = ::writev(this->mFileDescriptor, vectors + first, count - first);
+            this->mNumberOfWrites++;
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                result = false;
+                break;
+            }
+            auto remaining = static_cast<size_t>(written);
+            while (first < count && remaining >= vectors[first].iov_len) {
+                remaining -= vectors[first].iov_len;
+                first++;
+            }
+            if (first < count) {
+                vectors[first].iov_base = static_cast<char *>(vectors[first].iov_base) + remaining;
+                vectors[first].iov_len -= remaining;
+            }
+        }
+
+        // A failed write drops the bytes, the next incident must not repeat them
+        struct stat status{};
+        if (result) {
+            this->mOffset += this->mBuffer.size() + (data != nullptr ? size : 0);
+        } else if (::fstat(this->mFileDescriptor, &status) == 0) {
+            this->mOffset = static_cast<uint64_t>(status.st_size);
+        }
+        this->mBuffer.clear();
+        LogDurability::markDirty(this->mFilename, this->mCreated);
+        this->mCreated = false;
+        return result && (!sync || ::fsync(this->mFileDescriptor) == 0);
+    }
+
+}
@@ -0,0 +1,358 @@
+#include <ee/FlightRecorder.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/LogCodec.hpp>
+#include <ee/LogMerge.hpp>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ee {
+
+    std::mutex FlightRecorder::Mutex;
+    std::atomic_bool FlightRecorder::Open = false;
+    std::atomic_size_t FlightRecorder::Generation = 0;
+    std::atomic_size_t FlightRecorder::NextSlot = 0;
+    std::string FlightRecorder::Filename;
+    char *FlightRecorder::Mapping = nullptr;
+    size_t FlightRecorder::MappingSize = 0;
+    size_t FlightRecorder::SlotSize = 0;
+    size_t FlightRecorder::NumberOfSlots = 0;
+    std::atomic_size_t FlightRecorder::NumberOfRecordedLogEntries = 0;
+
+    /**
+     * @brief The magic bytes at the beginning of the file.
+     */
+    static const char magic[8] = {'E', 'E', 'F', 'L', 'I', 'G', 'H', 'T'};
+
+    /**
+     * @brief The number of bytes of the length in front of every record.
+     */
+    static constexpr size_t lengthSize = sizeof(uint32_t);
+
+    /**
+     * @brief The length that marks the unused rest of a ring, the next record starts at the beginning.
+     */
+    static constexpr uint32_t wrapMarker = UINT32_MAX;
+
+    /**
+     * @brief Marks the slots whose thread is recording right now, so close() can wait for them.
+     */
+    struct alignas(64) SlotState {
+        std::atomic_bool busy{false};
+    };
+    static SlotState slotStates[FlightRecorder::MaxNumberOfSlots];
+
+    /**
+     * @brief Ensures the recorder is closed at exit only once.
+     */
+    static std::once_flag atExitFlag;
+
+    /**
+     * @brief Reads a number of the mapped file.
+     *
+     * @param data The first byte of the number.
+     * @return The number.
+     */
+    static uint64_t load(const char *data) noexcept {
+        uint64_t value = 0;
+        std::memcpy(&value, data, sizeof(uint64_t));
+        return value;
+    }
+
+    /**
+     * @brief Writes a number into the mapped file.
+     *
+     * @param data The first byte of the number.
+     * @param value The number.
+     */
+    static void store(char *data, uint64_t value) noexcept {
+        std::memcpy(data, &value, sizeof(uint64_t));
+    }
+
+    /**
+     * @brief Appends a record to the ring of a slot, the oldest records are overwritten if necessary.
+     *
+     * The head is stored after the record, so a process that dies in between leaves a consistent ring.
+     * @param slot The first byte of the slot header.
+     * @param ring The number of bytes of the ring.
+     * @param record The length prefixed record.
+     */
+    static void append(char *slot, size_t ring, const std::string &record) noexcept {
+        auto data = slot + FlightRecorder::HeaderSize;
+        uint64_t head = load(slot + 8);
+        uint64_t tail = load(slot + 16);
+
+        // A record never crosses the end of the ring
+        auto untilEnd = ring - head % ring;
+        auto needed = record.size() <= untilEnd ? record.size() : untilEnd + record.size();
+
+        // Drop the oldest records until the new one fits
+        while (head + needed - tail > ring) {
+            auto tailUntilEnd = ring - tail % ring;
+            uint32_t length = 0;
+            if (tailUntilEnd >= lengthSize) {
+                std::memcpy(&length, data + tail % ring, lengthSize);
+            }
+            tail += tailUntilEnd < lengthSize || length == wrapMarker ? tailUntilEnd : lengthSize + length;
+        }
+        store(slot + 16, tail);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (record.size() > untilEnd) {
+            if (untilEnd >= lengthSize) {
+                std::memcpy(data + head % ring, &wrapMarker, lengthSize);
+            }
+            head += untilEnd;
+        }
+        std::memcpy(data + head % ring, record.data(), record.size());
+        std::atomic_thread_fence(std::memory_order_release);
+        store(slot + 8, head + record.size());
+    }
+
+    bool FlightRecorder::open(const std::string &filename, size_t slotSize, size_t numberOfSlots) noexcept {
+        close();
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            slotSize = (std::max(slotSize, MinSlotSize) + 7) & ~static_cast<size_t>(7);
+            numberOfSlots = std::clamp<size_t>(numberOfSlots, 1, MaxNumberOfSlots);
+            auto size = HeaderSize + numberOfSlots * (HeaderSize + slotSize);
+
+            int fileDescriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fileDescriptor < 0) {
+                return false;
+            }
+            if (::ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0) {
+                ::close(fileDescriptor);
+                ::unlink(filename.c_str());
+                return false;
+            }
+
+            // The mapping keeps the file alive, the descriptor is not needed anymore
+            auto mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+            ::close(fileDescriptor);
+            if (mapping == MAP_FAILED) {
+                ::unlink(filename.c_str());
+                return false;
+            }
+
+            try {
+                Filename = filename;
+            } catch (...) {
+                ::munmap(mapping, size);
+                ::unlink(filename.c_str());
+                return false;
+            }
+            Mapping = static_cast<char *>(mapping);
+            MappingSize = size;
+            SlotSize = slotSize;
+            NumberOfSlots = numberOfSlots;
+            std::memcpy(Mapping, magic, sizeof(magic));
+            store(Mapping + 8, slotSize);
+            store(Mapping + 16, numberOfSlots);
+
+            NextSlot = 0;
+            Generation++;
+            Open = true;
+        }
+
+        // A process that ends normally leaves no file behind
+        try {
+            std::call_once(atExitFlag, []() {
+                std::atexit([]() {
+                    FlightRecorder::close();
+                });
+            });
+        } catch (...) {
+            // The file survives the exit and is recovered at the next start
+        }
+        return true;
+    }
+
+    void FlightRecorder::close() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (!Open) {
+            return;
+        }
+        Open = false;
+
+        // The threads that passed the check before have to finish their record
+        for (size_t i = 0; i < NumberOfSlots; i++) {
+            while (slotStates[i].busy) {
+                std::this_thread::yield();
+            }
+        }
+
+        ::munmap(Mapping, MappingSize);
+        ::unlink(Filename.c_str());
+        Mapping = nullptr;
+        MappingSize = 0;
+        Filename.clear();
+    }
+
+    bool FlightRecorder::isOpen() noexcept {
+        return Open;
+    }
+
+    void FlightRecorder::record(const LogEntry &logEntry) noexcept {
+        if (!Open.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // Every thread claims its own slot once per file
+        thread_local size_t generation = 0;
+        thread_local size_t slot = SIZE_MAX;
+        thread_local const size_t threadHash = std::hash<std::thread::id>()(std::this_thread::get_id());
+        auto currentGeneration = Generation.load();
+        if (generation != currentGeneration) {
+            generation = currentGeneration;
+            slot = NextSlot++;
+        }
+        if (slot >= MaxNumberOfSlots) {
+            return;
+        }
+
+        // close() sets the flag first and waits for us afterwards, so the mapping stays valid until we are done
+        auto &busy = slotStates[slot].busy;
+        busy = true;
+        if (!Open || generation != Generation || slot >= NumberOfSlots) {
+            busy.store(false, std::memory_order_release);
+            return;
+        }
+
+        try {
+            thread_local std::string record;
+            record.assign(lengthSize, '\0');
+            LogCodec::encode(record, logEntry, threadHash);
+            auto length = static_cast<uint32_t>(record.size() - lengthSize);
+            std::memcpy(&record[0], &length, lengthSize);
+
+            // A record that takes more than half of the ring would displace everything else
+            if (record.size() <= SlotSize / 2) {
+                auto slotHeader = Mapping + HeaderSize + slot * (HeaderSize + SlotSize);
+                if (load(slotHeader + 24) == 0) {
+                    store(slotHeader, threadHash);
+                    store(slotHeader + 24, 1);
+                }
+                append(slotHeader, SlotSize, record);
+                NumberOfRecordedLogEntries++;
+            }
+        } catch (...) {
+            // We could not encode the log entry
+        }
+        busy.store(false, std::memory_order_release);
+    }
+
+    size_t FlightRecorder::recover(const std::string &filename, const std::string &logFilename) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Open && Filename == filename) {
+                return 0;
+            }
+        }
+
+        int fileDescriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return 0;
+        }
+        struct stat status{};
+        if (::fstat(fileDescriptor, &status) != 0 || static_cast<size_t>(status.st_size) < HeaderSize) {
+            ::close(fileDescriptor);
+            return 0;
+        }
+        auto size = static_cast<size_t>(status.st_size);
+        auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        ::close(fileDescriptor);
+        if (mapping == MAP_FAILED) {
+            return 0;
+        }
+        auto file = static_cast<const char *>(mapping);
+
+        LogMerge::SpilledLogEntries logEntries;
+        try {
+            auto slotSize = load(file + 8);
+            auto numberOfSlots = load(file + 16);
+            if (std::memcmp(file, magic, sizeof(magic)) == 0 && slotSize >= MinSlotSize &&
+                numberOfSlots <= MaxNumberOfSlots && size == HeaderSize + numberOfSlots * (HeaderSize + slotSize)) {
+                for (uint64_t i = 0; i < numberOfSlots; i++) {
+                    auto slot = file + HeaderSize + i * (HeaderSize + slotSize);
+                    auto data = slot + HeaderSize;
+                    uint64_t head = load(slot + 8);
+                    uint64_t position = load(slot + 16);
+                    if (load(slot + 24) == 0 || head < position || head - position > slotSize) {
+                        continue;
+                    }
+
+                    // Records of the same thread share their stacktraces again
+                    size_t first = logEntries.size();
+                    while (position < head) {
+                        auto untilEnd = slotSize - position % slotSize;
+                        uint32_t length = 0;
+                        if (untilEnd >= lengthSize) {
+                            std::memcpy(&length, data + position % slotSize, lengthSize);
+                        }
+                        if (untilEnd < lengthSize || length == wrapMarker) {
+                            position += untilEnd;
+                            continue;
+                        }
+                        if (lengthSize + length > untilEnd || position + lengthSize + length > head) {
+                            // The rest of the ring is damaged
+                            break;
+                        }
+                        size_t threadHash = 0;
+                        auto logEntry = LogCodec::decode(data + position % slotSize + lengthSize, length, threadHash,
+                                logEntries.size() > first ? &logEntries.back().second : nullptr);
+                        if (logEntry.has_value()) {
+                            logEntries.emplace_back(threadHash, std::move(logEntry.value()));
+                        }
+                        position += lengthSize + length;
+                    }
+                }
+            }
+        } catch (...) {
+            // We write what we could read so far
+        }
+        ::munmap(mapping, size);
+
+        // The threads are merged into a single chronological stream
+        std::stable_sort(logEntries.begin(), logEntries.end(), [](const auto &a, const auto &b) {
+            if (a.second.getDateOfCreation() != b.second.getDateOfCreation()) {
+                return a.second.getDateOfCreation() < b.second.getDateOfCreation();
+            }
+            return a.second.getSequenceNumber() < b.second.getSequenceNumber();
+        });
+        if (!logEntries.empty()) {
+            auto sink = FileSink::get(logFilename);
+            if (!sink) {
+                return 0;
+            }
+            std::lock_guard<std::mutex> lock(sink->getMutex());
+            try {
+                if (!sink->open()) {
+                    return 0;
+                }
+                std::map<std::thread::id, LogBuffer> noThreads;
+                LogMerge merge(noThreads, &logEntries);
+                merge.write(*sink, EASY_EXCEPTION_OUTPUT_FORMAT);
+            } catch (...) {
+                // We keep what has been written so far
+            }
+            // The rings are only given up once the background writes reached the file
+            if (!sink->flush() || !sink->wait()) {
+                return 0;
+            }
+        }
+
+        // The rings are converted, the next start must not convert them again
+        ::unlink(filename.c_str());
+        return logEntries.size();
+    }
+
+    size_t FlightRecorder::getNumberOfRecordedLogEntries() noexcept {
+        return NumberOfRecordedLogEntries;
+    }
+
+}
@@ -0,0 +1,460 @@
+#include <ee/Formatter.hpp>
+#include <charconv>
+#include <typeinfo>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ee {
+
+    std::atomic<Formatter::Timezone> Formatter::CurrentTimezone = Formatter::Timezone::Local;
+
+    /**
+     * @brief The formatted date and time of the latest second a thread formatted.
+     */
+    struct TimestampCache {
+        int64_t second = INT64_MIN;
+        Formatter::Timezone timezone = Formatter::Timezone::Utc;
+        char prefix[32];
+        size_t prefixLength = 0;
+        char suffix[8];
+        size_t suffixLength = 0;
+    };
+
+    /**
+     * @brief Appends the given number with the given number of digits and leading zeros.
+     *
+     * @param buffer The buffer to write into.
+     * @param number The number.
+     * @param digits The number of digits.
+     */
+    inline void appendDigits(char *buffer, uint32_t number, size_t digits) noexcept {
+        for (size_t i = digits; i > 0; i--) {
+            buffer[i - 1] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        }
+    }
+
+    /**
+     * @brief Searches for the first character that has to be escaped inside a json string.
+     *
+     * Quotes, backslashes and control characters have to be escaped. We compare 32 (AVX2) or 16 (SSE2) bytes at once
+     * and only fall back to single bytes for the tail.
+     * @param data The characters to search.
+     * @param length The number of characters.
+     * @return The index of the first character to escape or length if there is none.
+     */
+    inline size_t findJsonEscape(const char* data, size_t length) noexcept {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i quote32 = _mm256_set1_epi8('"');
+        const __m256i backslash32 = _mm256_set1_epi8('\\');
+        const __m256i control32 = _mm256_set1_epi8(0x1F);
+        for (; i + 32 <= length; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i matches = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32)),
+                    _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control32), control32));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+            if (mask != 0) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= length; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i matches = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                    _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+            if (mask != 0) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+#endif
+        for (; i < length; i++) {
+            auto c = static_cast<unsigned char>(data[i]);
+            if (c == '"' || c == '\\' || c < 0x20) {
+                return i;
+            }
+        }
+        return length;
+    }
+
+    /**
+     * @brief Appends the given notes as json array.
+     *
+     * @param buffer The buffer to append to.
+     * @param notes The notes to append.
+     */
+    inline void writeJsonNotes(std::string& buffer, const std::vector<Note>& notes) {
+        buffer += '[';
+        for (size_t i = 0; i < notes.size(); i++) {
+            if (i > 0) {
+                buffer += ',';
+            }
+            buffer += "{\"name\":";
+            Formatter::appendJsonString(buffer, notes[i].getName());
+            buffer += ",\"value\":";
+            Formatter::appendJsonString(buffer, notes[i].getValue());
+            buffer += ",\"caller\":";
+            if (notes[i].getCaller().empty()) {
+                buffer += "null";
+            } else {
+                Formatter::appendJsonString(buffer, notes[i].getCaller());
+            }
+            buffer += '}';
+        }
+        buffer += ']';
+    }
+
+    void Formatter::write(std::string &buffer, const LogEntry &logEntry, OutputFormat format) {
+        write(buffer, logEntry, format, nullptr);
+    }
+
+    void Formatter::write(
+            std::string &buffer,
+            const LogEntry &logEntry,
+            OutputFormat format,
+            const std::thread::id *threadId) {
+        if (threadId != nullptr) {
+            write(buffer, logEntry, format, std::hash<std::thread::id>()(*threadId));
+        } else {
+            writeLogEntry(buffer, logEntry, format, nullptr);
+        }
+    }
+
+    void Formatter::write(std::string &buffer, const LogEntry &logEntry, OutputFormat format, size_t threadHash) {
+        writeLogEntry(buffer, logEntry, format, &threadHash);
+    }
+
+    void Formatter::writeLogEntry(
+            std::string &buffer,
+            const LogEntry &logEntry,
+            OutputFormat format,
+            const size_t *threadHash) {
+        switch (format) {
+            default:
+            case String: {
+                // Write first line
+                buffer += toString(logEntry.getLogLevel());
+                buffer += " [";
+                appendTimestamp(buffer, logEntry.getDateOfCreation());
+                buffer += "] ";
+                if (threadHash != nullptr) {
+                    buffer += '<';
+                    appendNumber(buffer, *threadHash);
+                    buffer += "> ";
+                }
+                buffer += logEntry.getMessage();
+                if (!logEntry.getClassname().empty()) {
+                    buffer += " ::";
+                    buffer += logEntry.getClassname();
+                    buffer += "::";
+                }
+                if (!logEntry.getMethod().empty()) {
+                    buffer += " --> ";
+                    buffer += logEntry.getMethod();
+                }
+                buffer += '\n';
+
+                // Write the next lines of notes
+                for (auto &note : logEntry.getNotes()) {
+                    buffer += '\t';
+                    buffer += note.getName();
+                    buffer += ": ";
+                    buffer += note.getValue();
+                    if (!note.getCaller().empty()) {
+                        buffer += " --> ";
+                        buffer += note.getCaller();
+                    }
+                    buffer += '\n';
+                }
+
+                // Write the stacktrace
+                if (logEntry.getStacktrace().has_value()) {
+                    buffer += "Stacktrace:\n";
+                    write(buffer, *logEntry.getStacktrace()->get());
+                }
+            } break;
+
+            case Json: {
+                buffer += "{\"level\":\"";
+                buffer += toString(logEntry.getLogLevel());
+                buffer += "\",\"datetime\":\"";
+                appendTimestamp(buffer, logEntry.getDateOfCreation());
+                buffer += '"';
+                if (threadHash != nullptr) {
+                    buffer += ",\"thread\":";
+                    appendNumber(buffer, *threadHash);
+                }
+                if (!logEntry.getClassname().empty()) {
+                    buffer += ",\"class\":";
+                    appendJsonString(buffer, logEntry.getClassname());
+                }
+                if (!logEntry.getMethod().empty()) {
+                    buffer += ",\"method\":";
+                    appendJsonString(buffer, logEntry.getMethod());
+                }
+                if (!logEntry.getMessage().empty()) {
+                    buffer += ",\"message\":";
+                    appendJsonString(buffer, logEntry.getMessage());
+                }
+                if (!logEntry.getNotes().empty()) {
+                    buffer += ",\"notes\":";
+                    writeJsonNotes(buffer, logEntry.getNotes());
+                }
+                if (logEntry.getStacktrace().has_value()
+                    && !logEntry.getStacktrace()->get()->getLines().empty()) {
+                    buffer += ",\"stacktrace\":";
+                    write(buffer, *logEntry.getStacktrace()->get(), OutputFormat::Json);
+                }
+                buffer += '}';
+            } break;
+        }
+    }
+
+    void Formatter::write(std::string &buffer, const Exception &exception, OutputFormat format) {
+        switch (format) {
+            default:
+            case String: {
+                buffer += "Exception type:\n\t";
+                buffer += typeid(exception).name();
+                buffer += "\nDatetime:\n\t";
+                appendTimestamp(buffer, exception.getDateOfCreation());
+                buffer += '\n';
+                if (!exception.getCaller().empty()) {
+                    buffer += "In method:\n\t";
+                    buffer += exception.getCaller();
+                    buffer += '\n';
+                }
+                if (!exception.getMessage().empty()) {
+                    buffer += "With message:\n\t";
+                    buffer += exception.getMessage();
+                    buffer += '\n';
+                }
+                for (const auto &info : exception.getNotes()) {
+                    buffer += info.getName();
+                    if (!info.getCaller().empty()) {
+                        buffer += " { ";
+                        buffer += info.getCaller();
+                        buffer += " }";
+                    }
+                    buffer += ":\n\t";
+                    buffer += info.getValue();
+                    buffer += '\n';
+                }
+                if (exception.getStacktrace().has_value()
+                    && !exception.getStacktrace()->get()->getLines().empty()) {
+                    buffer += "Stacktrace:\n";
+                    write(buffer, *exception.getStacktrace()->get());
+                }
+            } break;
+
+            case Json: {
+                buffer += "{\"type\":";
+                appendJsonString(buffer, typeid(exception).name());
+                buffer += ",\"datetime\":\"";
+                appendTimestamp(buffer, exception.getDateOfCreation());
+                buffer += '"';
+                if (!exception.getCaller().empty()) {
+                    buffer += ",\"method\":";
+                    appendJsonString(buffer, exception.getCaller());
+                }
+                if (!exception.getMessage().empty()) {
+                    buffer += ",\"message\":";
+                    appendJsonString(buffer, exception.getMessage());
+                }
+                if (!exception.getNotes().empty()) {
+                    buffer += ",\"infos\":";
+                    writeJsonNotes(buffer, exception.getNotes());
+                }
+                if (exception.getStacktrace().has_value()
+                    && !exception.getStacktrace()->get()->getLines().empty()) {
+                    buffer += ",\"stacktrace\":";
+                    write(buffer, *exception.getStacktrace()->get(), OutputFormat::Json);
+                }
+                buffer += '}';
+            } break;
+        }
+    }
+
+    void Formatter::write(std::string &buffer, const Stacktrace &stacktrace, OutputFormat format) {
+        switch (format) {
+            default:
+            case String: {
+                for (auto &line : stacktrace.getLines()) {
+                    buffer += '[';
+                    appendNumber(buffer, line.first);
+                    buffer += "] ";
+                    buffer += line.second;
+                    buffer += '\n';
+                }
+            } break;
+
+            case Json: {
+                buffer += '[';
+                bool first = true;
+                for (const auto &line : stacktrace.getLines()) {
+                    if (!first) {
+                        buffer += ',';
+                    }
+                    first = false;
+                    appendJsonString(buffer, line.second);
+                }
+                buffer += ']';
+            } break;
+        }
+    }
+
+    void Formatter::writeThreadHeadline(std::string &buffer, const std::thread::id &threadId) {
+        // The thread is named like the output operator of std::thread::id does, the headline is written rarely
+        std::ostringstream stream;
+        stream << threadId;
+        buffer.append(32, '#');
+        buffer += "### ";
+        buffer += stream.str();
+        buffer += ' ';
+        buffer.append(32, '#');
+        buffer += '\n';
+    }
+
+    void Formatter::writeThreadHeadline(std::string &buffer, size_t threadHash) {
+        buffer.append(32, '#');
+        buffer += "### ";
+        appendNumber(buffer, threadHash);
+        buffer += ' ';
+        buffer.append(32, '#');
+        buffer += '\n';
+    }
+
+    void Formatter::appendJsonString(std::string &buffer, const char *data, size_t length) {
+        static const char* hex = "0123456789abcdef";
+        buffer += '"';
+        while (length > 0) {
+            // Copy the run of characters that need no escaping at once
+            auto clean = findJsonEscape(data, length);
+            buffer.append(data, clean);
+            data += clean;
+            length -= clean;
+            if (length == 0) {
+                break;
+            }
+
+            // Escape a single character
+            auto c = static_cast<unsigned char>(*data);
+            switch (c) {
+                case '"': buffer += "\\\""; break;
+                case '\\': buffer += "\\\\"; break;
+                case '\n': buffer += "\\n"; break;
+                case '\r': buffer += "\\r"; break;
+                case '\t': buffer += "\\t"; break;
+                case '\b': buffer += "\\b"; break;
+                case '\f': buffer += "\\f"; break;
+                default: {
+                    char escaped[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F]};
+                    buffer.append(escaped, sizeof(escaped));
+                } break;
+            }
+            data++;
+            length--;
+        }
+        buffer += '"';
+    }
+
+    void Formatter::appendJsonString(std::string &buffer, const std::string &string) {
+        appendJsonString(buffer, string.data(), string.size());
+    }
+
+    void Formatter::appendJsonString(std::string &buffer, const char *string) {
+        appendJsonString(buffer, string, std::strlen(string));
+    }
+
+    void Formatter::appendNumber(std::string &buffer, uint64_t number) {
+        char digits[20];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        buffer.append(digits, result.ptr);
+    }
+
+    void Formatter::appendDatetime(
+            std::string &buffer,
+            const std::chrono::system_clock::time_point &timepoint,
+            const char *pattern) {
+        // Convert into local time using the thread-safe variant
+        auto time = std::chrono::system_clock::to_time_t(timepoint);
+        std::tm tm{};
+        if (localtime_r(&time, &tm) == nullptr) {
+            return;
+        }
+
+        // Format directly on the stack
+        char datetime[64];
+        auto length = std::strftime(datetime, sizeof(datetime), pattern, &tm);
+        buffer.append(datetime, length);
+    }
+
+    void Formatter::appendTimestamp(std::string &buffer, const std::chrono::system_clock::time_point &timepoint) {
+        // The fraction of a time point before the epoch counts upwards from the previous full second
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(timepoint.time_since_epoch()).count();
+        auto second = microseconds / 1000000;
+        auto fraction = microseconds % 1000000;
+        if (fraction < 0) {
+            second--;
+            fraction += 1000000;
+        }
+
+        // Converting the date is only necessary once per second and thread
+        thread_local TimestampCache cache;
+        auto timezone = CurrentTimezone.load(std::memory_order_relaxed);
+        if (cache.second != second || cache.timezone != timezone) {
+            auto time = static_cast<std::time_t>(second);
+            std::tm tm{};
+            if ((timezone == Timezone::Utc ? gmtime_r(&time, &tm) : localtime_r(&time, &tm)) == nullptr) {
+                return;
+            }
+            cache.prefixLength = std::strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%dT%H:%M:%S", &tm);
+            if (timezone == Timezone::Utc) {
+                cache.suffix[0] = 'Z';
+                cache.suffixLength = 1;
+            } else {
+                auto offset = tm.tm_gmtoff;
+                cache.suffix[0] = offset < 0 ? '-' : '+';
+                offset = offset < 0 ? -offset : offset;
+                appendDigits(cache.suffix + 1, static_cast<uint32_t>(offset / 3600), 2);
+                cache.suffix[3] = ':';
+                appendDigits(cache.suffix + 4, static_cast<uint32_t>(offset / 60 % 60), 2);
+                cache.suffixLength = 6;
+            }
+            cache.second = second;
+            cache.timezone = timezone;
+        }
+
+        char timestamp[sizeof(cache.prefix) + 8 + sizeof(cache.suffix)];
+        std::memcpy(timestamp, cache.prefix, cache.prefixLength);
+        auto length = cache.prefixLength;
+        timestamp[length++] = '.';
+        appendDigits(timestamp + length, static_cast<uint32_t>(fraction), 6);
+        length += 6;
+        std::memcpy(timestamp + length, cache.suffix, cache.suffixLength);
+        buffer.append(timestamp, length + cache.suffixLength);
+    }
+
+    void Formatter::setTimezone(Timezone timezone) noexcept {
+        CurrentTimezone = timezone;
+    }
+
+    Formatter::Timezone Formatter::getTimezone() noexcept {
+        return CurrentTimezone;
+    }
+
+}
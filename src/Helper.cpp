@@ -27,4 +27,10 @@ namespace ee {
         return result;
     }
 
+    size_t Helper::getNumberOfBytes(const std::string &string) noexcept {
+        // The capacity of an empty string is the capacity of the small string buffer
+        static const size_t smallStringCapacity = std::string().capacity();
+        return string.capacity() > smallStringCapacity ? string.capacity() + 1 : 0;
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <ee/IncidentCoordinator.hpp>
+#include <ee/Log.hpp>
+#include <cstdlib>
+
+namespace ee {
+
+    std::mutex IncidentCoordinator::Mutex;
+    std::condition_variable IncidentCoordinator::Condition;
+    std::thread IncidentCoordinator::Thread;
+    bool IncidentCoordinator::Running = false;
+    bool IncidentCoordinator::Pending = false;
+    std::chrono::steady_clock::time_point IncidentCoordinator::FirstTrigger;
+    std::chrono::steady_clock::time_point IncidentCoordinator::LastTrigger;
+    std::chrono::milliseconds IncidentCoordinator::QuietPeriod = std::chrono::milliseconds::zero();
+    std::chrono::milliseconds IncidentCoordinator::MaxDelay = std::chrono::milliseconds::zero();
+    std::chrono::milliseconds IncidentCoordinator::Tail = std::chrono::milliseconds::zero();
+    std::atomic_size_t IncidentCoordinator::NumberOfIncidents = 0;
+
+    /**
+     * @brief Only one incident is written at a time, a fatal log entry may race with the coordinator thread.
+     */
+    static std::mutex writeMutex;
+
+    /**
+     * @brief Ensures the coordinator is stopped at exit only once.
+     */
+    static std::once_flag atExitFlag;
+
+    void IncidentCoordinator::start(
+            const std::chrono::milliseconds &quietPeriod,
+            const std::chrono::milliseconds &maxDelay,
+            const std::chrono::milliseconds &tail) noexcept {
+        stop();
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Thread.joinable()) {
+                // Another caller started the coordinator meanwhile
+                return;
+            }
+            QuietPeriod = quietPeriod;
+            MaxDelay = maxDelay;
+            Tail = tail;
+            Running = true;
+            try {
+                Thread = std::thread([]() {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    while (Running) {
+                        if (!Pending) {
+                            Condition.wait(lock, []() { return !Running || Pending; });
+                            continue;
+                        }
+
+                        // Further warnings only move the deadline back, so we check it again after waking up
+                        if (Condition.wait_until(lock, getDeadline(), []() { return !Running; })) {
+                            break;
+                        }
+                        if (!Pending || std::chrono::steady_clock::now() < getDeadline()) {
+                            continue;
+                        }
+
+                        // The incident is written without holding our lock, so warnings never wait for the file
+                        Pending = false;
+                        lock.unlock();
+                        write(false);
+                        lock.lock();
+                    }
+                });
+            } catch (...) {
+                // The system could not create another thread, every warning writes its incident immediately
+                Running = false;
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not start incident coordinator" << std::endl;
+                return;
+            }
+        }
+
+        // The statics of the logging are created before the program calls us, so they outlive this handler
+        try {
+            std::call_once(atExitFlag, []() {
+                std::atexit([]() {
+                    IncidentCoordinator::stop();
+                });
+            });
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not register exit handler" << std::endl;
+        }
+    }
+
+    void IncidentCoordinator::stop() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Running = false;
+        }
+        Condition.notify_all();
+
+        // The coordinator thread never calls this method, so joining can not deadlock
+        if (Thread.joinable()) {
+            Thread.join();
+        }
+
+        // Nothing that was collected must get lost
+        flush();
+    }
+
+    bool IncidentCoordinator::isRunning() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Running;
+    }
+
+    void IncidentCoordinator::trigger(const LogEntry &logEntry) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Running && logEntry.getLogLevel() != LogLevel::Fatal) {
+                // Open the incident or extend the pending one
+                auto now = std::chrono::steady_clock::now();
+                if (!Pending) {
+                    Pending = true;
+                    FirstTrigger = now;
+                    Condition.notify_all();
+                }
+                LastTrigger = now;
+                return;
+            }
+
+            // The pending incident is part of the one we write now
+            Pending = false;
+        }
+
+        // The process may not survive a fatal log entry, so we wait until its incident is written
+        write(logEntry.getLogLevel() == LogLevel::Fatal);
+    }
+
+    void IncidentCoordinator::flush() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (!Pending) {
+                return;
+            }
+            Pending = false;
+        }
+        write(true);
+    }
+
+    bool IncidentCoordinator::isPending() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Pending;
+    }
+
+    size_t IncidentCoordinator::getNumberOfIncidents() noexcept {
+        return NumberOfIncidents;
+    }
+
+    void IncidentCoordinator::write(bool wait) noexcept {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        Log::writeIncident(wait);
+        NumberOfIncidents++;
+    }
+
+    std::chrono::steady_clock::time_point IncidentCoordinator::getDeadline() noexcept {
+        auto deadline = std::max(LastTrigger + QuietPeriod, FirstTrigger + Tail);
+        return std::min(deadline, FirstTrigger + MaxDelay);
+    }
+
+}
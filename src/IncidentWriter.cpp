@@ -0,0 +1,136 @@
+#include <ee/IncidentWriter.hpp>
+#include <ee/LogDurability.hpp>
+#include <iostream>
+#include <cstdlib>
+
+namespace ee {
+
+    std::mutex IncidentWriter::Mutex;
+    std::condition_variable IncidentWriter::Condition;
+    std::condition_variable IncidentWriter::Written;
+    std::thread IncidentWriter::Thread;
+    bool IncidentWriter::Running = false;
+    std::deque<std::pair<std::string, std::shared_ptr<const LogSnapshot>>> IncidentWriter::Queue;
+    size_t IncidentWriter::NumberOfPendingSnapshots = 0;
+
+    /**
+     * @brief Only one snapshot is written at a time, a stopped writer lets the submitting threads write.
+     */
+    static std::mutex writeMutex;
+
+    /**
+     * @brief Ensures the writer is stopped at exit only once.
+     */
+    static std::once_flag atExitFlag;
+
+    void IncidentWriter::start() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Thread.joinable()) {
+                return;
+            }
+            Running = true;
+            try {
+                Thread = std::thread([]() {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    while (true) {
+                        Condition.wait(lock, []() { return !Running || !Queue.empty(); });
+                        if (Queue.empty()) {
+                            // We only stop after the queue is drained
+                            break;
+                        }
+
+                        // The snapshot is written without holding our lock, so submitting never waits for the file
+                        auto job = std::move(Queue.front());
+                        Queue.pop_front();
+                        lock.unlock();
+                        write(job.first, *job.second);
+
+                        // Freeing the log entries is part of the work we take from the submitting thread
+                        job.second.reset();
+                        lock.lock();
+                        NumberOfPendingSnapshots--;
+                        Written.notify_all();
+                    }
+                });
+            } catch (...) {
+                // The system could not create another thread, every snapshot is written immediately
+                Running = false;
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not start incident writer" << std::endl;
+                return;
+            }
+        }
+
+        // The statics of the logging are created before the program calls us, so they outlive this handler
+        try {
+            std::call_once(atExitFlag, []() {
+                std::atexit([]() {
+                    IncidentWriter::stop();
+                });
+            });
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not register exit handler" << std::endl;
+        }
+    }
+
+    void IncidentWriter::stop() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Running = false;
+        }
+        Condition.notify_all();
+
+        // The writer thread never calls this method, so joining can not deadlock
+        if (Thread.joinable()) {
+            Thread.join();
+        }
+    }
+
+    bool IncidentWriter::isRunning() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Running;
+    }
+
+    void IncidentWriter::submit(const std::string &filename, std::shared_ptr<const LogSnapshot> snapshot) noexcept {
+        if (!snapshot) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Running) {
+                try {
+                    Queue.emplace_back(filename, snapshot);
+                    NumberOfPendingSnapshots++;
+                    Condition.notify_all();
+                    return;
+                } catch (...) {
+                    // We could not queue the snapshot, so we write it ourselves
+                }
+            }
+        }
+        write(filename, *snapshot);
+    }
+
+    void IncidentWriter::flush() noexcept {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Written.wait(lock, []() { return NumberOfPendingSnapshots == 0; });
+    }
+
+    size_t IncidentWriter::getNumberOfPendingSnapshots() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return NumberOfPendingSnapshots;
+    }
+
+    void IncidentWriter::write(const std::string &filename, const LogSnapshot &snapshot) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            if (!snapshot.writeToFile(filename)) {
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not write incident to " << filename << std::endl;
+            }
+        }
+
+        // Further snapshots are written while we wait for the disk, their syncs are grouped with ours
+        LogDurability::commit();
+    }
+
+}
@@ -1,46 +1,147 @@
 #include <ee/Log.hpp>
-#include <fstream>
+#include <ee/AsyncWriter.hpp>
+#include <ee/EmergencyReserve.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/FlightRecorder.hpp>
+#include <ee/Formatter.hpp>
+#include <ee/IncidentCoordinator.hpp>
+#include <ee/IncidentWriter.hpp>
+#include <ee/LogDurability.hpp>
+#include <ee/LogMerge.hpp>
+#include <ee/LogRotation.hpp>
+#include <ee/LogSpill.hpp>
+#include <ee/ThrowHook.hpp>
 #include <csignal>
+#include <algorithm>
+#include <queue>
 
 #ifdef __ANDROID__
 #include <android/log.h>
-#include <sstream>
 #endif
 
 namespace ee {
 
-#ifdef __ANDROID__
-    std::stringstream ss;
-#endif
     static std::string logFolder;
     static std::string logFilename;
+    static std::chrono::system_clock::time_point logFileCreated;
+    static std::chrono::system_clock::time_point lastIncident;
     std::recursive_mutex Log::Mutex;
     std::atomic_uint16_t Log::SuspendLoggingCounter = 0;
-    std::map<std::thread::id, std::list<LogEntry>> Log::LogThreadMap;
+    std::map<std::thread::id, LogBuffer> Log::LogThreadMap;
     std::map<LogLevel, std::function<void(const LogEntry &)>> Log::CallbackMap;
     std::map<LogLevel, std::ostream *> Log::OutStreamMap;
-    std::map<uint8_t, std::shared_ptr<LogRetentionPolicy>> Log::LogRetentionPolicies;
+    std::map<LogLevel, OutputFormat> Log::OutStreamFormatMap;
+    std::multimap<uint8_t, std::shared_ptr<LogRetentionPolicy>> Log::LogRetentionPolicies;
+    std::recursive_mutex Log::RetentionMutex;
+    std::atomic_size_t Log::NumberOfReleasedLogEntries = 0;
+    std::thread Log::RetentionThread;
+    std::mutex Log::RetentionThreadMutex;
+    std::condition_variable Log::RetentionThreadCondition;
+    bool Log::RetentionThreadRunning = false;
+
+    /**
+     * @brief Stops the housekeeping thread before the static members it uses are destroyed.
+     */
+    static struct RetentionThreadGuard {
+        ~RetentionThreadGuard() noexcept {
+            Log::stopRetentionThread();
+        }
+    } retentionThreadGuard;
 
     void logLevelHandler(const LogEntry &logEntry) noexcept {
+        // Cascading warnings are coalesced into a single incident if the coordinator is running
+        IncidentCoordinator::trigger(logEntry);
+    }
+
+    void Log::writeIncident(bool wait) noexcept {
         // We suspend logging for the whole scope of this function
         SuspendLogging suspendLogging;
 
         // We have to release all logs that are too old
         ee::Log::releaseLogs();
 
+        // A file that grew too large or too old is handed over for compression, the incident starts a new one
+        if (!logFilename.empty() && LogRotation::isDue(logFilename, logFileCreated)) {
+            LogRotation::close(logFilename);
+            logFilename.clear();
+        }
+
         // Create filename
         if (logFilename.empty()) {
             auto timestamp = std::chrono::system_clock::now();
+            logFileCreated = timestamp;
             auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
                     timestamp.time_since_epoch()).count();
             logFilename = logFolder + "ee-log-" + std::to_string(microseconds) + ".log";
         }
 
-        // We want to write all logs to a file
-        ee::Log::writeToFile(logFilename);
+        // The spilled logs are older than the ones in memory, the previous incident file already contains the logs
+        // that existed back then
+        auto now = std::chrono::system_clock::now();
+        auto spillSince = LogSpill::isOpen() ? std::max(now - LogSpill::getIncidentWindow(), lastIncident) :
+                          std::chrono::system_clock::time_point::max();
+        lastIncident = now;
+
+        // Moving the logs out is cheap, formatting and writing them is left to the incident writer
+        auto snapshot = Log::takeSnapshot(spillSince, now);
+        if (snapshot) {
+            IncidentWriter::submit(logFilename, snapshot);
+            if (wait) {
+                IncidentWriter::flush();
+            }
+        } else {
+            // Without a snapshot we write the logs in place and clear them afterwards
+            if (spillSince != std::chrono::system_clock::time_point::max()) {
+                LogSpill::writeToFile(logFilename, spillSince, EASY_EXCEPTION_OUTPUT_FORMAT, now);
+            }
+            ee::Log::writeToFile(logFilename);
+            Log::reset();
+            LogDurability::commit();
+        }
+
+        // The blocks of the file may still be in flight on the asynchronous writer, a fatal incident reaches the disk
+        if (wait) {
+            AsyncWriter::flush();
+            LogDurability::commit(true);
+        }
+
+        // The incident may have consumed parts of the emergency reserve, so we try to get it back
+        EmergencyReserve::refill();
+    }
+
+    bool Log::flush(bool durable) noexcept {
+        // A pending incident is written before we wait for the writers
+        IncidentCoordinator::flush();
+        IncidentWriter::flush();
+        AsyncWriter::flush();
+        return !durable || LogDurability::sync();
+    }
+
+    std::shared_ptr<LogSnapshot> Log::takeSnapshot(
+            const std::chrono::system_clock::time_point &spillSince,
+            const std::chrono::system_clock::time_point &spillUntil) noexcept {
+        std::shared_ptr<LogSnapshot> snapshot;
+        try {
+            snapshot = std::make_shared<LogSnapshot>(spillSince, spillUntil);
+        } catch (...) {
+            return nullptr;
+        }
 
-        // After we wrote all logs to a file we clear the log cache
-        Log::reset();
+        // The log entries must not be released while we move them
+        std::lock_guard<std::recursive_mutex> retentionMutex(Log::RetentionMutex);
+        std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
+        try {
+            for (auto &thread : LogThreadMap) {
+                // The buffers remain in the map because every thread stores a pointer to its buffer, a thread inside
+                // Log::log keeps its buffer locked until it no longer uses its new log entry
+                if (!thread.second.empty()) {
+                    thread.second.moveTo(snapshot->emplace(thread.first));
+                }
+            }
+        } catch (...) {
+            // The logs of the remaining threads stay in memory until the next snapshot
+        }
+        return snapshot;
     }
 
     void signalHandler(int signal) noexcept {
@@ -69,8 +170,10 @@ namespace ee {
             // In case of an ee::Exception
             ee::Log::log(ee::LogLevel::Fatal, e);
         } catch (std::exception &e) {
-            // In case of std::exception
-            ee::Log::log(ee::LogLevel::Fatal, "", "Uncaught exception", e.what(), {}, ee::Stacktrace::create());
+            // In case of std::exception we prefer the stacktrace of the throw site
+            auto stacktrace = ThrowHook::getStacktrace(e);
+            ee::Log::log(ee::LogLevel::Fatal, "", "Uncaught exception", e.what(), {},
+                         stacktrace.has_value() ? stacktrace : ee::Stacktrace::create());
         } catch (...) {
             // In case some unknown exception
             ee::Log::log(ee::LogLevel::Fatal, "", "Uncaught exception", "Unknown exeception", {},
@@ -90,16 +193,16 @@ namespace ee {
             const std::string &message,
             const std::vector<Note> &notes,
             const std::optional<std::shared_ptr<Stacktrace>> &stacktrace) noexcept {
-        // Every thread stores its own pointer to the log list
-        thread_local std::list<LogEntry> *pList = nullptr;
+        // Every thread stores its own pointer to the log buffer
+        thread_local LogBuffer *pBuffer = nullptr;
 
-        // Check if a pointer to the list is already generated
-        if (pList == nullptr) { // NOLINT
-            // We thave to get the list pointer for this thread, we modify the parent map and that requires concurrent logic
+        // Check if a pointer to the buffer is already generated
+        if (pBuffer == nullptr) { // NOLINT
+            // We thave to get the buffer pointer for this thread, we modify the parent map and that requires concurrent logic
             std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
 
-            // Get and possibly create the list pointer for this thread, store it in the list pointer
-            pList = &Log::LogThreadMap[std::this_thread::get_id()];
+            // Get and possibly create the buffer for this thread, store it in the buffer pointer
+            pBuffer = &Log::LogThreadMap[std::this_thread::get_id()];
         }
 
         // For a short period of time we may suspend the creation of logs
@@ -107,22 +210,50 @@ namespace ee {
             return;
         }
 
-        // Create a LogEntry in the thread specific list
-        auto &logEntry = pList->emplace_back(logLevel, classname, method, message, notes, stacktrace,
+        // The housekeeping and the coordinator release or move the log entries of this buffer, so we hold its mutex as
+        // long as we use the new log entry
+        std::unique_lock<std::recursive_mutex> bufferLock(pBuffer->getMutex());
+
+        // Create a LogEntry in the thread specific buffer
+        LogEntry *pLogEntry = nullptr;
+        try {
+            pLogEntry = &pBuffer->emplace_back(logLevel, classname, method, message, notes, stacktrace,
                                              std::chrono::system_clock::now());
+        } catch (...) {
+            // We are out of memory and the emergency reserve is already exhausted
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not store log entry" << std::endl;
+            return;
+        }
+        auto &logEntry = *pLogEntry;
+
+        // The flight recorder keeps a copy that survives even if the process gets killed
+        FlightRecorder::record(logEntry);
 
         // Check if we should display a copy of the logEntry in an outstream (e.g.: std::cout)
         if (OutStreamMap.count(logLevel)) {
             auto &stream = *OutStreamMap.at(logLevel);
-            logEntry.write(stream);
-            stream << std::endl << std::endl;
+            auto format = OutStreamFormatMap[logLevel];
+            try {
+                thread_local std::string buffer;
+                buffer.clear();
+                Formatter::write(buffer, logEntry, format);
+                buffer += format == OutputFormat::Json ? "\n" : "\n\n";
+                stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                stream.flush();
+            } catch (...) {
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not write to outstream" << std::endl;
+            }
         }
 
 #ifdef __ANDROID__
         // On android we print the log to logcat
-        logEntry.write(ss);
-        std::string s = ss.str();
-        ss.str("");
+        thread_local std::string s;
+        s.clear();
+        try {
+            Formatter::write(s, logEntry, OutputFormat::String);
+        } catch (...) {
+            s.clear();
+        }
         switch (logLevel) {
             default:
             case ee::LogLevel::Trace:
@@ -149,8 +280,18 @@ namespace ee {
 
         // Check if we have a callback function for this LogLevel
         if (CallbackMap.count(logLevel)) {
+            // The callback may write an incident that locks all buffers, so it gets a copy instead of holding our mutex
+            std::optional<LogEntry> copy;
+            try {
+                copy.emplace(logEntry);
+            } catch (...) {
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not copy log entry for callback" << std::endl;
+                return;
+            }
+            bufferLock.unlock();
+
             // Execute the callback
-            CallbackMap.at(logLevel)(logEntry);
+            CallbackMap.at(logLevel)(*copy);
         }
     }
 
@@ -166,13 +307,15 @@ namespace ee {
     }
 
     void Log::log(LogLevel logLevel, const std::exception &exception) noexcept {
+        // The stacktrace of the throw site is more useful than the one of the handler
+        auto stacktrace = ThrowHook::getStacktrace(exception);
         log(
                 logLevel,
                 "std::exception",
                 "std::exception",
                 exception.what(),
                 {},
-                ee::Stacktrace::create()
+                stacktrace.has_value() ? stacktrace : ee::Stacktrace::create()
                 );
     }
 
@@ -188,7 +331,7 @@ namespace ee {
         return condition;
     }
 
-    const std::map<std::thread::id, std::list<LogEntry>> &Log::getLogThreadMap() noexcept {
+    const std::map<std::thread::id, LogBuffer> &Log::getLogThreadMap() noexcept {
         return Log::LogThreadMap;
     }
 
@@ -216,8 +359,8 @@ namespace ee {
 
         // Iterate through the different threads
         for (auto &thread : Log::LogThreadMap) {
-            // We cant remove the lists from the parent map because pointers to that lists are stored in every thread
-            // and we would make them invalid. Instead we just clear each list and the pointers remain valid.
+            // We cant remove the buffers from the parent map because pointers to that buffers are stored in every thread
+            // and we would make them invalid. Instead we just clear each buffer and the pointers remain valid.
             thread.second.clear();
         }
     }
@@ -234,60 +377,87 @@ namespace ee {
         CallbackMap.clear();
     }
 
-    bool Log::writeToFile(const std::string &filename, OutputFormat format) noexcept {
+    bool Log::writeToFile(const std::string &filename, OutputFormat format, bool incremental) noexcept {
         // Suspend logging for the scope of this method
         SuspendLogging suspendLogging;
 
-        // We currently only support string format
-        if (format != OutputFormat::String) {
+        // The file stays open across calls, it is only opened again if it has been removed meanwhile
+        auto sink = FileSink::get(filename);
+        if (!sink) {
             return false;
         }
-
-        // Try to open file (for writing and appending)
-        std::ofstream file(filename, std::ios::out | std::ios::app);
-        if (!file.is_open()) {
+        std::lock_guard<std::mutex> sinkLock(sink->getMutex());
+        if (!sink->open()) {
             // Could not open file for writing
             return false;
         }
 
-        // Iterate through all threads
-        for (auto &thread : LogThreadMap) {
-            // Check if this thread has at least one log entry
-            if (!thread.second.empty()) {
-                // Write the headline for this thread
-                for (int i = 0; i < 32; i++) { file << '#'; }
-                file << "### " << thread.first << " ";
-                for (int i = 0; i < 32; i++) { file << '#'; }
-                file << "\n";
-
-                // Iterate through all log entries for this thread
-                for (auto &logEntry : thread.second) {
-                    // Write log entry to file
-                    logEntry.write(file);
-
-                    // Write space between each log entry
-                    file << std::endl << std::endl;
+        // The log entries must not be released while we write them
+        std::lock_guard<std::recursive_mutex> retentionMutex(Log::RetentionMutex);
+        std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
+
+        std::vector<std::pair<LogBuffer *, uint64_t>> watermarks;
+        try {
+            // The threads log in parallel, so they have to wait until their log entries are merged
+            std::vector<std::unique_lock<std::recursive_mutex>> locks;
+            for (auto &thread : LogThreadMap) {
+                locks.emplace_back(thread.second.getMutex());
+            }
+
+            // All threads are merged into a single chronological stream in the buffer of the sink
+            LogMerge merge(LogThreadMap, nullptr, incremental);
+            merge.write(*sink, format);
+
+            // The threads may log again before the file is flushed, so we remember what we have written
+            if (incremental) {
+                watermarks.reserve(LogThreadMap.size());
+                for (auto &thread : LogThreadMap) {
+                    if (!thread.second.empty()) {
+                        watermarks.emplace_back(&thread.second, thread.second.getMaxSequenceNumber() + 1);
+                    }
                 }
             }
+        } catch (...) {
+            // We could not format all log entries, but we keep what has been written so far
+            sink->flush();
+            return false;
+        }
+
+        // The bytes may still be written in the background, so we wait for them before the watermarks move
+        if (!sink->flush() || !sink->wait()) {
+            return false;
         }
 
-        file.close();
+        // The watermarks only move once the log entries reached the file, a failed write is repeated next time
+        for (auto &watermark : watermarks) {
+            watermark.first->setWatermark(watermark.second);
+        }
         return true;
     }
 
-    void Log::registerOutstream(LogLevel logLevel, std::ostream &outstream) noexcept {
+    void Log::registerOutstream(LogLevel logLevel, std::ostream &outstream, OutputFormat format) noexcept {
         OutStreamMap[logLevel] = &outstream;
+        OutStreamFormatMap[logLevel] = format;
     }
 
     void Log::removeOutstreams() noexcept {
         OutStreamMap.clear();
+        OutStreamFormatMap.clear();
     }
 
     const std::map<LogLevel, std::ostream *> &Log::getOutstreams() noexcept {
         return OutStreamMap;
     }
 
-    void Log::applyDefaultConfiguration(const std::string &pathToLogFolder) noexcept {
+    void Log::applyDefaultConfiguration(
+            const std::string &pathToLogFolder,
+            size_t emergencyReserve,
+            size_t flightRecorderSize) noexcept {
+        // Preallocate the memory we need to create diagnostics while the process is out of memory
+        if (emergencyReserve > 0) {
+            EmergencyReserve::reserve(emergencyReserve);
+        }
+
         // Register the outstream
 #ifndef __ANDROID__
         registerOutstream(LogLevel::Info, std::cout);
@@ -315,6 +485,21 @@ namespace ee {
             logFolder = pathToLogFolder;
         }
 
+        // A flight recorder that is still there belongs to a previous run that has been killed
+        if (flightRecorderSize > 0) {
+            auto recorderFilename = logFolder + "ee-flight-recorder.bin";
+            auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            auto recovered = FlightRecorder::recover(
+                    recorderFilename, logFolder + "ee-log-" + std::to_string(microseconds) + "-recovered.log");
+            FlightRecorder::open(recorderFilename, flightRecorderSize);
+            if (recovered > 0) {
+                log(LogLevel::Info, "", __PRETTY_FUNCTION__, "Recovered the flight recorder of a previous run", {
+                        Note("Log entries", recovered, __PRETTY_FUNCTION__)
+                });
+            }
+        }
+
         // Register a handler for Warning,Error,Fatal
         registerCallback(ee::LogLevel::Warning, std::bind(&logLevelHandler, std::placeholders::_1));
         registerCallback(ee::LogLevel::Error, std::bind(&logLevelHandler, std::placeholders::_1));
@@ -322,77 +507,531 @@ namespace ee {
 
         // Register the default log retention policy
         registerLogRententionPolicy(std::make_shared<LogRetentionOlderThan>(std::chrono::minutes(5)));
+
+        // A warning only moves the logs into a snapshot, the incident file is written on a dedicated thread
+        IncidentWriter::start();
     }
 
     void Log::registerLogRententionPolicy(std::shared_ptr<LogRetentionPolicy> policy) noexcept {
-        LogRetentionPolicies[policy->mPriority] = policy;
+        std::lock_guard<std::recursive_mutex> mutex(Log::RetentionMutex);
+
+        // A policy of the same kind for the same log levels is replaced
+        auto range = LogRetentionPolicies.equal_range(policy->mPriority);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second->getMinLogLevel() == policy->getMinLogLevel() &&
+                it->second->getMaxLogLevel() == policy->getMaxLogLevel()) {
+                it->second = policy;
+                return;
+            }
+        }
+
+        try {
+            LogRetentionPolicies.emplace(policy->mPriority, policy);
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not register log retention policy" << std::endl;
+        }
     }
 
     void Log::removeLogRetentionPolicies() noexcept {
+        std::lock_guard<std::recursive_mutex> mutex(Log::RetentionMutex);
         LogRetentionPolicies.clear();
     }
 
-    const std::map<uint8_t, std::shared_ptr<LogRetentionPolicy>> &Log::getLogRetentionPolicies() noexcept {
+    const std::multimap<uint8_t, std::shared_ptr<LogRetentionPolicy>> &Log::getLogRetentionPolicies() noexcept {
         return LogRetentionPolicies;
     }
 
-    void Log::releaseLogs() noexcept {
-        // Suspend logging for the scope of this method
-        SuspendLogging suspendLogging;
+    /**
+     * @brief Releases log entries of a segment, they are spilled to disk first if the spill tier is open.
+     *
+     * The caller has to hold the mutex of the buffer.
+     * @param threadId The id of the thread that owns the buffer.
+     * @param buffer The buffer.
+     * @param logLevel The log level of the segment.
+     * @param segment The index of the segment.
+     * @param release One flag per log entry, true releases the log entry. An empty mask releases the whole segment.
+     * @return The number of released log entries.
+     */
+    static size_t spillAndRelease(
+            const std::thread::id &threadId,
+            LogBuffer &buffer,
+            LogLevel logLevel,
+            size_t segment,
+            const std::vector<bool> &release) noexcept {
+        if (LogSpill::isOpen() && buffer.thaw(logLevel, segment)) {
+            LogSpill::append(threadId, buffer.getSegments(logLevel)[segment], release);
+        }
+        return release.empty() ? buffer.release(logLevel, segment) : buffer.release(logLevel, segment, release);
+    }
 
-        // We thave to get the list pointer for this thread, we modify the parent map and that requires concurrent logic
-        std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
+    /**
+     * @brief Walks through a chain of segments of a log buffer from the youngest to the oldest log entry.
+     */
+    struct ChainCursor {
+        const std::thread::id *threadId;
+        LogBuffer *buffer;
+        LogLevel logLevel;
+        size_t segment;
+        size_t entry;
+
+        /**
+         * @brief Returns the current segment.
+         *
+         * @return The segment.
+         */
+        const LogSegment &getSegment() const noexcept {
+            return this->buffer->getSegments(this->logLevel)[this->segment];
+        }
 
-        // Go through the different threads
-        for (auto &thread : LogThreadMap) {
-            // Init the log retention policies
-            for (auto &policy : LogRetentionPolicies) {
-                policy.second->init();
+        /**
+         * @brief Returns the current log entry, the current segment must not be compressed.
+         *
+         * @return The log entry.
+         */
+        const LogEntry &get() const noexcept {
+            return this->getSegment().getEntries()[this->entry];
+        }
+
+        /**
+         * @brief Returns the date of creation of the current log entry.
+         *
+         * A compressed segment is only entered at its youngest log entry, so its youngest date is used instead.
+         * @return The date of creation.
+         */
+        const std::chrono::system_clock::time_point &getDateOfCreation() const noexcept {
+            auto &segment = this->getSegment();
+            return segment.isCompressed() ? segment.getMaxDateOfCreation() : this->get().getDateOfCreation();
+        }
+
+        /**
+         * @brief Returns the sequence number of the current log entry.
+         *
+         * A compressed segment is only entered at its youngest log entry, so its youngest sequence number is used.
+         * @return The sequence number.
+         */
+        uint64_t getSequenceNumber() const noexcept {
+            auto &segment = this->getSegment();
+            return segment.isCompressed() ? segment.getMaxSequenceNumber() : this->get().getSequenceNumber();
+        }
+
+        /**
+         * @brief Moves to the next older log entry.
+         *
+         * @return False if there is no older log entry.
+         */
+        bool previous() noexcept {
+            if (this->entry > 0) {
+                this->entry--;
+                return true;
+            }
+            auto &chain = this->buffer->getSegments(this->logLevel);
+            while (this->segment > 0) {
+                if (!chain[--this->segment].empty()) {
+                    this->entry = chain[this->segment].size() - 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief Applies the given log retention policies to the log entries of a thread, the youngest one first.
+     *
+     * The chains of all log levels are merged by their sequence numbers without copying them, so the policies see the
+     * log entries in the order the thread created them. A segment younger than the current log entries of all other
+     * chains is decided as a whole, otherwise the span of its log entries younger than all others is decided at once.
+     * The caller has to hold the mutex of the buffer.
+     * @param threadId The id of the thread that owns the buffer.
+     * @param buffer The buffer.
+     * @param policies The initialized policies, ordered by their priority.
+     * @return The number of released log entries.
+     */
+    static size_t releaseThread(
+            const std::thread::id &threadId,
+            LogBuffer &buffer,
+            const std::vector<LogRetentionPolicy *> &policies) {
+        // Start at the youngest log entry of every chain
+        std::vector<ChainCursor> cursors;
+        for (size_t level = 0; level < LogBuffer::NumberOfLogLevels; level++) {
+            auto logLevel = static_cast<LogLevel>(level);
+            ChainCursor cursor{&threadId, &buffer, logLevel, buffer.getSegments(logLevel).size(), 0};
+            if (cursor.previous()) {
+                cursors.push_back(cursor);
             }
+        }
+
+        // The heap always provides the chain with the youngest current log entry
+        auto older = [&cursors](size_t a, size_t b) {
+            return cursors[a].getSequenceNumber() < cursors[b].getSequenceNumber();
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(older)> heap(older);
+        for (size_t i = 0; i < cursors.size(); i++) {
+            heap.push(i);
+        }
 
-            // Go through all logs from the youngest to the oldest
-            auto it = thread.second.rbegin();
-            while (it != thread.second.rend()) {
-                // Go through all policies
-                bool removeLogEntry = false;
-                for (auto &policy : LogRetentionPolicies) {
-                    if (!policy.second->retain(*it)) {
-                        // This log entry should be deleted by this policy
-                        removeLogEntry = true;
+        // The decisions are collected first, releasing a segment would move the indices of the younger ones, an empty
+        // mask releases the whole segment
+        std::map<std::pair<LogLevel, size_t>, std::vector<bool>> decisions;
+        while (!heap.empty()) {
+            auto index = heap.top();
+            heap.pop();
+            auto &cursor = cursors[index];
+            auto &segment = cursor.getSegment();
+            auto key = std::make_pair(cursor.logLevel, cursor.segment);
+            bool entered = cursor.entry + 1 == segment.size();
+
+            // Most segments can be decided as a whole, only the boundary has to be looked at in detail
+            bool wholeSegment = entered && (heap.empty() ||
+                    segment.getMinSequenceNumber() > cursors[heap.top()].getSequenceNumber());
+            auto boundaryPolicy = policies.begin();
+            bool releaseSegment = false;
+            if (wholeSegment) {
+                boundaryPolicy = policies.end();
+                for (auto it = policies.begin(); it != policies.end(); it++) {
+                    if (!(*it)->appliesTo(cursor.logLevel)) {
+                        // The segments of other log levels do not count for this policy
+                        continue;
+                    }
+                    if ((*it)->releaseSegment(segment)) {
+                        releaseSegment = true;
+                        break;
+                    }
+                    if (!(*it)->retainSegment(segment)) {
+                        boundaryPolicy = it;
                         break;
                     }
                 }
+            }
 
-                // Remove or increase the iterator
-                if (removeLogEntry) {
-                    thread.second.erase(std::next(it).base());
+            if (releaseSegment) {
+                decisions[key];
+                cursor.entry = 0;
+            } else if (boundaryPolicy != policies.end() && buffer.thaw(cursor.logLevel, cursor.segment)) {
+                // The log entries younger than the current log entries of all other chains form a span, every policy
+                // cuts the oldest log entries of the span the previous policies retained
+                auto &entries = segment.getEntries();
+                size_t first = cursor.entry;
+                if (wholeSegment || heap.empty()) {
+                    first = 0;
                 } else {
-                    it++;
+                    auto limit = cursors[heap.top()].getSequenceNumber();
+                    while (first > 0 && entries[first - 1].getSequenceNumber() > limit) {
+                        first--;
+                    }
+                }
+                auto size = cursor.entry + 1 - first;
+                for (auto it = boundaryPolicy; entered && it != policies.end(); it++) {
+                    if ((*it)->appliesTo(cursor.logLevel)) {
+                        (*it)->enterSegment(segment);
+                    }
+                }
+                size_t cut = 0;
+                for (auto it = boundaryPolicy; it != policies.end() && cut < size; it++) {
+                    if ((*it)->appliesTo(cursor.logLevel)) {
+                        cut += (*it)->releaseSpan(entries.data() + first + cut, size - cut);
+                    }
+                }
+                if (cut > 0) {
+                    auto &release = decisions[key];
+                    release.resize(entries.size(), false);
+                    std::fill(release.begin() + static_cast<std::ptrdiff_t>(first),
+                              release.begin() + static_cast<std::ptrdiff_t>(first + cut), true);
+                }
+                cursor.entry = first;
+            } else {
+                // The segment is retained, or its log entries can not be read and stay until the next cycle
+                cursor.entry = 0;
+            }
+
+            if (cursor.previous()) {
+                heap.push(index);
+            }
+        }
+
+        // Release the segments with the highest index of every chain first, so the other indices remain valid
+        size_t released = 0;
+        for (auto decision = decisions.rbegin(); decision != decisions.rend(); decision++) {
+            released += spillAndRelease(
+                    threadId, buffer, decision->first.first, decision->first.second, decision->second);
+        }
+        return released;
+    }
+
+    /**
+     * @brief Applies a global log retention policy to the log entries of all threads in chronological order.
+     *
+     * The chains of all threads and log levels are merged from the youngest to the oldest log entry without copying
+     * them, until the policy releases the first log entry. That log entry and all older ones are released. The work
+     * is bounded by the number of retained log entries, a segment younger than all other chains is retained at once.
+     * The caller has to hold the mutexes of all buffers.
+     * @param threads The log buffers of all threads.
+     * @param policy The global policy.
+     * @return The number of released log entries.
+     */
+    static size_t releaseGlobal(std::map<std::thread::id, LogBuffer> &threads, LogRetentionPolicy &policy) {
+        // Start at the youngest log entry of every chain the policy applies to
+        std::vector<ChainCursor> cursors;
+        for (auto &thread : threads) {
+            for (size_t level = 0; level < LogBuffer::NumberOfLogLevels; level++) {
+                auto logLevel = static_cast<LogLevel>(level);
+                auto &chain = thread.second.getSegments(logLevel);
+                if (policy.appliesTo(logLevel) && !chain.empty()) {
+                    ChainCursor cursor{&thread.first, &thread.second, logLevel, chain.size(), 0};
+                    if (cursor.previous()) {
+                        cursors.push_back(cursor);
+                    }
+                }
+            }
+        }
+
+        // The heap always provides the chain with the youngest current log entry
+        auto older = [&cursors](size_t a, size_t b) {
+            return cursors[a].getDateOfCreation() < cursors[b].getDateOfCreation();
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(older)> heap(older);
+        for (size_t i = 0; i < cursors.size(); i++) {
+            heap.push(i);
+        }
+
+        policy.init();
+        std::vector<bool> retained(cursors.size(), false);
+        bool boundaryReached = false;
+        while (!heap.empty()) {
+            auto index = heap.top();
+            heap.pop();
+            auto &cursor = cursors[index];
+            auto &segment = cursor.getSegment();
+
+            // A whole segment that is younger than the current log entries of all other chains can be decided at once
+            bool entered = cursor.entry + 1 == segment.size();
+            bool wholeSegment = entered && (heap.empty() ||
+                    segment.getMinDateOfCreation() >= cursors[heap.top()].getDateOfCreation());
+            if (wholeSegment && policy.retainSegment(segment)) {
+                cursor.entry = 0;
+            } else if (!cursor.buffer->thaw(cursor.logLevel, cursor.segment)) {
+                // The log entries can not be read, we treat them as the boundary
+                boundaryReached = true;
+                break;
+            } else {
+                // The log entries of this segment that are younger than the current log entries of all other chains
+                // form a span the policy decides for at once
+                if (entered) {
+                    policy.enterSegment(segment);
+                }
+                auto &entries = segment.getEntries();
+                size_t first = heap.empty() ? 0 : cursor.entry;
+                if (!heap.empty()) {
+                    auto &limit = cursors[heap.top()].getDateOfCreation();
+                    while (first > 0 && entries[first - 1].getDateOfCreation() >= limit) {
+                        first--;
+                    }
+                }
+                auto cut = policy.releaseSpan(entries.data() + first, cursor.entry + 1 - first);
+                if (cut > 0) {
+                    // This log entry and the current log entries of all other chains are the boundary
+                    cursor.entry = first + cut - 1;
+                    boundaryReached = true;
+                    break;
+                }
+                cursor.entry = first;
+            }
+
+            if (cursor.previous()) {
+                heap.push(index);
+            } else {
+                retained[index] = true;
+            }
+        }
+        if (!boundaryReached) {
+            return 0;
+        }
+
+        // Release the current log entry of every chain and all older ones
+        size_t released = 0;
+        for (size_t i = 0; i < cursors.size(); i++) {
+            if (retained[i]) {
+                continue;
+            }
+            auto &cursor = cursors[i];
+            std::vector<bool> release(cursor.getSegment().size(), false);
+            std::fill(release.begin(), release.begin() + static_cast<std::ptrdiff_t>(cursor.entry) + 1, true);
+            released += spillAndRelease(*cursor.threadId, *cursor.buffer, cursor.logLevel, cursor.segment, release);
+            for (size_t segment = cursor.segment; segment-- > 0;) {
+                released += spillAndRelease(*cursor.threadId, *cursor.buffer, cursor.logLevel, segment, {});
+            }
+        }
+        return released;
+    }
+
+    size_t Log::releaseLogs() noexcept {
+        // The policies have a state, so only one retention cycle may run at a time
+        std::lock_guard<std::recursive_mutex> retentionMutex(Log::RetentionMutex);
+
+        // We iterate over the parent map and that requires concurrent logic
+        std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
+        size_t released = 0;
+
+        try {
+            // Some policies decide for every thread on its own, others across all threads
+            std::vector<LogRetentionPolicy *> threadPolicies;
+            std::vector<LogRetentionPolicy *> globalPolicies;
+            for (auto &policy : LogRetentionPolicies) {
+                (policy.second->isGlobal() ? globalPolicies : threadPolicies).push_back(policy.second.get());
+            }
+
+            // Go through the different threads
+            for (auto &thread : LogThreadMap) {
+                if (threadPolicies.empty()) {
+                    break;
+                }
+
+                // Init the log retention policies
+                for (auto &policy : threadPolicies) {
+                    policy->init();
+                }
+
+                // Go through the log entries of all log levels from the youngest to the oldest, the owning thread must
+                // not append meanwhile
+                auto &buffer = thread.second;
+                std::lock_guard<std::recursive_mutex> lock(buffer.getMutex());
+                released += releaseThread(thread.first, buffer, threadPolicies);
+            }
+
+            if (!globalPolicies.empty()) {
+                // Every thread has to wait until the global decision is done
+                std::vector<std::unique_lock<std::recursive_mutex>> locks;
+                for (auto &thread : LogThreadMap) {
+                    locks.emplace_back(thread.second.getMutex());
+                }
+                for (auto &policy : globalPolicies) {
+                    released += releaseGlobal(LogThreadMap, *policy);
+                }
+            }
+        } catch (...) {
+            // We could not allocate the memory for deciding, the remaining logs are released in the next cycle
+        }
+
+        NumberOfReleasedLogEntries += released;
+        return released;
+    }
+
+    size_t Log::compressLogs(const std::chrono::milliseconds &age) noexcept {
+        // Releasing logs must not interfere with moving them into compressed blocks
+        std::lock_guard<std::recursive_mutex> retentionMutex(Log::RetentionMutex);
+        std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
+
+        auto before = std::chrono::system_clock::now() - age;
+        size_t compressed = 0;
+        for (auto &thread : LogThreadMap) {
+            // Only the owning thread has to wait while its segments are compressed
+            auto &buffer = thread.second;
+            std::lock_guard<std::recursive_mutex> lock(buffer.getMutex());
+            for (size_t level = 0; level < LogBuffer::NumberOfLogLevels; level++) {
+                auto logLevel = static_cast<LogLevel>(level);
+                auto &chain = buffer.getSegments(logLevel);
+                for (size_t segment = 0; segment < chain.size(); segment++) {
+                    if (!chain[segment].isCompressed() && !chain[segment].empty() &&
+                        chain[segment].getMaxDateOfCreation() < before && buffer.compress(logLevel, segment)) {
+                        compressed++;
+                    }
                 }
             }
         }
+        return compressed;
+    }
+
+    size_t Log::getNumberOfBytes() noexcept {
+        size_t numberOfBytes = 0;
+
+        // Iterating over the parent map, that means we have to use concurrent logic
+        std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
+        for (auto &thread : LogThreadMap) {
+            std::lock_guard<std::recursive_mutex> lock(thread.second.getMutex());
+            numberOfBytes += thread.second.getNumberOfBytes();
+        }
+        return numberOfBytes;
+    }
+
+    size_t Log::getNumberOfReleasedLogEntries() noexcept {
+        return NumberOfReleasedLogEntries;
+    }
+
+    void Log::startRetentionThread(
+            const std::chrono::milliseconds &period,
+            const std::chrono::milliseconds &compressionAge) noexcept {
+        stopRetentionThread();
+
+        std::lock_guard<std::mutex> lock(RetentionThreadMutex);
+        if (RetentionThread.joinable()) {
+            // Another caller started the housekeeping thread meanwhile
+            return;
+        }
+        RetentionThreadRunning = true;
+        try {
+            RetentionThread = std::thread([period, compressionAge]() {
+                std::unique_lock<std::mutex> lock(RetentionThreadMutex);
+                while (RetentionThreadRunning) {
+                    // Sleep for one period, but wake up immediately when we should stop
+                    if (RetentionThreadCondition.wait_for(lock, period, []() { return !RetentionThreadRunning; })) {
+                        break;
+                    }
+
+                    // The logs are released without holding our own lock, so stopping is never delayed by it
+                    lock.unlock();
+                    releaseLogs();
+                    if (compressionAge > std::chrono::milliseconds::zero()) {
+                        compressLogs(compressionAge);
+                    }
+                    lock.lock();
+                }
+            });
+        } catch (...) {
+            // The system could not create another thread
+            RetentionThreadRunning = false;
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not start retention thread" << std::endl;
+        }
+    }
+
+    void Log::stopRetentionThread() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(RetentionThreadMutex);
+            RetentionThreadRunning = false;
+        }
+        RetentionThreadCondition.notify_all();
+
+        // The housekeeping thread never calls this method, so joining can not deadlock
+        if (RetentionThread.joinable()) {
+            RetentionThread.join();
+        }
+    }
+
+    bool Log::isRetentionThreadRunning() noexcept {
+        std::lock_guard<std::mutex> lock(RetentionThreadMutex);
+        return RetentionThreadRunning;
     }
 
     std::map<LogLevel, size_t> Log::countLogLevels() noexcept {
         // Suspend logging for the scope of this method
         SuspendLogging suspendLogging;
 
+        // The log entries must not be released while we count them
+        std::lock_guard<std::recursive_mutex> retentionMutex(Log::RetentionMutex);
+
         // We thave to get the list pointer for this thread, we modify the parent map and that requires concurrent logic
         std::lock_guard<std::recursive_mutex> mutex(Log::Mutex);
 
         // Create the map
         std::map<LogLevel, size_t> map;
 
-        // Go through all threads and log entries
+        // Go through all threads, every thread knows the number of log entries of each log level
         for (auto &thread : LogThreadMap) {
-            for (auto &logEntry : thread.second) {
-                // Check if we already have an entry for this log level
-                if (map.count(logEntry.getLogLevel())) {
-                    // Increase entry
-                    map.at(logEntry.getLogLevel())++;
-                } else {
-                    // Create entry
-                    map[logEntry.getLogLevel()] = 1;
+            std::lock_guard<std::recursive_mutex> lock(thread.second.getMutex());
+            for (size_t level = 0; level < LogBuffer::NumberOfLogLevels; level++) {
+                auto logLevel = static_cast<LogLevel>(level);
+                auto size = thread.second.size(logLevel);
+                if (size > 0) {
+                    map[logLevel] += size;
                 }
             }
         }
@@ -0,0 +1,370 @@
+#include <ee/LogBuffer.hpp>
+#include <algorithm>
+
+namespace ee {
+
+    std::atomic<uint64_t> LogBuffer::NextSequenceNumber = 0;
+
+    LogBuffer::const_iterator::const_iterator(const Chains *chains, bool end) noexcept :
+            mChains(chains), mPositions(), mLevel(NumberOfLogLevels) {
+        for (size_t level = 0; level < NumberOfLogLevels; level++) {
+            this->mPositions[level] = {end ? (*chains)[level].size() : 0, 0};
+            this->skipEmptySegments(level);
+        }
+        this->select();
+    }
+
+    LogBuffer::const_iterator::const_iterator(const Chains *chains, uint64_t from) noexcept :
+            mChains(chains), mPositions(), mLevel(NumberOfLogLevels) {
+        for (size_t level = 0; level < NumberOfLogLevels; level++) {
+            // The segments of a chain and their log entries are ordered by their sequence numbers
+            auto &chain = (*chains)[level];
+            auto segment = std::partition_point(chain.begin(), chain.end(), [from](const LogSegment &segment) {
+                return segment.getMaxSequenceNumber() < from;
+            });
+            size_t entry = 0;
+            if (segment != chain.end()) {
+                auto &entries = segment->getEntries();
+                entry = std::partition_point(entries.begin(), entries.end(), [from](const LogEntry &logEntry) {
+                    return logEntry.getSequenceNumber() < from;
+                }) - entries.begin();
+
+                // The youngest log entry of the segment may have been released
+                if (entry == entries.size()) {
+                    segment++;
+                    entry = 0;
+                }
+            }
+            this->mPositions[level] = {static_cast<size_t>(segment - chain.begin()), entry};
+            this->skipEmptySegments(level);
+        }
+        this->select();
+    }
+
+    LogBuffer::const_iterator::reference LogBuffer::const_iterator::operator*() const noexcept {
+        auto &position = this->mPositions[this->mLevel];
+        return (*this->mChains)[this->mLevel][position.segment].getEntries()[position.entry];
+    }
+
+    LogBuffer::const_iterator::pointer LogBuffer::const_iterator::operator->() const noexcept {
+        return &**this;
+    }
+
+    LogBuffer::const_iterator &LogBuffer::const_iterator::operator++() noexcept {
+        auto &position = this->mPositions[this->mLevel];
+        if (++position.entry >= (*this->mChains)[this->mLevel][position.segment].getEntries().size()) {
+            position.segment++;
+            position.entry = 0;
+            this->skipEmptySegments(this->mLevel);
+        }
+        this->select();
+        return *this;
+    }
+
+    LogBuffer::const_iterator LogBuffer::const_iterator::operator++(int) noexcept {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool LogBuffer::const_iterator::operator==(const const_iterator &other) const noexcept {
+        if (this->mLevel != other.mLevel) {
+            return false;
+        }
+        if (this->mLevel == NumberOfLogLevels) {
+            return true;
+        }
+        auto &position = this->mPositions[this->mLevel];
+        auto &otherPosition = other.mPositions[other.mLevel];
+        return position.segment == otherPosition.segment && position.entry == otherPosition.entry;
+    }
+
+    bool LogBuffer::const_iterator::operator!=(const const_iterator &other) const noexcept {
+        return !(*this == other);
+    }
+
+    void LogBuffer::const_iterator::skipEmptySegments(size_t level) noexcept {
+        auto &chain = (*this->mChains)[level];
+        auto &position = this->mPositions[level];
+        // A segment that could not be thawed has no log entries to iterate through
+        while (position.segment < chain.size() && chain[position.segment].getEntries().empty()) {
+            position.segment++;
+        }
+    }
+
+    void LogBuffer::const_iterator::select() noexcept {
+        // The next log entry is the oldest of all chains
+        this->mLevel = NumberOfLogLevels;
+        uint64_t sequenceNumber = 0;
+        for (size_t level = 0; level < NumberOfLogLevels; level++) {
+            auto &chain = (*this->mChains)[level];
+            auto &position = this->mPositions[level];
+            if (position.segment >= chain.size()) {
+                continue;
+            }
+            auto current = chain[position.segment].getEntries()[position.entry].getSequenceNumber();
+            if (this->mLevel == NumberOfLogLevels || current < sequenceNumber) {
+                this->mLevel = level;
+                sequenceNumber = current;
+            }
+        }
+    }
+
+    LogBuffer::LogBuffer(const LogBuffer &other) {
+        std::lock_guard<std::recursive_mutex> lock(other.mMutex);
+        for (size_t level = 0; level < NumberOfLogLevels; level++) {
+            this->mChains[level] = std::deque<LogSegment>(other.mChains[level]);
+        }
+        this->mSizes = other.mSizes;
+        this->mSize = other.mSize;
+        this->mNumberOfBytes = other.mNumberOfBytes;
+        this->mStacktraces = other.mStacktraces;
+    }
+
+    LogEntry &LogBuffer::emplace_back(
+            LogLevel logLevel,
+            const std::string &classname,
+            const std::string &method,
+            const std::string &message,
+            const std::vector<Note> &notes,
+            const std::optional<std::shared_ptr<Stacktrace>> &stacktrace,
+            const std::chrono::system_clock::time_point &dateOfCreation) {
+        std::lock_guard<std::recursive_mutex> lock(this->mMutex);
+
+        // Log levels that are used a lot get large segments, rare log levels keep a small footprint
+        auto &chain = this->mChains[logLevel];
+        if (chain.empty() || chain.back().full()) {
+            auto &segment = chain.emplace_back(std::clamp<size_t>(this->mSizes[logLevel], 32, LogSegment::MaxCapacity));
+            this->mNumberOfBytes += sizeof(LogSegment) + segment.getNumberOfReservedBytes();
+        }
+
+        auto &logEntry = chain.back().emplace_back(
+                logLevel, classname, method, message, notes, stacktrace, dateOfCreation,
+                NextSequenceNumber.fetch_add(1, std::memory_order_relaxed));
+        this->mSizes[logLevel]++;
+        this->mSize++;
+
+        this->account(logEntry);
+        return logEntry;
+    }
+
+    void LogBuffer::clear() noexcept {
+        std::lock_guard<std::recursive_mutex> lock(this->mMutex);
+        for (auto &chain : this->mChains) {
+            chain.clear();
+        }
+        this->mSizes.fill(0);
+        this->mSize = 0;
+        this->mNumberOfBytes = 0;
+        this->mStacktraces.clear();
+    }
+
+    void LogBuffer::moveTo(LogBuffer &target) noexcept {
+        std::scoped_lock lock(this->mMutex, target.mMutex);
+
+        // The target is empty, so swapping leaves this buffer empty while new log entries keep their order
+        std::swap(this->mChains, target.mChains);
+        std::swap(this->mSizes, target.mSizes);
+        std::swap(this->mSize, target.mSize);
+        std::swap(this->mNumberOfBytes, target.mNumberOfBytes);
+        std::swap(this->mStacktraces, target.mStacktraces);
+    }
+
+    size_t LogBuffer::size() const noexcept {
+        return this->mSize;
+    }
+
+    size_t LogBuffer::size(LogLevel logLevel) const noexcept {
+        return this->mSizes[logLevel];
+    }
+
+    size_t LogBuffer::size(uint64_t from) const noexcept {
+        size_t size = 0;
+        for (auto &chain : this->mChains) {
+            for (auto segment = chain.rbegin(); segment != chain.rend() && segment->getMaxSequenceNumber() >= from;
+                 segment++) {
+                size += segment->size();
+            }
+        }
+        return size;
+    }
+
+    uint64_t LogBuffer::getMaxSequenceNumber() const noexcept {
+        uint64_t sequenceNumber = 0;
+        for (auto &chain : this->mChains) {
+            if (!chain.empty()) {
+                sequenceNumber = std::max(sequenceNumber, chain.back().getMaxSequenceNumber());
+            }
+        }
+        return sequenceNumber;
+    }
+
+    uint64_t LogBuffer::getWatermark() const noexcept {
+        return this->mWatermark;
+    }
+
+    void LogBuffer::setWatermark(uint64_t watermark) noexcept {
+        this->mWatermark = watermark;
+    }
+
+    bool LogBuffer::empty() const noexcept {
+        return this->mSize == 0;
+    }
+
+    LogBuffer::const_iterator LogBuffer::begin() const noexcept {
+        // The housekeeping thread may compress the segments meanwhile
+        std::lock_guard<std::recursive_mutex> lock(this->mMutex);
+        for (size_t level = 0; level < NumberOfLogLevels; level++) {
+            for (size_t segment = 0; segment < this->mChains[level].size(); segment++) {
+                this->thaw(static_cast<LogLevel>(level), segment);
+            }
+        }
+        return const_iterator(&this->mChains, false);
+    }
+
+    LogBuffer::const_iterator LogBuffer::begin(uint64_t from) const noexcept {
+        std::lock_guard<std::recursive_mutex> lock(this->mMutex);
+        for (size_t level = 0; level < NumberOfLogLevels; level++) {
+            auto &chain = this->mChains[level];
+            for (size_t segment = chain.size(); segment > 0 && chain[segment - 1].getMaxSequenceNumber() >= from;
+                 segment--) {
+                this->thaw(static_cast<LogLevel>(level), segment - 1);
+            }
+        }
+        return const_iterator(&this->mChains, from);
+    }
+
+    LogBuffer::const_iterator LogBuffer::end() const noexcept {
+        return const_iterator(&this->mChains, true);
+    }
+
+    LogBuffer::const_iterator LogBuffer::cbegin() const noexcept {
+        return this->begin();
+    }
+
+    LogBuffer::const_iterator LogBuffer::cend() const noexcept {
+        return this->end();
+    }
+
+    const std::deque<LogSegment> &LogBuffer::getSegments(LogLevel logLevel) const noexcept {
+        return this->mChains[logLevel];
+    }
+
+    size_t LogBuffer::getNumberOfBytes() const noexcept {
+        return this->mNumberOfBytes;
+    }
+
+    std::recursive_mutex &LogBuffer::getMutex() const noexcept {
+        return this->mMutex;
+    }
+
+    void LogBuffer::account(const LogEntry &logEntry) const {
+        // The segment already reserved the log entry itself, only the owned memory is added
+        this->mNumberOfBytes += logEntry.getNumberOfBytes() - sizeof(LogEntry);
+        auto &stacktrace = logEntry.getStacktrace();
+        if (stacktrace.has_value() && stacktrace.value()) {
+            auto &references = this->mStacktraces[stacktrace.value().get()];
+            if (references++ == 0) {
+                this->mNumberOfBytes += stacktrace.value()->getNumberOfBytes();
+            }
+        }
+    }
+
+    void LogBuffer::unaccount(const LogEntry &logEntry) const noexcept {
+        this->mNumberOfBytes -= logEntry.getNumberOfBytes() - sizeof(LogEntry);
+
+        // The stacktrace is only freed with its last log entry
+        auto &stacktrace = logEntry.getStacktrace();
+        if (stacktrace.has_value() && stacktrace.value()) {
+            auto it = this->mStacktraces.find(stacktrace.value().get());
+            if (it != this->mStacktraces.end() && --it->second == 0) {
+                this->mNumberOfBytes -= stacktrace.value()->getNumberOfBytes();
+                this->mStacktraces.erase(it);
+            }
+        }
+    }
+
+    size_t LogBuffer::release(LogLevel logLevel, size_t segment, const std::vector<bool> &release) noexcept {
+        if (!this->thaw(logLevel, segment)) {
+            return 0;
+        }
+        auto &chain = this->mChains[logLevel];
+        auto &entries = chain[segment].getEntries();
+        for (size_t i = 0; i < entries.size() && i < release.size(); i++) {
+            if (release[i]) {
+                this->unaccount(entries[i]);
+            }
+        }
+
+        auto released = chain[segment].release(release);
+        this->mSizes[logLevel] -= released;
+        this->mSize -= released;
+        if (chain[segment].empty()) {
+            this->mNumberOfBytes -= sizeof(LogSegment) + chain[segment].getNumberOfReservedBytes();
+            chain.erase(chain.begin() + static_cast<std::ptrdiff_t>(segment));
+        }
+        return released;
+    }
+
+    size_t LogBuffer::release(LogLevel logLevel, size_t segment) noexcept {
+        auto &chain = this->mChains[logLevel];
+        for (auto &logEntry : chain[segment].getEntries()) {
+            this->unaccount(logEntry);
+        }
+        this->mNumberOfBytes -= sizeof(LogSegment) + chain[segment].getNumberOfReservedBytes();
+
+        auto released = chain[segment].size();
+        this->mSizes[logLevel] -= released;
+        this->mSize -= released;
+        chain.erase(chain.begin() + static_cast<std::ptrdiff_t>(segment));
+        return released;
+    }
+
+    bool LogBuffer::compress(LogLevel logLevel, size_t segment) noexcept {
+        auto &chain = this->mChains[logLevel];
+        if (segment + 1 == chain.size() && !chain[segment].full()) {
+            // The owning thread still appends to this segment
+            return false;
+        }
+
+        try {
+            auto reservedBytes = chain[segment].getNumberOfReservedBytes();
+            std::vector<LogEntry> entries;
+            if (!chain[segment].compress(entries)) {
+                return false;
+            }
+            for (auto &logEntry : entries) {
+                this->unaccount(logEntry);
+            }
+            this->mNumberOfBytes += chain[segment].getNumberOfReservedBytes();
+            this->mNumberOfBytes -= reservedBytes;
+            return true;
+        } catch (...) {
+            // We could not allocate the memory for encoding, the segment remains as it is
+            return false;
+        }
+    }
+
+    bool LogBuffer::thaw(LogLevel logLevel, size_t segment) const noexcept {
+        auto &chain = this->mChains[logLevel];
+        if (!chain[segment].isCompressed()) {
+            return true;
+        }
+
+        auto reservedBytes = chain[segment].getNumberOfReservedBytes();
+        if (!chain[segment].thaw()) {
+            return false;
+        }
+        this->mNumberOfBytes += chain[segment].getNumberOfReservedBytes();
+        this->mNumberOfBytes -= reservedBytes;
+        try {
+            for (auto &logEntry : chain[segment].getEntries()) {
+                this->account(logEntry);
+            }
+        } catch (...) {
+            // The stacktraces of the remaining log entries are not counted
+        }
+        return true;
+    }
+
+}
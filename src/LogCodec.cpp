@@ -0,0 +1,162 @@
+#include <ee/LogCodec.hpp>
+#include <cstring>
+
+namespace ee {
+
+    /**
+     * @brief Appends the raw bytes of the given number.
+     *
+     * @param buffer The buffer to append to.
+     * @param value The number.
+     */
+    template<typename T>
+    static void appendValue(std::string &buffer, T value) {
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief Appends the given string prefixed by its length.
+     *
+     * @param buffer The buffer to append to.
+     * @param string The string.
+     */
+    static void appendString(std::string &buffer, const std::string &string) {
+        appendValue(buffer, static_cast<uint32_t>(string.size()));
+        buffer += string;
+    }
+
+    /**
+     * @brief Reads the fields of a record and never reads behind its end.
+     */
+    class RecordReader {
+    public:
+        RecordReader(const char *data, size_t size) noexcept : mData(data), mSize(size) {}
+
+        template<typename T>
+        bool read(T &value) noexcept {
+            if (this->mSize - this->mPosition < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, this->mData + this->mPosition, sizeof(T));
+            this->mPosition += sizeof(T);
+            return true;
+        }
+
+        bool read(std::string &string) {
+            uint32_t length = 0;
+            if (!this->read(length) || this->mSize - this->mPosition < length) {
+                return false;
+            }
+            string.assign(this->mData + this->mPosition, length);
+            this->mPosition += length;
+            return true;
+        }
+
+    private:
+        const char *mData;
+        size_t mSize;
+        size_t mPosition = 0;
+    };
+
+    void LogCodec::encode(std::string &buffer, const LogEntry &logEntry, size_t threadHash) {
+        appendValue(buffer, Version);
+        appendValue(buffer, static_cast<uint8_t>(logEntry.getLogLevel()));
+        appendValue(buffer, static_cast<uint64_t>(threadHash));
+        appendValue(buffer, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                logEntry.getDateOfCreation().time_since_epoch()).count()));
+        appendValue(buffer, logEntry.getSequenceNumber());
+        appendString(buffer, logEntry.getClassname());
+        appendString(buffer, logEntry.getMethod());
+        appendString(buffer, logEntry.getMessage());
+
+        appendValue(buffer, static_cast<uint32_t>(logEntry.getNotes().size()));
+        for (auto &note : logEntry.getNotes()) {
+            appendString(buffer, note.getName());
+            appendString(buffer, note.getValue());
+            appendString(buffer, note.getCaller());
+        }
+
+        // Only the resolved lines are stored, decoding can share them with the previous log entry again
+        auto &stacktrace = logEntry.getStacktrace();
+        if (stacktrace.has_value() && stacktrace.value()) {
+            appendValue(buffer, static_cast<uint32_t>(stacktrace.value()->getLines().size()));
+            for (auto &line : stacktrace.value()->getLines()) {
+                appendValue(buffer, static_cast<uint16_t>(line.first));
+                appendString(buffer, line.second);
+            }
+        } else {
+            appendValue(buffer, UINT32_MAX);
+        }
+    }
+
+    std::optional<LogEntry> LogCodec::decode(
+            const char *data,
+            size_t size,
+            size_t &threadHash,
+            const LogEntry *previous) noexcept {
+        try {
+            RecordReader reader(data, size);
+            uint8_t version = 0;
+            uint8_t logLevel = 0;
+            uint64_t hash = 0;
+            int64_t nanoseconds = 0;
+            uint64_t sequenceNumber = 0;
+            std::string classname, method, message;
+            if (!reader.read(version) || version != Version ||
+                !reader.read(logLevel) || logLevel > LogLevel::Fatal ||
+                !reader.read(hash) || !reader.read(nanoseconds) || !reader.read(sequenceNumber) ||
+                !reader.read(classname) || !reader.read(method) || !reader.read(message)) {
+                return std::nullopt;
+            }
+
+            uint32_t numberOfNotes = 0;
+            if (!reader.read(numberOfNotes)) {
+                return std::nullopt;
+            }
+            std::vector<Note> notes;
+            for (uint32_t i = 0; i < numberOfNotes; i++) {
+                std::string name, value, caller;
+                if (!reader.read(name) || !reader.read(value) || !reader.read(caller)) {
+                    return std::nullopt;
+                }
+                notes.emplace_back(std::move(name), std::move(value), std::move(caller));
+            }
+
+            uint32_t numberOfLines = 0;
+            if (!reader.read(numberOfLines)) {
+                return std::nullopt;
+            }
+            std::optional<std::shared_ptr<Stacktrace>> stacktrace;
+            if (numberOfLines != UINT32_MAX) {
+                std::map<unsigned short, std::string> lines;
+                for (uint32_t i = 0; i < numberOfLines; i++) {
+                    uint16_t index = 0;
+                    std::string line;
+                    if (!reader.read(index) || !reader.read(line)) {
+                        return std::nullopt;
+                    }
+                    lines.emplace(index, std::move(line));
+                }
+
+                // Log entries created in a loop shared their stacktrace before they were encoded
+                if (previous != nullptr && previous->getStacktrace().has_value() && previous->getStacktrace().value() &&
+                    previous->getStacktrace().value()->getLines() == lines) {
+                    stacktrace = previous->getStacktrace();
+                } else {
+                    stacktrace = std::make_shared<Stacktrace>(std::move(lines));
+                }
+            }
+
+            threadHash = static_cast<size_t>(hash);
+            return LogEntry(
+                    static_cast<LogLevel>(logLevel), classname, method, message, notes, stacktrace,
+                    std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                            std::chrono::nanoseconds(nanoseconds))),
+                    sequenceNumber);
+        } catch (...) {
+            // We could not allocate the memory for the log entry
+            return std::nullopt;
+        }
+    }
+
+}
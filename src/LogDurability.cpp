@@ -0,0 +1,194 @@
+#include <ee/LogDurability.hpp>
+#include <ee/AsyncWriter.hpp>
+#include <iostream>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ee {
+
+    std::mutex LogDurability::Mutex;
+    std::condition_variable LogDurability::Condition;
+    std::thread LogDurability::Thread;
+    LogDurability::Mode LogDurability::CurrentMode = LogDurability::Mode::None;
+    std::chrono::milliseconds LogDurability::Interval = std::chrono::seconds(1);
+    std::map<std::string, bool> LogDurability::DirtyFiles;
+    bool LogDurability::LostDirtyFile = false;
+    uint64_t LogDurability::RequestedSync = 0;
+    uint64_t LogDurability::CompletedSync = 0;
+    bool LogDurability::Syncing = false;
+    bool LogDurability::SyncResult = true;
+    std::atomic_size_t LogDurability::NumberOfSyncs = 0;
+
+    /**
+     * @brief Ensures the periodic thread is stopped at exit only once.
+     */
+    static std::once_flag atExitFlag;
+
+    /**
+     * @brief Forces the data of the given file to the disk.
+     *
+     * @param filename The name of the file.
+     * @param created True if the file has been created since the last sync, the entry in its folder is synced then.
+     * @return False if the file or its folder could not be synced.
+     */
+    static bool syncFile(const std::string &filename, bool created) noexcept {
+        // Syncing any descriptor of the file writes the data of all of them, a missing file lost what was written
+        int fileDescriptor = ::open(filename.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+#if defined(__APPLE__)
+        bool result = ::fsync(fileDescriptor) == 0;
+#else
+        bool result = ::fdatasync(fileDescriptor) == 0;
+#endif
+        ::close(fileDescriptor);
+        if (!created) {
+            return result;
+        }
+
+        // The data of a new file is lost after a crash unless its name is durable as well
+        std::string folder;
+        try {
+            auto separator = filename.find_last_of('/');
+            folder = separator == std::string::npos ? "." : separator == 0 ? "/" : filename.substr(0, separator);
+        } catch (...) {
+            return false;
+        }
+        fileDescriptor = ::open(folder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+        result = ::fsync(fileDescriptor) == 0 && result;
+        ::close(fileDescriptor);
+        return result;
+    }
+
+    void LogDurability::setMode(Mode mode, const std::chrono::milliseconds &interval) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            CurrentMode = Mode::None;
+        }
+        Condition.notify_all();
+
+        // The periodic thread never calls this method, so joining can not deadlock
+        if (Thread.joinable()) {
+            Thread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            CurrentMode = mode;
+            Interval = interval;
+            if (mode != Mode::Periodic) {
+                return;
+            }
+            try {
+                Thread = std::thread([]() {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    while (CurrentMode == Mode::Periodic) {
+                        // The dirty files are synced without holding our lock, like any other request
+                        auto deadline = std::chrono::steady_clock::now() + Interval;
+                        if (Condition.wait_until(lock, deadline, []() { return CurrentMode != Mode::Periodic; })) {
+                            break;
+                        }
+                        if (DirtyFiles.empty()) {
+                            continue;
+                        }
+                        lock.unlock();
+                        sync();
+                        lock.lock();
+                    }
+                });
+            } catch (...) {
+                // The system could not create another thread, only fatal log entries are synced
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not start periodic sync" << std::endl;
+                return;
+            }
+        }
+
+        // The statics of the logging are created before the program calls us, so they outlive this handler
+        try {
+            std::call_once(atExitFlag, []() {
+                std::atexit([]() {
+                    LogDurability::setMode(Mode::None);
+                });
+            });
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not register exit handler" << std::endl;
+        }
+    }
+
+    LogDurability::Mode LogDurability::getMode() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return CurrentMode;
+    }
+
+    void LogDurability::markDirty(const std::string &filename, bool created) noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        try {
+            DirtyFiles[filename] |= created;
+        } catch (...) {
+            // We can not sync a file we do not know, so the next sync must not claim the files are durable
+            LostDirtyFile = true;
+        }
+    }
+
+    void LogDurability::markRemoved(const std::string &filename) noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        DirtyFiles.erase(filename);
+    }
+
+    bool LogDurability::commit(bool urgent) noexcept {
+        auto mode = getMode();
+        if (mode == Mode::GroupCommit || (urgent && mode == Mode::Periodic)) {
+            return sync();
+        }
+        return true;
+    }
+
+    bool LogDurability::sync() noexcept {
+        std::unique_lock<std::mutex> lock(Mutex);
+
+        // A sync that is already running may have missed our files, so we need one that starts after this point
+        auto request = ++RequestedSync;
+        while (CompletedSync < request) {
+            if (Syncing) {
+                Condition.wait(lock);
+                continue;
+            }
+
+            // We sync on behalf of everybody who requested a sync so far
+            Syncing = true;
+            auto covered = RequestedSync;
+            std::map<std::string, bool> files;
+            files.swap(DirtyFiles);
+            bool result = !LostDirtyFile;
+            LostDirtyFile = false;
+            lock.unlock();
+            AsyncWriter::flush();
+            for (auto &file : files) {
+                result = syncFile(file.first, file.second) && result;
+            }
+            lock.lock();
+            Syncing = false;
+            CompletedSync = covered;
+            SyncResult = result;
+            NumberOfSyncs++;
+            Condition.notify_all();
+        }
+        return SyncResult;
+    }
+
+    size_t LogDurability::getNumberOfDirtyFiles() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return DirtyFiles.size();
+    }
+
+    size_t LogDurability::getNumberOfSyncs() noexcept {
+        return NumberOfSyncs;
+    }
+
+}
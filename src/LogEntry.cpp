@@ -1,4 +1,6 @@
 #include <ee/LogEntry.hpp>
+#include <ee/Formatter.hpp>
+#include <ee/Helper.hpp>
 #include <ostream>
 
 namespace ee {
@@ -27,14 +29,16 @@ namespace ee {
             const std::string &message,
             const std::vector<Note>& notes,
             const std::optional<std::shared_ptr<Stacktrace>>& stacktrace,
-            const std::chrono::system_clock::time_point& dateOfCreation) noexcept :
+            const std::chrono::system_clock::time_point& dateOfCreation,
+            uint64_t sequenceNumber) :
             mLogLevel(logLevel),
             mClassname(classname),
             mMethod(method),
             mMessage(message),
             mNotes(notes),
             mStacktrace(stacktrace),
-            mDateOfCreation(dateOfCreation) {
+            mDateOfCreation(dateOfCreation),
+            mSequenceNumber(sequenceNumber) {
 
     }
 
@@ -66,37 +70,33 @@ namespace ee {
         return this->mDateOfCreation;
     }
 
-    void LogEntry::write(std::ostream &stream) const noexcept {
-        // Prepare dateOfCreation
-        auto dateOfCreation = std::chrono::system_clock::to_time_t(this->mDateOfCreation);
-        std::string dateOfCreationStr = std::ctime(&dateOfCreation);
-
-        // Write first line
-        stream << toString(this->mLogLevel) << " [" << dateOfCreationStr.substr(0, dateOfCreationStr.length()-1) << "] ";
-        if (!this->mMessage.empty()) {
-            stream << this->mMessage;
-        }
-        if (!this->mClassname.empty()) {
-            stream << " ::" << this->mClassname << "::";
-        }
-        if (!this->mMethod.empty()) {
-            stream << " --> " << this->mMethod;
+    size_t LogEntry::getNumberOfBytes() const noexcept {
+        size_t numberOfBytes = sizeof(LogEntry) +
+                Helper::getNumberOfBytes(this->mClassname) +
+                Helper::getNumberOfBytes(this->mMethod) +
+                Helper::getNumberOfBytes(this->mMessage) +
+                this->mNotes.capacity() * sizeof(Note);
+        for (auto &note : this->mNotes) {
+            numberOfBytes += Helper::getNumberOfBytes(note.getName()) +
+                    Helper::getNumberOfBytes(note.getValue()) +
+                    Helper::getNumberOfBytes(note.getCaller());
         }
-        stream << std::endl;
+        return numberOfBytes;
+    }
 
-        // Write the next lines of notes
-        for (auto& note : this->mNotes) {
-            stream << "\t" << note.getName() << ": " << note.getValue();
-            if (!note.getCaller().empty()) {
-                stream << " --> " << note.getCaller();
-            }
-            stream << std::endl;
-        }
+    uint64_t LogEntry::getSequenceNumber() const noexcept {
+        return this->mSequenceNumber;
+    }
 
-        // Write the stacktrace
-        if (this->mStacktrace.has_value()) {
-            stream << "Stacktrace:" << std::endl;
-            stream << this->mStacktrace->get()->asString();
+    void LogEntry::write(std::ostream &stream) const noexcept {
+        try {
+            // Format into a buffer that every thread reuses and write that with a single call
+            thread_local std::string buffer;
+            buffer.clear();
+            Formatter::write(buffer, *this, OutputFormat::String);
+            stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not write log entry" << std::endl;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include <ee/LogIndex.hpp>
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace ee {
+
+    std::atomic_bool LogIndex::Enabled = false;
+
+    /**
+     * @brief The start of every index line.
+     */
+    static const char indexPrefix[] = "{\"eeIndex\":{\"start\":";
+
+    /**
+     * @brief The start of every footer.
+     */
+    static const char footerPrefix[] = "{\"eeFooter\":\"";
+
+    /**
+     * @brief Returns the microseconds since the epoch of the given time point, rounded down or up.
+     *
+     * @param timepoint The time point.
+     * @param up True to round up.
+     * @return The microseconds.
+     */
+    static int64_t toMicroseconds(const std::chrono::system_clock::time_point &timepoint, bool up) noexcept {
+        auto duration = timepoint.time_since_epoch();
+        auto microseconds = up ? std::chrono::ceil<std::chrono::microseconds>(duration)
+                               : std::chrono::floor<std::chrono::microseconds>(duration);
+        return microseconds.count();
+    }
+
+    /**
+     * @brief Skips the given literal.
+     *
+     * @param position The position to parse from, moved behind the literal.
+     * @param end The end of the text.
+     * @param literal The expected literal.
+     * @return False if the text does not continue with the literal.
+     */
+    static bool expect(const char *&position, const char *end, const char *literal) noexcept {
+        auto length = std::strlen(literal);
+        if (static_cast<size_t>(end - position) < length || std::memcmp(position, literal, length) != 0) {
+            return false;
+        }
+        position += length;
+        return true;
+    }
+
+    /**
+     * @brief Parses a decimal number that may be negative.
+     *
+     * @param position The position to parse from, moved behind the number.
+     * @param end The end of the text.
+     * @param value Receives the number, negative numbers wrap around for unsigned values.
+     * @return False if the text does not continue with a number.
+     */
+    template<typename T>
+    static bool parse(const char *&position, const char *end, T &value) noexcept {
+        bool negative = position != end && *position == '-';
+        auto digits = position + (negative ? 1 : 0);
+        uint64_t number = 0;
+        auto current = digits;
+        while (current != end && *current >= '0' && *current <= '9') {
+            number = number * 10 + static_cast<uint64_t>(*current - '0');
+            current++;
+        }
+        if (current == digits) {
+            return false;
+        }
+        value = static_cast<T>(negative ? 0 - number : number);
+        position = current;
+        return true;
+    }
+
+    /**
+     * @brief Parses an index line.
+     *
+     * @param line The index line without the line break.
+     * @param start Receives the position where the merge of the index line started.
+     * @param previous Receives the position of the previous index line of the merge or -1.
+     * @param blocks Receives the blocks.
+     * @return False if the line is no index line.
+     */
+    static bool parseIndex(const std::string &line, int64_t &start, int64_t &previous,
+                           std::vector<LogIndex::Block> &blocks) {
+        auto position = line.data();
+        auto end = line.data() + line.size();
+        if (!expect(position, end, indexPrefix) || !parse(position, end, start) ||
+            !expect(position, end, ",\"previous\":") || !parse(position, end, previous) ||
+            !expect(position, end, ",\"blocks\":[")) {
+            return false;
+        }
+        while (expect(position, end, "[")) {
+            LogIndex::Block block{};
+            int64_t since = 0, until = 0;
+            unsigned logLevels = 0;
+            if (!parse(position, end, block.offset) || !expect(position, end, ",") ||
+                !parse(position, end, block.size) || !expect(position, end, ",") ||
+                !parse(position, end, since) || !expect(position, end, ",") ||
+                !parse(position, end, until) || !expect(position, end, ",") ||
+                !parse(position, end, logLevels) || !expect(position, end, ",[")) {
+                return false;
+            }
+            size_t threadHash = 0;
+            while (parse(position, end, threadHash)) {
+                block.threadHashes.push_back(threadHash);
+                expect(position, end, ",");
+            }
+            if (!expect(position, end, "]]")) {
+                return false;
+            }
+            block.since = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(since)));
+            block.until = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(until)));
+            block.logLevels = static_cast<uint8_t>(logLevels);
+            blocks.push_back(std::move(block));
+            expect(position, end, ",");
+        }
+        return expect(position, end, "]}}") && position == end;
+    }
+
+    /**
+     * @brief Reads the bytes of a file at the given position.
+     *
+     * @param fileDescriptor The descriptor of the file.
+     * @param offset The position of the first byte.
+     * @param data Receives the bytes.
+     * @param size The number of bytes.
+     * @return The number of bytes read, fewer at the end of the file.
+     */
+    static size_t readAt(int fileDescriptor, uint64_t offset, char *data, size_t size) noexcept {
+        size_t done = 0;
+        while (done < size) {
+            auto result = ::pread(fileDescriptor, data + done, size - done, static_cast<off_t>(offset + done));
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                break;
+            }
+            done += static_cast<size_t>(result);
+        }
+        return done;
+    }
+
+    /**
+     * @brief Reads the line that starts at the given position.
+     *
+     * @param fileDescriptor The descriptor of the file.
+     * @param offset The position of the first byte of the line.
+     * @param line Receives the line without the line break.
+     * @return False if the line does not end within MaxIndexSize bytes.
+     */
+    static bool readLine(int fileDescriptor, uint64_t offset, std::string &line) {
+        char piece[4096];
+        line.clear();
+        while (line.size() < LogIndex::MaxIndexSize) {
+            auto size = readAt(fileDescriptor, offset + line.size(), piece, sizeof(piece));
+            auto lineBreak = static_cast<const char *>(std::memchr(piece, '\n', size));
+            if (lineBreak != nullptr) {
+                line.append(piece, static_cast<size_t>(lineBreak - piece));
+                return true;
+            }
+            if (size < sizeof(piece)) {
+                return false;
+            }
+            line.append(piece, size);
+        }
+        return false;
+    }
+
+    void LogIndex::setEnabled(bool enabled) noexcept {
+        Enabled = enabled;
+    }
+
+    bool LogIndex::isEnabled() noexcept {
+        return Enabled;
+    }
+
+    LogIndex::LogIndex(FileSink &sink) noexcept : mSink(sink), mStart(sink.getPosition()) {}
+
+    void LogIndex::add(const LogEntry &logEntry, size_t threadHash) noexcept {
+        if (this->mFailed) {
+            return;
+        }
+        try {
+            // A block only ends where the sink moved on, the log entries of a chunk formatted at once share one block
+            auto position = this->mSink.getPosition();
+            if (this->mBlocks.empty() || this->mSplit ||
+                (this->mNumberOfLogEntries >= EntriesPerBlock && position != this->mBlocks.back().offset)) {
+                if (!this->mBlocks.empty()) {
+                    this->mBlocks.back().size = position - this->mBlocks.back().offset;
+                    if (this->mBlocks.size() >= BlocksPerIndex) {
+                        this->writeIndex();
+                        position = this->mSink.getPosition();
+                    }
+                }
+                auto &dateOfCreation = logEntry.getDateOfCreation();
+                this->mBlocks.push_back({position, 0, dateOfCreation, dateOfCreation, 0, {}});
+                this->mNumberOfLogEntries = 0;
+                this->mSplit = false;
+            }
+
+            // The thread hashes stay sorted, so a reader can search them
+            auto &block = this->mBlocks.back();
+            block.since = std::min(block.since, logEntry.getDateOfCreation());
+            block.until = std::max(block.until, logEntry.getDateOfCreation());
+            block.logLevels |= static_cast<uint8_t>(1u << logEntry.getLogLevel());
+            auto threadHashes = std::lower_bound(block.threadHashes.begin(), block.threadHashes.end(), threadHash);
+            if (threadHashes == block.threadHashes.end() || *threadHashes != threadHash) {
+                block.threadHashes.insert(threadHashes, threadHash);
+            }
+            this->mNumberOfLogEntries++;
+        } catch (...) {
+            // The log entries are still written, but the merge ends without a footer
+            this->mFailed = true;
+        }
+    }
+
+    void LogIndex::split() noexcept {
+        this->mSplit = true;
+    }
+
+    bool LogIndex::finish() noexcept {
+        if (this->mFailed || this->mBlocks.empty()) {
+            return false;
+        }
+        try {
+            this->mBlocks.back().size = this->mSink.getPosition() - this->mBlocks.back().offset;
+            this->writeIndex();
+
+            // The footer has a fixed size, so a reader finds it at the end of the file
+            char footer[FooterSize + 1];
+            std::snprintf(footer, sizeof(footer), "%s%020" PRIu64 "\"}\n", footerPrefix,
+                          static_cast<uint64_t>(this->mPrevious));
+            this->mSink.getBuffer().append(footer, FooterSize);
+            this->mSink.commit();
+        } catch (...) {
+            this->mFailed = true;
+            return false;
+        }
+        return true;
+    }
+
+    void LogIndex::writeIndex() {
+        auto position = this->mSink.getPosition();
+        auto &buffer = this->mSink.getBuffer();
+        buffer += indexPrefix;
+        buffer += std::to_string(this->mStart);
+        buffer += ",\"previous\":";
+        buffer += std::to_string(this->mPrevious);
+        buffer += ",\"blocks\":[";
+        for (size_t i = 0; i < this->mBlocks.size(); i++) {
+            auto &block = this->mBlocks[i];
+            buffer += i == 0 ? "[" : ",[";
+            buffer += std::to_string(block.offset);
+            buffer += ',';
+            buffer += std::to_string(block.size);
+            buffer += ',';
+            buffer += std::to_string(toMicroseconds(block.since, false));
+            buffer += ',';
+            buffer += std::to_string(toMicroseconds(block.until, true));
+            buffer += ',';
+            buffer += std::to_string(block.logLevels);
+            buffer += ",[";
+            for (size_t j = 0; j < block.threadHashes.size(); j++) {
+                if (j > 0) {
+                    buffer += ',';
+                }
+                buffer += std::to_string(block.threadHashes[j]);
+            }
+            buffer += "]]";
+        }
+        buffer += "]}}\n";
+        this->mSink.commit();
+        this->mPrevious = static_cast<int64_t>(position);
+        this->mBlocks.clear();
+    }
+
+    bool LogIndex::readBlocks(const std::string &filename, std::vector<Block> &blocks) noexcept {
+        int fileDescriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+        struct stat status{};
+        if (::fstat(fileDescriptor, &status) != 0) {
+            ::close(fileDescriptor);
+            return false;
+        }
+
+        bool result = false;
+        try {
+            // Every merge ends with a footer, the first index line of a merge leads to the footer of the one before
+            auto end = static_cast<uint64_t>(status.st_size);
+            std::string line;
+            while (end >= FooterSize) {
+                char footer[FooterSize];
+                const char *position = footer;
+                uint64_t index = 0;
+                if (readAt(fileDescriptor, end - FooterSize, footer, FooterSize) != FooterSize ||
+                    !expect(position, footer + FooterSize, footerPrefix) ||
+                    !parse(position, footer + FooterSize, index) || position != footer + FooterSize - 3 ||
+                    !expect(position, footer + FooterSize, "\"}\n") || index >= end - FooterSize) {
+                    break;
+                }
+
+                // The index lines of a merge point backwards, so every step has to move towards the start
+                int64_t start = 0;
+                auto next = static_cast<int64_t>(index);
+                while (next >= 0) {
+                    int64_t previous = -1;
+                    if (!readLine(fileDescriptor, static_cast<uint64_t>(next), line) ||
+                        !parseIndex(line, start, previous, blocks) || previous >= next || start > next) {
+                        ::close(fileDescriptor);
+                        return false;
+                    }
+                    next = previous;
+                }
+                result = true;
+                end = static_cast<uint64_t>(start);
+            }
+            std::sort(blocks.begin(), blocks.end(), [](const Block &a, const Block &b) {
+                return a.offset < b.offset;
+            });
+        } catch (...) {
+            result = false;
+        }
+        ::close(fileDescriptor);
+        return result;
+    }
+
+    std::vector<LogIndex::Block> LogIndex::find(
+            const std::string &filename,
+            const std::chrono::system_clock::time_point &since,
+            const std::chrono::system_clock::time_point &until,
+            LogLevel minimum,
+            std::optional<size_t> threadHash) noexcept {
+        std::vector<Block> blocks;
+        if (!readBlocks(filename, blocks)) {
+            return {};
+        }
+
+        // The blocks are filtered in place, so no further memory is needed
+        blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](const Block &block) {
+            return block.until < since || block.since > until || (block.logLevels >> minimum) == 0 ||
+                   (threadHash && !std::binary_search(block.threadHashes.begin(), block.threadHashes.end(),
+                                                      *threadHash));
+        }), blocks.end());
+        return blocks;
+    }
+
+    bool LogIndex::readContent(const std::string &filename, const Block &block, std::string &content) noexcept {
+        int fileDescriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+        bool result = false;
+        try {
+            content.resize(block.size);
+            result = readAt(fileDescriptor, block.offset, content.data(), block.size) == block.size;
+        } catch (...) {
+            // There is not enough memory for the block
+        }
+        ::close(fileDescriptor);
+        return result;
+    }
+
+}
@@ -0,0 +1,242 @@
+#include <ee/LogMerge.hpp>
+#include <ee/Formatter.hpp>
+#include <algorithm>
+#include <optional>
+
+namespace ee {
+
+    std::atomic_size_t LogMerge::NumberOfWorkers =
+            std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), LogMerge::MaxNumberOfWorkers));
+
+    /**
+     * @brief Provides the iterators of the cursor of the spilled log entries, that never uses them.
+     */
+    static const LogBuffer noLogEntries;
+
+    /**
+     * @brief A log entry of a chunk and the hash of the id of its thread.
+     */
+    typedef std::pair<size_t, const LogEntry *> ChunkEntry;
+
+    /**
+     * @brief Formats the given log entries like LogMerge::write() does.
+     *
+     * @param buffer The buffer to append to.
+     * @param begin The first log entry.
+     * @param end Behind the last log entry.
+     * @param format The output format to use.
+     */
+    static void formatChunk(std::string &buffer, const ChunkEntry *begin, const ChunkEntry *end, OutputFormat format) {
+        for (auto logEntry = begin; logEntry != end; logEntry++) {
+            Formatter::write(buffer, *logEntry->second, format, logEntry->first);
+            buffer += format == OutputFormat::Json ? "\n" : "\n\n";
+        }
+    }
+
+    const LogEntry &LogMerge::Cursor::get() const noexcept {
+        return this->spilled != nullptr ? this->spilled->second : *this->current;
+    }
+
+    bool LogMerge::Cursor::advance() noexcept {
+        if (this->spilled != nullptr) {
+            if (++this->spilled == this->spilledEnd) {
+                return false;
+            }
+            this->threadHash = this->spilled->first;
+            return true;
+        }
+        return ++this->current != this->end;
+    }
+
+    LogMerge::LogMerge(
+            const std::map<std::thread::id, LogBuffer> &threads,
+            const SpilledLogEntries *spilled,
+            bool incremental) :
+            mCurrent(SIZE_MAX), mNumberOfLogEntries(0) {
+        this->mCursors.reserve(threads.size() + 1);
+        for (auto &thread : threads) {
+            // The log entries below the watermark have been written before and their segments stay compressed
+            auto &buffer = thread.second;
+            auto begin = incremental ? buffer.begin(buffer.getWatermark()) : buffer.begin();
+            if (begin != buffer.end()) {
+                this->mNumberOfLogEntries += incremental ? buffer.size(buffer.getWatermark()) : buffer.size();
+                this->mCursors.push_back(
+                        {begin, buffer.end(), nullptr, nullptr, std::hash<std::thread::id>()(thread.first)});
+            }
+        }
+        if (spilled != nullptr && !spilled->empty()) {
+            this->mNumberOfLogEntries += spilled->size();
+            auto none = noLogEntries.end();
+            this->mCursors.push_back(
+                    {none, none, spilled->data(), spilled->data() + spilled->size(), spilled->front().first});
+        }
+
+        // The heap never grows beyond the number of cursors
+        this->mHeap.reserve(this->mCursors.size());
+        for (size_t i = 0; i < this->mCursors.size(); i++) {
+            this->mHeap.push_back(i);
+        }
+        std::make_heap(this->mHeap.begin(), this->mHeap.end(), [this](size_t a, size_t b) {
+            return this->later(a, b);
+        });
+    }
+
+    const LogEntry *LogMerge::next(size_t &threadHash) noexcept {
+        auto later = [this](size_t a, size_t b) {
+            return this->later(a, b);
+        };
+
+        // The cursor of the previous log entry is advanced only now, so that log entry stayed valid until here
+        if (this->mCurrent != SIZE_MAX && this->mCursors[this->mCurrent].advance()) {
+            this->mHeap.push_back(this->mCurrent);
+            std::push_heap(this->mHeap.begin(), this->mHeap.end(), later);
+        }
+        this->mCurrent = SIZE_MAX;
+        if (this->mHeap.empty()) {
+            return nullptr;
+        }
+
+        std::pop_heap(this->mHeap.begin(), this->mHeap.end(), later);
+        this->mCurrent = this->mHeap.back();
+        this->mHeap.pop_back();
+        auto &cursor = this->mCursors[this->mCurrent];
+        threadHash = cursor.threadHash;
+        return &cursor.get();
+    }
+
+    void LogMerge::write(FileSink &sink, OutputFormat format) {
+        std::optional<LogIndex> index;
+        if (LogIndex::isEnabled()) {
+            index.emplace(sink);
+        }
+
+        // Small merges are not worth starting a thread
+        auto numberOfWorkers = std::min<size_t>(NumberOfWorkers, this->mNumberOfLogEntries / ChunkSize);
+        if (numberOfWorkers > 1 && this->mCurrent == SIZE_MAX &&
+            this->writeParallel(sink, format, numberOfWorkers, index ? &*index : nullptr)) {
+            if (index) {
+                index->finish();
+            }
+            return;
+        }
+
+        auto &buffer = sink.getBuffer();
+        size_t threadHash = 0;
+        for (auto logEntry = this->next(threadHash); logEntry != nullptr; logEntry = this->next(threadHash)) {
+            if (index) {
+                index->add(*logEntry, threadHash);
+            }
+            Formatter::write(buffer, *logEntry, format, threadHash);
+            buffer += format == OutputFormat::Json ? "\n" : "\n\n";
+            sink.commit();
+        }
+        if (index) {
+            index->finish();
+        }
+    }
+
+    void LogMerge::setNumberOfWorkers(size_t numberOfWorkers) noexcept {
+        NumberOfWorkers = std::max<size_t>(1, std::min(numberOfWorkers, MaxNumberOfWorkers));
+    }
+
+    size_t LogMerge::getNumberOfWorkers() noexcept {
+        return NumberOfWorkers;
+    }
+
+    bool LogMerge::writeParallel(FileSink &sink, OutputFormat format, size_t numberOfWorkers, LogIndex *index) {
+        // Everything is allocated up front, so we can still fall back to a single thread
+        std::vector<ChunkEntry> logEntries;
+        std::vector<std::string> buffers;
+        std::vector<std::thread> workers;
+        std::vector<char> failed;
+        try {
+            logEntries.reserve(numberOfWorkers * ChunkSize);
+            buffers.resize(numberOfWorkers);
+            failed.resize(numberOfWorkers);
+            workers.reserve(numberOfWorkers - 1);
+        } catch (...) {
+            return false;
+        }
+
+        while (true) {
+            // The pointers stay valid after the cursors moved on, the buffers are not modified during the merge
+            logEntries.clear();
+            size_t threadHash = 0;
+            while (logEntries.size() < logEntries.capacity()) {
+                auto logEntry = this->next(threadHash);
+                if (logEntry == nullptr) {
+                    break;
+                }
+                logEntries.emplace_back(threadHash, logEntry);
+            }
+            if (logEntries.empty()) {
+                return true;
+            }
+
+            // Every worker formats a contiguous range of the chunk, the calling thread takes the first one
+            auto chunkSize = (logEntries.size() + numberOfWorkers - 1) / numberOfWorkers;
+            auto chunk = [&](size_t index) {
+                auto begin = std::min(index * chunkSize, logEntries.size());
+                auto end = std::min(begin + chunkSize, logEntries.size());
+                formatChunk(buffers[index], logEntries.data() + begin, logEntries.data() + end, format);
+            };
+            size_t started = 0;
+            for (size_t i = 1; i < numberOfWorkers; i++) {
+                try {
+                    workers.emplace_back([&chunk, &failed, &buffers, i]() {
+                        try {
+                            chunk(i);
+                        } catch (...) {
+                            // The calling thread formats the chunk again
+                            buffers[i].clear();
+                            failed[i] = true;
+                        }
+                    });
+                    started = i;
+                } catch (...) {
+                    break;
+                }
+            }
+
+            // The chunks of the threads that could not be created are formatted here
+            chunk(0);
+            for (size_t i = started + 1; i < numberOfWorkers; i++) {
+                chunk(i);
+            }
+            for (auto &worker : workers) {
+                worker.join();
+            }
+            workers.clear();
+            for (size_t i = 1; i <= started; i++) {
+                if (failed[i]) {
+                    failed[i] = false;
+                    chunk(i);
+                }
+            }
+
+            // The buffers keep their capacity for the next round, every chunk becomes a block of the index
+            for (size_t i = 0; i < numberOfWorkers; i++) {
+                auto begin = std::min(i * chunkSize, logEntries.size());
+                auto end = std::min(begin + chunkSize, logEntries.size());
+                if (index != nullptr && begin != end) {
+                    index->split();
+                    for (auto logEntry = begin; logEntry != end; logEntry++) {
+                        index->add(*logEntries[logEntry].second, logEntries[logEntry].first);
+                    }
+                }
+                sink.write(buffers[i].data(), buffers[i].size());
+                buffers[i].clear();
+            }
+        }
+    }
+
+    bool LogMerge::later(size_t a, size_t b) const noexcept {
+        auto &first = this->mCursors[a].get();
+        auto &second = this->mCursors[b].get();
+        if (first.getDateOfCreation() != second.getDateOfCreation()) {
+            return first.getDateOfCreation() > second.getDateOfCreation();
+        }
+        return first.getSequenceNumber() > second.getSequenceNumber();
+    }
+
+}
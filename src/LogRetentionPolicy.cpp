@@ -1,18 +1,66 @@
 #include <ee/LogEntry.hpp>
 #include <ee/LogRetentionPolicy.hpp>
+#include <algorithm>
 
 namespace ee {
 
-    LogRetentionPolicy::LogRetentionPolicy(uint8_t priority) noexcept : mPriority(priority) {
+    LogRetentionPolicy::LogRetentionPolicy(uint8_t priority, LogLevel minLogLevel, LogLevel maxLogLevel) noexcept :
+    mPriority(priority), mMinLogLevel(minLogLevel), mMaxLogLevel(maxLogLevel) {
 
     }
 
-    LogRetentionMaxNumber::LogRetentionMaxNumber(size_t maxNumber) noexcept :
-    LogRetentionPolicy(255), mMaxNumberOfLogs(maxNumber) {
+    bool LogRetentionPolicy::releaseSegment(const LogSegment &/*segment*/) noexcept {
+        return false;
+    }
+
+    bool LogRetentionPolicy::retainSegment(const LogSegment &/*segment*/) noexcept {
+        return false;
+    }
+
+    void LogRetentionPolicy::enterSegment(const LogSegment &/*segment*/) noexcept {
+
+    }
+
+    size_t LogRetentionPolicy::releaseSpan(const LogEntry *entries, size_t size) noexcept {
+        for (size_t i = size; i-- > 0;) {
+            if (!this->retain(entries[i])) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    bool LogRetentionPolicy::isGlobal() const noexcept {
+        return false;
+    }
+
+    LogLevel LogRetentionPolicy::getMinLogLevel() const noexcept {
+        return this->mMinLogLevel;
+    }
+
+    LogLevel LogRetentionPolicy::getMaxLogLevel() const noexcept {
+        return this->mMaxLogLevel;
+    }
 
+    bool LogRetentionPolicy::appliesTo(LogLevel logLevel) const noexcept {
+        return this->mMinLogLevel <= logLevel && logLevel <= this->mMaxLogLevel;
     }
 
-    bool ee::LogRetentionMaxNumber::retain(const LogEntry &logEntry) noexcept {
+    LogRetentionMaxNumber::LogRetentionMaxNumber(size_t maxNumber, LogLevel minLogLevel, LogLevel maxLogLevel) noexcept :
+    LogRetentionMaxNumber(255, maxNumber, minLogLevel, maxLogLevel) {
+
+    }
+
+    LogRetentionMaxNumber::LogRetentionMaxNumber(
+            uint8_t priority,
+            size_t maxNumber,
+            LogLevel minLogLevel,
+            LogLevel maxLogLevel) noexcept :
+    LogRetentionPolicy(priority, minLogLevel, maxLogLevel), mMaxNumberOfLogs(maxNumber) {
+
+    }
+
+    bool ee::LogRetentionMaxNumber::retain(const LogEntry &/*logEntry*/) noexcept {
         return this->mCounter++ < this->mMaxNumberOfLogs;
     }
 
@@ -20,8 +68,30 @@ namespace ee {
         this->mCounter = 0;
     }
 
-    LogRetentionOlderThan::LogRetentionOlderThan(const std::chrono::milliseconds& lifetime) noexcept :
-    LogRetentionPolicy(0), mLifetime(lifetime) {
+    bool LogRetentionMaxNumber::releaseSegment(const LogSegment &/*segment*/) noexcept {
+        return this->mCounter >= this->mMaxNumberOfLogs;
+    }
+
+    bool LogRetentionMaxNumber::retainSegment(const LogSegment &segment) noexcept {
+        if (this->mCounter + segment.size() > this->mMaxNumberOfLogs) {
+            return false;
+        }
+        this->mCounter += segment.size();
+        return true;
+    }
+
+    size_t LogRetentionMaxNumber::releaseSpan(const LogEntry * /*entries*/, size_t size) noexcept {
+        auto remaining = this->mCounter < this->mMaxNumberOfLogs ? this->mMaxNumberOfLogs - this->mCounter : 0;
+        auto retained = std::min(size, remaining);
+        this->mCounter += retained;
+        return size - retained;
+    }
+
+    LogRetentionOlderThan::LogRetentionOlderThan(
+            const std::chrono::milliseconds& lifetime,
+            LogLevel minLogLevel,
+            LogLevel maxLogLevel) noexcept :
+    LogRetentionPolicy(0, minLogLevel, maxLogLevel), mLifetime(lifetime) {
 
     }
 
@@ -34,4 +104,104 @@ namespace ee {
         this->mDatetime = std::chrono::system_clock::now() - this->mLifetime;
     }
 
+    bool LogRetentionOlderThan::releaseSegment(const LogSegment &segment) noexcept {
+        return segment.getMaxDateOfCreation() < this->mDatetime;
+    }
+
+    bool LogRetentionOlderThan::retainSegment(const LogSegment &segment) noexcept {
+        return this->mDatetime <= segment.getMinDateOfCreation();
+    }
+
+    size_t LogRetentionOlderThan::releaseSpan(const LogEntry *entries, size_t size) noexcept {
+        // The system clock can go backwards, so we can not search the dates and cut at the youngest too old log entry
+        for (size_t i = size; i-- > 0;) {
+            if (entries[i].getDateOfCreation() < this->mDatetime) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    LogRetentionMaxBytes::LogRetentionMaxBytes(size_t maxBytes, LogLevel minLogLevel, LogLevel maxLogLevel) noexcept :
+    LogRetentionPolicy(254, minLogLevel, maxLogLevel), mMaxBytes(maxBytes) {
+
+    }
+
+    void LogRetentionMaxBytes::init() noexcept {
+        this->mBytes = 0;
+        this->mReservedEntries = 0;
+        this->mStacktraces.clear();
+    }
+
+    bool LogRetentionMaxBytes::retain(const LogEntry &logEntry) noexcept {
+        // The budget is consumed by released log entries too, so only the youngest log entries are retained
+        this->mBytes += logEntry.getNumberOfBytes();
+        if (this->mReservedEntries > 0) {
+            // The slot of the log entry was counted with its segment
+            this->mReservedEntries--;
+            this->mBytes -= sizeof(LogEntry);
+        }
+
+        auto &stacktrace = logEntry.getStacktrace();
+        if (stacktrace.has_value() && stacktrace.value()) {
+            try {
+                if (this->mStacktraces.insert(stacktrace.value().get()).second) {
+                    this->mBytes += stacktrace.value()->getNumberOfBytes();
+                }
+            } catch (...) {
+                // Without memory to remember it we count the stacktrace again, that never exceeds the budget
+                this->mBytes += stacktrace.value()->getNumberOfBytes();
+            }
+        }
+        return this->mBytes <= this->mMaxBytes;
+    }
+
+    bool LogRetentionMaxBytes::releaseSegment(const LogSegment &/*segment*/) noexcept {
+        return this->mBytes >= this->mMaxBytes;
+    }
+
+    bool LogRetentionMaxBytes::retainSegment(const LogSegment &segment) noexcept {
+        // A compressed segment holds nothing but its block, the log entries of the others fill part of the capacity
+        auto numberOfBytes = sizeof(LogSegment) + segment.getNumberOfReservedBytes();
+        if (!segment.isCompressed()) {
+            numberOfBytes += segment.getNumberOfBytes() - segment.size() * sizeof(LogEntry);
+        }
+        if (this->mBytes + numberOfBytes > this->mMaxBytes) {
+            return false;
+        }
+        this->mBytes += numberOfBytes;
+        return true;
+    }
+
+    void LogRetentionMaxBytes::enterSegment(const LogSegment &segment) noexcept {
+        // Released log entries keep their slots until the whole segment is released
+        this->mBytes += sizeof(LogSegment) + segment.getNumberOfReservedBytes();
+        this->mReservedEntries += segment.size();
+    }
+
+    size_t LogRetentionMaxBytes::releaseSpan(const LogEntry *entries, size_t size) noexcept {
+        for (size_t i = size; i-- > 0;) {
+            if (!LogRetentionMaxBytes::retain(entries[i])) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    bool LogRetentionMaxBytes::isGlobal() const noexcept {
+        return true;
+    }
+
+    LogRetentionGlobalMaxNumber::LogRetentionGlobalMaxNumber(
+            size_t maxNumber,
+            LogLevel minLogLevel,
+            LogLevel maxLogLevel) noexcept :
+    LogRetentionMaxNumber(253, maxNumber, minLogLevel, maxLogLevel) {
+
+    }
+
+    bool LogRetentionGlobalMaxNumber::isGlobal() const noexcept {
+        return true;
+    }
+
 }
@@ -0,0 +1,357 @@
+#include <ee/LogRotation.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/LogDurability.hpp>
+#include <ee/IncidentWriter.hpp>
+#include <ee/LzCodec.hpp>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace ee {
+
+    std::mutex LogRotation::Mutex;
+    std::condition_variable LogRotation::Condition;
+    std::condition_variable LogRotation::Compressed;
+    std::thread LogRotation::Thread;
+    bool LogRotation::Running = false;
+    std::deque<std::string> LogRotation::Queue;
+    size_t LogRotation::NumberOfPendingFiles = 0;
+    size_t LogRotation::MaxFileSize = 0;
+    std::chrono::seconds LogRotation::MaxFileAge = std::chrono::seconds::zero();
+    size_t LogRotation::MaxTotalSize = 0;
+    std::atomic_size_t LogRotation::NumberOfCompressedFiles = 0;
+
+    /**
+     * @brief The magic bytes at the beginning of a compressed file.
+     */
+    static const char magic[8] = {'E', 'E', 'L', 'Z', '0', '0', '0', '1'};
+
+    /**
+     * @brief The prefix of the names of all log files.
+     */
+    static const char filePrefix[] = "ee-log-";
+
+    /**
+     * @brief Ensures the rotation is stopped at exit only once.
+     */
+    static std::once_flag atExitFlag;
+
+    /**
+     * @brief Reads up to the given number of bytes and retries interrupted calls.
+     *
+     * @param fileDescriptor The file to read from.
+     * @param data The buffer to read into.
+     * @param size The number of bytes to read.
+     * @return The number of bytes read, less than requested at the end of the file, or -1 on errors.
+     */
+    static ssize_t readFully(int fileDescriptor, char *data, size_t size) noexcept {
+        size_t total = 0;
+        while (total < size) {
+            auto result = ::read(fileDescriptor, data + total, size - total);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result < 0) {
+                return -1;
+            }
+            if (result == 0) {
+                break;
+            }
+            total += static_cast<size_t>(result);
+        }
+        return static_cast<ssize_t>(total);
+    }
+
+    void LogRotation::start(
+            size_t maxFileSize,
+            const std::chrono::seconds &maxFileAge,
+            size_t maxTotalSize) noexcept {
+        stop();
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Thread.joinable()) {
+                // Another caller started the rotation meanwhile
+                return;
+            }
+            MaxFileSize = maxFileSize;
+            MaxFileAge = maxFileAge;
+            MaxTotalSize = maxTotalSize;
+            Running = true;
+            try {
+                Thread = std::thread([]() {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    while (true) {
+                        Condition.wait(lock, []() { return !Running || !Queue.empty(); });
+                        if (Queue.empty()) {
+                            // We only stop after the queue is drained
+                            break;
+                        }
+                        auto filename = std::move(Queue.front());
+                        Queue.pop_front();
+                        auto maxTotalSize = MaxTotalSize;
+                        lock.unlock();
+
+                        // The incidents that were submitted before the file was closed still belong into it
+                        IncidentWriter::flush();
+                        FileSink::release(filename);
+                        if (compress(filename)) {
+                            NumberOfCompressedFiles++;
+                        }
+                        if (maxTotalSize > 0) {
+                            auto separator = filename.find_last_of('/');
+                            enforceLimit(separator == std::string::npos ? "." : filename.substr(0, separator),
+                                         maxTotalSize);
+                        }
+
+                        lock.lock();
+                        NumberOfPendingFiles--;
+                        Compressed.notify_all();
+                    }
+                });
+            } catch (...) {
+                // The system could not create another thread, the incident file is not rotated
+                Running = false;
+                std::cerr << __PRETTY_FUNCTION__ << ": Could not start log rotation" << std::endl;
+                return;
+            }
+        }
+
+        // The statics of the logging are created before the program calls us, so they outlive this handler
+        try {
+            std::call_once(atExitFlag, []() {
+                std::atexit([]() {
+                    LogRotation::stop();
+                });
+            });
+        } catch (...) {
+            std::cerr << __PRETTY_FUNCTION__ << ": Could not register exit handler" << std::endl;
+        }
+    }
+
+    void LogRotation::stop() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Running = false;
+        }
+        Condition.notify_all();
+
+        // The rotation thread never calls this method, so joining can not deadlock
+        if (Thread.joinable()) {
+            Thread.join();
+        }
+    }
+
+    bool LogRotation::isRunning() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Running;
+    }
+
+    bool LogRotation::isDue(
+            const std::string &filename,
+            const std::chrono::system_clock::time_point &dateOfCreation) noexcept {
+        size_t maxFileSize = 0;
+        std::chrono::seconds maxFileAge;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (!Running) {
+                return false;
+            }
+            maxFileSize = MaxFileSize;
+            maxFileAge = MaxFileAge;
+        }
+        if (maxFileAge > std::chrono::seconds::zero() &&
+            std::chrono::system_clock::now() - dateOfCreation >= maxFileAge) {
+            return true;
+        }
+        struct stat status{};
+        return maxFileSize > 0 && ::stat(filename.c_str(), &status) == 0 &&
+               static_cast<size_t>(status.st_size) >= maxFileSize;
+    }
+
+    void LogRotation::close(const std::string &filename) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Running) {
+                try {
+                    Queue.push_back(filename);
+                    NumberOfPendingFiles++;
+                    Condition.notify_all();
+                    return;
+                } catch (...) {
+                    // The file stays uncompressed
+                }
+            }
+        }
+        FileSink::release(filename);
+    }
+
+    void LogRotation::flush() noexcept {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Compressed.wait(lock, []() { return NumberOfPendingFiles == 0; });
+    }
+
+    bool LogRotation::compress(const std::string &filename) noexcept {
+        int fileDescriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+
+        std::string target;
+        bool result = false;
+        try {
+            target = filename + Extension;
+            ::unlink(target.c_str());
+            FileSink sink(target);
+            if (sink.open() && sink.write(magic, sizeof(magic))) {
+                // Every block is compressed on its own, so a damaged block does not spoil the rest of the file
+                std::string block(BlockSize, '\0');
+                std::string compressed;
+                result = true;
+                while (result) {
+                    auto size = readFully(fileDescriptor, &block[0], BlockSize);
+                    if (size <= 0) {
+                        result = size == 0;
+                        break;
+                    }
+                    compressed.clear();
+                    LzCodec::compress(block.data(), static_cast<size_t>(size), compressed);
+
+                    // A block that does not shrink is stored as it is, marked by a compressed size of zero
+                    bool stored = compressed.size() >= static_cast<size_t>(size);
+                    uint32_t header[2] = {static_cast<uint32_t>(size),
+                                          stored ? 0 : static_cast<uint32_t>(compressed.size())};
+                    result = sink.write(reinterpret_cast<const char *>(header), sizeof(header)) &&
+                             (stored ? sink.write(block.data(), static_cast<size_t>(size)) :
+                              sink.write(compressed.data(), compressed.size()));
+                }
+
+                // The blocks written in the background have to reach the file before the original may go
+                result = sink.flush() && sink.wait() && result;
+            }
+        } catch (...) {
+            result = false;
+        }
+        ::close(fileDescriptor);
+
+        // Only a completely compressed file replaces the original
+        if (result) {
+            ::unlink(filename.c_str());
+            LogDurability::markRemoved(filename);
+        } else if (!target.empty()) {
+            ::unlink(target.c_str());
+            LogDurability::markRemoved(target);
+        }
+        return result;
+    }
+
+    bool LogRotation::decompress(const std::string &filename, const std::string &target) noexcept {
+        int fileDescriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+
+        bool result = false;
+        try {
+            ::unlink(target.c_str());
+            FileSink sink(target);
+            char header[sizeof(magic)];
+            if (sink.open() && readFully(fileDescriptor, header, sizeof(header)) == sizeof(header) &&
+                std::memcmp(header, magic, sizeof(magic)) == 0) {
+                std::string block;
+                std::string original;
+                result = true;
+                while (result) {
+                    uint32_t sizes[2] = {0, 0};
+                    auto size = readFully(fileDescriptor, reinterpret_cast<char *>(sizes), sizeof(sizes));
+                    if (size == 0) {
+                        break;
+                    }
+                    if (size != sizeof(sizes) || sizes[0] > BlockSize) {
+                        result = false;
+                        break;
+                    }
+                    auto stored = sizes[1] == 0 ? sizes[0] : sizes[1];
+                    block.resize(stored);
+                    if (readFully(fileDescriptor, &block[0], stored) != static_cast<ssize_t>(stored)) {
+                        result = false;
+                        break;
+                    }
+                    if (sizes[1] == 0) {
+                        result = sink.write(block.data(), block.size());
+                    } else {
+                        original.clear();
+                        result = LzCodec::decompress(block.data(), block.size(), sizes[0], original) &&
+                                 sink.write(original.data(), original.size());
+                    }
+                }
+                result = sink.flush() && sink.wait() && result;
+            }
+        } catch (...) {
+            result = false;
+        }
+        ::close(fileDescriptor);
+        return result;
+    }
+
+    size_t LogRotation::enforceLimit(const std::string &folder, size_t maxTotalSize) noexcept {
+        // We list the folder ourselves, a failure must not log a warning that writes another incident
+        DIR *dir = ::opendir(folder.c_str());
+        if (dir == nullptr) {
+            return 0;
+        }
+
+        // The name of every log file carries its date of creation in microseconds
+        struct LogFile {
+            unsigned long long microseconds;
+            std::string name;
+            size_t size;
+        };
+        std::vector<LogFile> files;
+        size_t total = 0;
+        try {
+            struct dirent *entry = nullptr;
+            while ((entry = ::readdir(dir)) != nullptr) {
+                if (std::strncmp(entry->d_name, filePrefix, sizeof(filePrefix) - 1) != 0) {
+                    continue;
+                }
+                auto name = folder + "/" + entry->d_name;
+                struct stat status{};
+                if (::stat(name.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) {
+                    continue;
+                }
+                auto microseconds = std::strtoull(entry->d_name + sizeof(filePrefix) - 1, nullptr, 10);
+                files.push_back({microseconds, std::move(name), static_cast<size_t>(status.st_size)});
+                total += static_cast<size_t>(status.st_size);
+            }
+        } catch (...) {
+            // We only delete among the files we know about
+        }
+        ::closedir(dir);
+
+        // The youngest file is the one that is written right now
+        std::sort(files.begin(), files.end(), [](const LogFile &a, const LogFile &b) {
+            return a.microseconds != b.microseconds ? a.microseconds < b.microseconds : a.name < b.name;
+        });
+        size_t deleted = 0;
+        for (size_t i = 0; i + 1 < files.size() && total > maxTotalSize; i++) {
+            if (::unlink(files[i].name.c_str()) == 0) {
+                LogDurability::markRemoved(files[i].name);
+                total -= files[i].size;
+                deleted++;
+            }
+        }
+        return deleted;
+    }
+
+    size_t LogRotation::getNumberOfCompressedFiles() noexcept {
+        return NumberOfCompressedFiles;
+    }
+
+}
@@ -0,0 +1,239 @@
+#include <ee/LogSegment.hpp>
+#include <ee/LogCodec.hpp>
+#include <ee/LzCodec.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ee {
+
+    LogSegment::LogSegment(size_t capacity) : mCapacity(std::max<size_t>(capacity, 1)) {
+        // Reserve everything now, so appending never moves the log entries
+        this->mEntries.reserve(this->mCapacity);
+    }
+
+    LogSegment::LogSegment(const LogSegment &other) :
+            mCapacity(other.mCapacity),
+            mNumberOfBytes(other.mNumberOfBytes),
+            mMinDateOfCreation(other.mMinDateOfCreation),
+            mMaxDateOfCreation(other.mMaxDateOfCreation),
+            mMinSequenceNumber(other.mMinSequenceNumber),
+            mMaxSequenceNumber(other.mMaxSequenceNumber),
+            mCompressed(other.mCompressed),
+            mBlock(other.mBlock),
+            mUncompressedSize(other.mUncompressedSize),
+            mNumberOfCompressedEntries(other.mNumberOfCompressedEntries) {
+        if (this->mCompressed) {
+            return;
+        }
+        this->mEntries.reserve(this->mCapacity);
+        this->mEntries.insert(this->mEntries.end(), other.mEntries.begin(), other.mEntries.end());
+    }
+
+    LogEntry &LogSegment::emplace_back(
+            LogLevel logLevel,
+            const std::string &classname,
+            const std::string &method,
+            const std::string &message,
+            const std::vector<Note> &notes,
+            const std::optional<std::shared_ptr<Stacktrace>> &stacktrace,
+            const std::chrono::system_clock::time_point &dateOfCreation,
+            uint64_t sequenceNumber) {
+        auto &logEntry = this->mEntries.emplace_back(
+                logLevel, classname, method, message, notes, stacktrace, dateOfCreation, sequenceNumber);
+        this->mNumberOfBytes += this->getNumberOfBytes(this->mEntries.size() - 1);
+
+        // The clock may jump backwards, so we can not rely on the order of the log entries
+        if (this->mEntries.size() == 1 || dateOfCreation < this->mMinDateOfCreation) {
+            this->mMinDateOfCreation = dateOfCreation;
+        }
+        if (this->mEntries.size() == 1 || dateOfCreation > this->mMaxDateOfCreation) {
+            this->mMaxDateOfCreation = dateOfCreation;
+        }
+        if (this->mEntries.size() == 1) {
+            this->mMinSequenceNumber = sequenceNumber;
+        }
+        this->mMaxSequenceNumber = sequenceNumber;
+        return logEntry;
+    }
+
+    size_t LogSegment::release(const std::vector<bool> &release) noexcept {
+        // The log entries of a compressed segment have to be thawed first
+        if (this->mCompressed) {
+            return 0;
+        }
+
+        // Move all retained log entries to the front and keep track of the dates and bytes
+        size_t retained = 0;
+        this->mNumberOfBytes = 0;
+        for (size_t i = 0; i < this->mEntries.size(); i++) {
+            if (i < release.size() && release[i]) {
+                continue;
+            }
+            if (retained != i) {
+                this->mEntries[retained] = std::move(this->mEntries[i]);
+            }
+            auto &dateOfCreation = this->mEntries[retained].getDateOfCreation();
+            if (retained == 0 || dateOfCreation < this->mMinDateOfCreation) {
+                this->mMinDateOfCreation = dateOfCreation;
+            }
+            if (retained == 0 || dateOfCreation > this->mMaxDateOfCreation) {
+                this->mMaxDateOfCreation = dateOfCreation;
+            }
+            this->mNumberOfBytes += this->getNumberOfBytes(retained);
+            retained++;
+        }
+
+        // Destroy the released log entries at the end
+        auto released = this->mEntries.size() - retained;
+        this->mEntries.erase(this->mEntries.begin() + static_cast<std::ptrdiff_t>(retained), this->mEntries.end());
+        if (!this->mEntries.empty()) {
+            this->mMinSequenceNumber = this->mEntries.front().getSequenceNumber();
+            this->mMaxSequenceNumber = this->mEntries.back().getSequenceNumber();
+        }
+        return released;
+    }
+
+    bool LogSegment::compress(std::vector<LogEntry> &entries) {
+        if (this->mCompressed || this->mEntries.empty()) {
+            return false;
+        }
+
+        // Every log entry becomes a length-prefixed record, the thread is known by the owner of the segment
+        std::string records;
+        for (auto &logEntry : this->mEntries) {
+            auto offset = records.size();
+            records.append(sizeof(uint32_t), '\0');
+            LogCodec::encode(records, logEntry, 0);
+            auto length = static_cast<uint32_t>(records.size() - offset - sizeof(uint32_t));
+            std::memcpy(&records[offset], &length, sizeof(uint32_t));
+        }
+        std::string block;
+        LzCodec::compress(records.data(), records.size(), block);
+        if (block.size() >= this->mNumberOfBytes) {
+            return false;
+        }
+        block.shrink_to_fit();
+
+        this->mBlock = std::move(block);
+        this->mUncompressedSize = records.size();
+        this->mNumberOfCompressedEntries = this->mEntries.size();
+        this->mCompressed = true;
+        this->mNumberOfBytes = this->mBlock.capacity();
+
+        // The vector gives its memory back, the caller destroys the log entries
+        entries.clear();
+        entries.swap(this->mEntries);
+        std::vector<LogEntry>().swap(this->mEntries);
+        return true;
+    }
+
+    bool LogSegment::thaw() noexcept {
+        if (!this->mCompressed) {
+            return true;
+        }
+
+        try {
+            std::string records;
+            if (!LzCodec::decompress(this->mBlock.data(), this->mBlock.size(), this->mUncompressedSize, records)) {
+                return false;
+            }
+
+            std::vector<LogEntry> entries;
+            entries.reserve(this->mCapacity);
+            size_t position = 0;
+            while (position + sizeof(uint32_t) <= records.size()) {
+                uint32_t length = 0;
+                std::memcpy(&length, records.data() + position, sizeof(uint32_t));
+                position += sizeof(uint32_t);
+                if (length > records.size() - position) {
+                    return false;
+                }
+                size_t threadHash = 0;
+                auto logEntry = LogCodec::decode(
+                        records.data() + position, length, threadHash, entries.empty() ? nullptr : &entries.back());
+                if (!logEntry.has_value()) {
+                    return false;
+                }
+                entries.push_back(std::move(logEntry.value()));
+                position += length;
+            }
+            if (entries.size() != this->mNumberOfCompressedEntries) {
+                return false;
+            }
+
+            this->mEntries = std::move(entries);
+            std::string().swap(this->mBlock);
+            this->mCompressed = false;
+            this->mNumberOfBytes = 0;
+            for (size_t i = 0; i < this->mEntries.size(); i++) {
+                this->mNumberOfBytes += this->getNumberOfBytes(i);
+            }
+            return true;
+        } catch (...) {
+            // We could not allocate the memory for the log entries
+            return false;
+        }
+    }
+
+    bool LogSegment::isCompressed() const noexcept {
+        return this->mCompressed;
+    }
+
+    const std::vector<LogEntry> &LogSegment::getEntries() const noexcept {
+        return this->mEntries;
+    }
+
+    size_t LogSegment::size() const noexcept {
+        return this->mCompressed ? this->mNumberOfCompressedEntries : this->mEntries.size();
+    }
+
+    bool LogSegment::empty() const noexcept {
+        return this->size() == 0;
+    }
+
+    bool LogSegment::full() const noexcept {
+        return this->mCompressed || this->mEntries.size() >= this->mCapacity;
+    }
+
+    size_t LogSegment::getCapacity() const noexcept {
+        return this->mCapacity;
+    }
+
+    size_t LogSegment::getNumberOfBytes() const noexcept {
+        return this->mNumberOfBytes;
+    }
+
+    size_t LogSegment::getNumberOfReservedBytes() const noexcept {
+        return this->mCompressed ? this->mBlock.capacity() : this->mCapacity * sizeof(LogEntry);
+    }
+
+    uint64_t LogSegment::getMinSequenceNumber() const noexcept {
+        return this->mMinSequenceNumber;
+    }
+
+    uint64_t LogSegment::getMaxSequenceNumber() const noexcept {
+        return this->mMaxSequenceNumber;
+    }
+
+    size_t LogSegment::getNumberOfBytes(size_t index) const noexcept {
+        auto &logEntry = this->mEntries[index];
+        auto numberOfBytes = logEntry.getNumberOfBytes();
+
+        // Log entries created in a loop often share the same stacktrace
+        auto &stacktrace = logEntry.getStacktrace();
+        if (stacktrace.has_value() && stacktrace.value() &&
+            (index == 0 || this->mEntries[index - 1].getStacktrace() != stacktrace)) {
+            numberOfBytes += stacktrace.value()->getNumberOfBytes();
+        }
+        return numberOfBytes;
+    }
+
+    const std::chrono::system_clock::time_point &LogSegment::getMinDateOfCreation() const noexcept {
+        return this->mMinDateOfCreation;
+    }
+
+    const std::chrono::system_clock::time_point &LogSegment::getMaxDateOfCreation() const noexcept {
+        return this->mMaxDateOfCreation;
+    }
+
+}
@@ -0,0 +1,70 @@
+#include <ee/LogSnapshot.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/LogMerge.hpp>
+#include <ee/LogSpill.hpp>
+
+namespace ee {
+
+    LogSnapshot::LogSnapshot(
+            const std::chrono::system_clock::time_point &spillSince,
+            const std::chrono::system_clock::time_point &spillUntil) noexcept :
+            mSpillSince(spillSince), mSpillUntil(spillUntil) {}
+
+    LogBuffer &LogSnapshot::emplace(const std::thread::id &threadId) {
+        return this->mThreads[threadId];
+    }
+
+    const LogSnapshot::ThreadMap &LogSnapshot::getThreads() const noexcept {
+        return this->mThreads;
+    }
+
+    size_t LogSnapshot::size() const noexcept {
+        size_t size = 0;
+        for (auto &thread : this->mThreads) {
+            size += thread.second.size();
+        }
+        return size;
+    }
+
+    const std::chrono::system_clock::time_point &LogSnapshot::getSpillSince() const noexcept {
+        return this->mSpillSince;
+    }
+
+    const std::chrono::system_clock::time_point &LogSnapshot::getSpillUntil() const noexcept {
+        return this->mSpillUntil;
+    }
+
+    bool LogSnapshot::writeToFile(const std::string &filename, OutputFormat format) const noexcept {
+        // The spilled logs are merged with the ones in memory
+        LogMerge::SpilledLogEntries spilled;
+        if (this->mSpillSince != std::chrono::system_clock::time_point::max()) {
+            spilled = LogSpill::read(this->mSpillSince, this->mSpillUntil);
+        }
+        if (spilled.empty() && this->size() == 0) {
+            return true;
+        }
+
+        // The file stays open across incidents, it is only opened again if it has been removed meanwhile
+        auto sink = FileSink::get(filename);
+        if (!sink) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(sink->getMutex());
+        if (!sink->open()) {
+            return false;
+        }
+
+        try {
+            // Nobody else can reach the buffers of the snapshot, so we need no lock while formatting them
+            LogMerge merge(this->mThreads, &spilled);
+            merge.write(*sink, format);
+        } catch (...) {
+            // We could not format all log entries, but we keep what has been written so far
+            sink->flush();
+            return false;
+        }
+
+        return sink->flush();
+    }
+
+}
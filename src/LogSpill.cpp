@@ -0,0 +1,384 @@
+#include <ee/LogSpill.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/LogCodec.hpp>
+#include <ee/LogMerge.hpp>
+#include <ee/Log.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ee {
+
+    std::mutex LogSpill::Mutex;
+    std::atomic_bool LogSpill::Open = false;
+    int LogSpill::FileDescriptor = -1;
+    uint64_t LogSpill::Capacity = 0;
+    uint64_t LogSpill::Head = 0;
+    uint64_t LogSpill::Tail = 0;
+    std::chrono::milliseconds LogSpill::IncidentWindow = std::chrono::minutes(30);
+    std::atomic_size_t LogSpill::NumberOfSpilledLogEntries = 0;
+
+    /**
+     * @brief Identifies a ring file.
+     */
+    static const char Magic[8] = {'E', 'E', 'S', 'P', 'I', 'L', 'L', '1'};
+
+    /**
+     * @brief Replaces the length of a record that does not fit in front of the end of the data region.
+     */
+    static constexpr uint32_t WrapMarker = UINT32_MAX;
+
+    /**
+     * @brief The number of bytes of the length in front of every record.
+     */
+    static constexpr uint64_t LengthSize = sizeof(uint32_t);
+
+    /**
+     * @brief The number of bytes that are read at once while walking through the ring file.
+     */
+    static constexpr uint64_t ChunkSize = 1024 * 1024;
+
+    /**
+     * @brief Reads exactly the given number of bytes at the given offset.
+     *
+     * @return True if all bytes could be read.
+     */
+    static bool readFully(int fileDescriptor, char *data, size_t size, uint64_t offset) noexcept {
+        while (size > 0) {
+            auto result = pread(fileDescriptor, data, size, static_cast<off_t>(offset));
+            if (result <= 0) {
+                return false;
+            }
+            data += result;
+            size -= static_cast<size_t>(result);
+            offset += static_cast<uint64_t>(result);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes exactly the given number of bytes at the given offset.
+     *
+     * @return True if all bytes could be written.
+     */
+    static bool writeFully(int fileDescriptor, const char *data, size_t size, uint64_t offset) noexcept {
+        while (size > 0) {
+            auto result = pwrite(fileDescriptor, data, size, static_cast<off_t>(offset));
+            if (result <= 0) {
+                return false;
+            }
+            data += result;
+            size -= static_cast<size_t>(result);
+            offset += static_cast<uint64_t>(result);
+        }
+        return true;
+    }
+
+    bool LogSpill::open(
+            const std::string &filename,
+            size_t capacity,
+            const std::chrono::milliseconds &incidentWindow) noexcept {
+        close();
+        std::lock_guard<std::mutex> lock(Mutex);
+
+        int fileDescriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fileDescriptor < 0) {
+            return false;
+        }
+        FileDescriptor = fileDescriptor;
+        Capacity = std::max<uint64_t>(capacity, MinCapacity);
+        IncidentWindow = incidentWindow;
+
+        // A file of a previous run is continued if it has the same layout
+        char header[HeaderSize];
+        uint64_t capacityOfFile = 0, head = 0, tail = 0;
+        if (readFully(fileDescriptor, header, HeaderSize, 0) && std::memcmp(header, Magic, sizeof(Magic)) == 0) {
+            std::memcpy(&capacityOfFile, header + 8, sizeof(uint64_t));
+            std::memcpy(&head, header + 16, sizeof(uint64_t));
+            std::memcpy(&tail, header + 24, sizeof(uint64_t));
+        }
+        if (capacityOfFile == Capacity && tail <= head && head - tail <= Capacity) {
+            Head = head;
+            Tail = tail;
+        } else {
+            Head = 0;
+            Tail = 0;
+        }
+
+        // The file has its final size from the beginning, the data region is only overwritten afterwards
+        if (ftruncate(fileDescriptor, static_cast<off_t>(HeaderSize + Capacity)) != 0 || !writeHeader()) {
+            ::close(fileDescriptor);
+            FileDescriptor = -1;
+            return false;
+        }
+        Open = true;
+        return true;
+    }
+
+    void LogSpill::close() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Open = false;
+        if (FileDescriptor >= 0) {
+            ::close(FileDescriptor);
+            FileDescriptor = -1;
+        }
+    }
+
+    bool LogSpill::isOpen() noexcept {
+        return Open;
+    }
+
+    void LogSpill::append(
+            const std::thread::id &threadId,
+            const LogSegment &segment,
+            const std::vector<bool> &release) noexcept {
+        if (!Open) {
+            return;
+        }
+
+        try {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (FileDescriptor < 0) {
+                return;
+            }
+
+            // The records are collected and written with a single call until the head wraps around
+            auto threadHash = std::hash<std::thread::id>()(threadId);
+            std::string record;
+            std::string pending;
+            uint64_t pendingStart = Head;
+            size_t spilled = 0;
+            auto &entries = segment.getEntries();
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (!release.empty() && (i >= release.size() || !release[i])) {
+                    continue;
+                }
+
+                // The length is filled in after the log entry has been encoded
+                record.assign(LengthSize, '\0');
+                LogCodec::encode(record, entries[i], threadHash);
+                auto length = static_cast<uint32_t>(record.size() - LengthSize);
+                std::memcpy(&record[0], &length, LengthSize);
+
+                // A huge record would evict most of the history, we rather lose it
+                if (record.size() > Capacity / 2) {
+                    continue;
+                }
+                if (!place(record, pending, pendingStart)) {
+                    break;
+                }
+                spilled++;
+            }
+
+            flush(pending, pendingStart);
+            writeHeader();
+            NumberOfSpilledLogEntries += spilled;
+        } catch (...) {
+            // We could not allocate the memory for encoding, the log entries are lost like without a spill tier
+        }
+    }
+
+    bool LogSpill::place(const std::string &record, std::string &pending, uint64_t &pendingStart) noexcept {
+        // A record never wraps around, the rest of the data region is skipped instead
+        auto untilEnd = Capacity - Head % Capacity;
+        auto skip = record.size() > untilEnd ? untilEnd : 0;
+
+        // Overwritten records have to leave the ring first
+        while (Head + skip + record.size() - Tail > Capacity) {
+            if (!evict(pending, pendingStart)) {
+                return false;
+            }
+        }
+
+        if (skip > 0) {
+            if (skip >= LengthSize) {
+                pending.append(reinterpret_cast<const char *>(&WrapMarker), LengthSize);
+            }
+            Head += skip;
+            if (!flush(pending, pendingStart)) {
+                return false;
+            }
+        }
+        pending += record;
+        Head += record.size();
+        return true;
+    }
+
+    bool LogSpill::evict(const std::string &pending, uint64_t pendingStart) noexcept {
+        auto untilEnd = Capacity - Tail % Capacity;
+        if (untilEnd < LengthSize) {
+            Tail += untilEnd;
+            return true;
+        }
+
+        // The oldest record may not be written yet, if the batch is larger than the data region
+        uint32_t length = 0;
+        if (Tail >= pendingStart && Tail + LengthSize <= pendingStart + pending.size()) {
+            std::memcpy(&length, pending.data() + (Tail - pendingStart), LengthSize);
+        } else if (!readFully(FileDescriptor, reinterpret_cast<char *>(&length), LengthSize,
+                              HeaderSize + Tail % Capacity)) {
+            return false;
+        }
+
+        if (length == WrapMarker) {
+            Tail += untilEnd;
+        } else if (LengthSize + length > untilEnd) {
+            // The file is damaged, we give up the whole history instead of reading garbage
+            Tail = Head;
+        } else {
+            Tail += LengthSize + length;
+        }
+        return true;
+    }
+
+    bool LogSpill::flush(std::string &pending, uint64_t &pendingStart) noexcept {
+        bool success = pending.empty() ||
+                       writeFully(FileDescriptor, pending.data(), pending.size(), HeaderSize + pendingStart % Capacity);
+        pending.clear();
+        pendingStart = Head;
+        return success;
+    }
+
+    bool LogSpill::writeHeader() noexcept {
+        char header[HeaderSize] = {};
+        std::memcpy(header, Magic, sizeof(Magic));
+        std::memcpy(header + 8, &Capacity, sizeof(uint64_t));
+        std::memcpy(header + 16, &Head, sizeof(uint64_t));
+        std::memcpy(header + 24, &Tail, sizeof(uint64_t));
+        return writeFully(FileDescriptor, header, HeaderSize, 0);
+    }
+
+    std::vector<std::pair<size_t, LogEntry>> LogSpill::read(
+            const std::chrono::system_clock::time_point &since,
+            const std::chrono::system_clock::time_point &until) noexcept {
+        std::vector<std::pair<size_t, LogEntry>> result;
+        try {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (FileDescriptor < 0) {
+                return result;
+            }
+            auto sinceNanoseconds = static_cast<int64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(since.time_since_epoch()).count());
+            auto untilNanoseconds = until == std::chrono::system_clock::time_point::max() ? INT64_MAX :
+                    static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            until.time_since_epoch()).count());
+
+            // The data region is read in large chunks, a record that crosses a chunk is read again
+            std::string chunk;
+            uint64_t chunkStart = 0;
+            auto load = [&chunk, &chunkStart](uint64_t position, uint64_t size) {
+                if (position >= chunkStart && position + size <= chunkStart + chunk.size()) {
+                    return true;
+                }
+                auto untilEnd = Capacity - position % Capacity;
+                chunk.resize(std::min(std::max(size, ChunkSize), untilEnd));
+                chunkStart = position;
+                return readFully(FileDescriptor, &chunk[0], chunk.size(), HeaderSize + position % Capacity);
+            };
+
+            uint64_t position = Tail;
+            while (position < Head) {
+                auto untilEnd = Capacity - position % Capacity;
+                if (untilEnd < LengthSize) {
+                    position += untilEnd;
+                    continue;
+                }
+                uint32_t length = 0;
+                if (!load(position, LengthSize)) {
+                    break;
+                }
+                std::memcpy(&length, chunk.data() + (position - chunkStart), LengthSize);
+                if (length == WrapMarker) {
+                    position += untilEnd;
+                    continue;
+                }
+                if (LengthSize + length > untilEnd || position + LengthSize + length > Head ||
+                    !load(position, LengthSize + length)) {
+                    // The rest of the file is damaged
+                    break;
+                }
+
+                // The date of creation follows the version, the log level and the thread hash
+                auto record = chunk.data() + (position - chunkStart) + LengthSize;
+                int64_t nanoseconds = 0;
+                if (length >= 18) {
+                    std::memcpy(&nanoseconds, record + 10, sizeof(int64_t));
+                }
+                if (nanoseconds >= sinceNanoseconds && nanoseconds < untilNanoseconds) {
+                    size_t threadHash = 0;
+                    auto logEntry = LogCodec::decode(record, length, threadHash);
+                    if (logEntry.has_value()) {
+                        result.emplace_back(threadHash, std::move(logEntry.value()));
+                    }
+                }
+                position += LengthSize + length;
+            }
+        } catch (...) {
+            // We return what we could read so far
+        }
+
+        // The records of different threads are interleaved in the order they were released
+        std::stable_sort(result.begin(), result.end(), [](const auto &a, const auto &b) {
+            if (a.second.getDateOfCreation() != b.second.getDateOfCreation()) {
+                return a.second.getDateOfCreation() < b.second.getDateOfCreation();
+            }
+            return a.second.getSequenceNumber() < b.second.getSequenceNumber();
+        });
+        return result;
+    }
+
+    bool LogSpill::writeToFile(
+            const std::string &filename,
+            const std::chrono::system_clock::time_point &since,
+            OutputFormat format,
+            const std::chrono::system_clock::time_point &until) noexcept {
+        // Reading the ring file holds no lock of the log, so logging does not have to be suspended
+        auto logEntries = read(since, until);
+        if (logEntries.empty()) {
+            return true;
+        }
+
+        // The file stays open across incidents, it is only opened again if it has been removed meanwhile
+        auto sink = FileSink::get(filename);
+        if (!sink) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(sink->getMutex());
+        if (!sink->open()) {
+            return false;
+        }
+
+        try {
+            // The log entries are already ordered, so the merge only has to name their threads
+            std::map<std::thread::id, LogBuffer> noThreads;
+            LogMerge merge(noThreads, &logEntries);
+            merge.write(*sink, format);
+        } catch (...) {
+            sink->flush();
+            return false;
+        }
+
+        return sink->flush();
+    }
+
+    size_t LogSpill::getCapacity() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return FileDescriptor >= 0 ? static_cast<size_t>(Capacity) : 0;
+    }
+
+    size_t LogSpill::getNumberOfBytes() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return FileDescriptor >= 0 ? static_cast<size_t>(Head - Tail) : 0;
+    }
+
+    size_t LogSpill::getNumberOfSpilledLogEntries() noexcept {
+        return NumberOfSpilledLogEntries;
+    }
+
+    std::chrono::milliseconds LogSpill::getIncidentWindow() noexcept {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return IncidentWindow;
+    }
+
+}
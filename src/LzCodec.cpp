@@ -0,0 +1,178 @@
+#include <ee/LzCodec.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace ee {
+
+    /**
+     * @brief The shortest match that is worth a sequence.
+     */
+    static constexpr size_t MinMatch = 4;
+
+    /**
+     * @brief The largest distance to a match that fits into the offset.
+     */
+    static constexpr size_t MaxOffset = 65535;
+
+    /**
+     * @brief The number of bits of the hash table index.
+     */
+    static constexpr unsigned HashBits = 12;
+
+    /**
+     * @brief Reads four bytes without caring for their alignment.
+     */
+    static uint32_t read32(const char *data) noexcept {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Appends a length that did not fit into its four bits of the token.
+     */
+    static void appendLength(std::string &buffer, size_t length) {
+        while (length >= 255) {
+            buffer += static_cast<char>(255);
+            length -= 255;
+        }
+        buffer += static_cast<char>(length);
+    }
+
+    /**
+     * @brief Appends a sequence of literals followed by an optional match.
+     *
+     * @param buffer The buffer to append to.
+     * @param literals The first literal.
+     * @param numberOfLiterals The number of literals.
+     * @param offset The distance to the match.
+     * @param matchLength The length of the match, zero for the last sequence.
+     */
+    static void appendSequence(
+            std::string &buffer,
+            const char *literals,
+            size_t numberOfLiterals,
+            size_t offset,
+            size_t matchLength) {
+        auto matchCode = matchLength > 0 ? matchLength - MinMatch : 0;
+        buffer += static_cast<char>((std::min<size_t>(numberOfLiterals, 15) << 4) | std::min<size_t>(matchCode, 15));
+        if (numberOfLiterals >= 15) {
+            appendLength(buffer, numberOfLiterals - 15);
+        }
+        buffer.append(literals, numberOfLiterals);
+        if (matchLength == 0) {
+            return;
+        }
+        buffer += static_cast<char>(offset & 0xFF);
+        buffer += static_cast<char>(offset >> 8);
+        if (matchCode >= 15) {
+            appendLength(buffer, matchCode - 15);
+        }
+    }
+
+    void LzCodec::compress(const char *data, size_t size, std::string &buffer) {
+        // Remembers the latest position of every hashed four byte sequence
+        std::vector<uint32_t> table(size_t(1) << HashBits, 0);
+
+        size_t anchor = 0;
+        size_t position = 0;
+        while (position + MinMatch <= size) {
+            auto sequence = read32(data + position);
+            auto hash = (sequence * 2654435761U) >> (32 - HashBits);
+            size_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(position);
+
+            if (candidate >= position || position - candidate > MaxOffset || read32(data + candidate) != sequence) {
+                position++;
+                continue;
+            }
+
+            // The match may overlap the current position, the decompressor copies byte by byte
+            size_t length = MinMatch;
+            while (position + length < size && data[candidate + length] == data[position + length]) {
+                length++;
+            }
+            appendSequence(buffer, data + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+        }
+        appendSequence(buffer, data + anchor, size - anchor, 0, 0);
+    }
+
+    /**
+     * @brief Reads a length that did not fit into its four bits of the token.
+     *
+     * @return False if the block ended.
+     */
+    static bool readLength(const unsigned char *&input, const unsigned char *end, size_t &length) noexcept {
+        unsigned char byte;
+        do {
+            if (input >= end) {
+                return false;
+            }
+            byte = *input++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    bool LzCodec::decompress(const char *data, size_t size, size_t originalSize, std::string &buffer) noexcept {
+        auto start = buffer.size();
+        try {
+            buffer.resize(start + originalSize);
+        } catch (...) {
+            return false;
+        }
+
+        auto input = reinterpret_cast<const unsigned char *>(data);
+        auto end = input + size;
+        auto output = &buffer[start];
+        size_t written = 0;
+        while (input < end) {
+            auto token = *input++;
+
+            // Copy the literals
+            size_t numberOfLiterals = token >> 4;
+            if (numberOfLiterals == 15 && !readLength(input, end, numberOfLiterals)) {
+                break;
+            }
+            if (numberOfLiterals > static_cast<size_t>(end - input) || numberOfLiterals > originalSize - written) {
+                break;
+            }
+            std::memcpy(output + written, input, numberOfLiterals);
+            input += numberOfLiterals;
+            written += numberOfLiterals;
+            if (input == end) {
+                // The last sequence has no match
+                if (written == originalSize) {
+                    return true;
+                }
+                break;
+            }
+
+            // Copy the match, it may overlap the bytes it produces
+            if (end - input < 2) {
+                break;
+            }
+            size_t offset = input[0] | (static_cast<size_t>(input[1]) << 8);
+            input += 2;
+            size_t matchLength = token & 0x0F;
+            if (matchLength == 15 && !readLength(input, end, matchLength)) {
+                break;
+            }
+            matchLength += MinMatch;
+            if (offset == 0 || offset > written || matchLength > originalSize - written) {
+                break;
+            }
+            for (size_t i = 0; i < matchLength; i++, written++) {
+                output[written] = output[written - offset];
+            }
+        }
+
+        // The block is damaged
+        buffer.resize(start);
+        return false;
+    }
+
+}
@@ -2,6 +2,8 @@
 #include <dlfcn.h>
 #include <cxxabi.h>
 #include <ee/Stacktrace.hpp>
+#include <ee/Formatter.hpp>
+#include <ee/Helper.hpp>
 
 namespace ee {
 
@@ -46,14 +48,33 @@ namespace ee {
         // Unwind the stack
         _Unwind_Backtrace(linux_unwind_callback, &state);
 
-        // Get the number of lines we received
-        auto count = (int)(state.current - buffer);
+        // Resolve the addresses we received
+        return create(buffer, static_cast<size_t>(state.current - buffer));
+#else
+        return std::nullopt;
+#endif
+    }
+
+    size_t Stacktrace::capture(void **addresses, size_t numberOfAddresses) noexcept {
+#ifndef __EMSCRIPTEN__
+        // Only unwind the stack and leave the expensive resolving of the symbols for later
+        linux_backtrace_state state = {addresses, addresses + numberOfAddresses};
+        _Unwind_Backtrace(linux_unwind_callback, &state);
+        return static_cast<size_t>(state.current - addresses);
+#else
+        return 0;
+#endif
+    }
 
+    std::optional<std::shared_ptr<Stacktrace>> Stacktrace::create(
+            void *const *addresses,
+            size_t numberOfAddresses) noexcept {
+#ifndef __EMSCRIPTEN__
         // Iterate through the lines
         std::map<unsigned short,std::string> lines;
-        for (int idx = 0; idx < count; idx++) {
+        for (size_t idx = 0; idx < numberOfAddresses; idx++) {
             // Get the address of this call
-            const void* addr = buffer[idx];
+            const void* addr = addresses[idx];
 
             // Prepare an empty symbol as fallback
             const char* symbol = "";
@@ -92,9 +113,21 @@ namespace ee {
 
     std::string Stacktrace::asString() const noexcept {
         std::string str;
-        for (auto& line : this->mLines) {
-            str += "[" + std::to_string(line.first) + "] " + line.second + "\n";
+        try {
+            Formatter::write(str, *this);
+        } catch (...) {
+            str.clear();
         }
         return str;
     }
+
+    size_t Stacktrace::getNumberOfBytes() const noexcept {
+        // The object shares one allocation with the reference counters and the vtable of std::make_shared
+        size_t numberOfBytes = sizeof(Stacktrace) + 2 * sizeof(void *);
+        for (auto &line : this->mLines) {
+            // Every node of the map holds its color and three pointers in front of the value
+            numberOfBytes += 4 * sizeof(void *) + sizeof(line) + Helper::getNumberOfBytes(line.second);
+        }
+        return numberOfBytes;
+    }
 }
\ No newline at end of file
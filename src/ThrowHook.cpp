@@ -0,0 +1,115 @@
+#include <ee/ThrowHook.hpp>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <unistd.h>
+
+namespace ee {
+
+    std::atomic_bool ThrowHook::Enabled = false;
+    std::atomic_uint32_t ThrowHook::SamplingRate = 1;
+
+    /**
+     * @brief The slot that holds the raw stack of the latest captured throw of a thread.
+     */
+    struct ThrowSlot {
+        const void* thrownObject = nullptr;
+        void* addresses[32];
+        size_t numberOfAddresses = 0;
+        uint32_t counter = 0;
+    };
+
+    /**
+     * @brief Every thread has its own slot, so capturing never needs a lock.
+     */
+    thread_local ThrowSlot Slot;
+
+    void ThrowHook::enable(uint32_t samplingRate) noexcept {
+        SamplingRate = samplingRate > 0 ? samplingRate : 1;
+        Enabled = true;
+    }
+
+    void ThrowHook::disable() noexcept {
+        Enabled = false;
+    }
+
+    bool ThrowHook::isEnabled() noexcept {
+        return Enabled;
+    }
+
+    bool ThrowHook::isAvailable() noexcept {
+#ifdef EASY_EXCEPTION_THROW_HOOK
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint32_t ThrowHook::getSamplingRate() noexcept {
+        return SamplingRate;
+    }
+
+    std::optional<std::shared_ptr<Stacktrace>> ThrowHook::getStacktrace(const std::exception &exception) noexcept {
+        // The thrown object is the most derived object, not necessarily the std::exception base
+        return getStacktrace(dynamic_cast<const void *>(&exception));
+    }
+
+    std::optional<std::shared_ptr<Stacktrace>> ThrowHook::getStacktrace(const void *thrownObject) noexcept {
+        if (thrownObject == nullptr || Slot.thrownObject != thrownObject) {
+            return std::nullopt;
+        }
+
+        // Resolving the symbols is expensive, so we only do it when somebody is interested
+        return Stacktrace::create(Slot.addresses, Slot.numberOfAddresses);
+    }
+
+    void ThrowHook::capture(const void *thrownObject) noexcept {
+        if (!Enabled.load(std::memory_order_relaxed)) {
+            Slot.thrownObject = nullptr;
+            return;
+        }
+
+        // Only every n-th throw of this thread is sampled, the slot must not match a later object at the same address
+        if (Slot.counter++ % SamplingRate.load(std::memory_order_relaxed) != 0) {
+            Slot.thrownObject = nullptr;
+            return;
+        }
+        Slot.thrownObject = thrownObject;
+        Slot.numberOfAddresses = Stacktrace::capture(Slot.addresses, sizeof(Slot.addresses) / sizeof(void *));
+    }
+
+}
+
+#ifdef EASY_EXCEPTION_THROW_HOOK
+extern "C" {
+
+    /**
+     * @brief The signature of the throw entry point of the C++ runtime.
+     */
+    typedef void (*CxaThrowFunction)(void *, void *, void (*)(void *));
+
+    /**
+     * @brief Interposes the throw entry point of the C++ runtime and forwards to the original after capturing.
+     *
+     * @param thrownException The thrown object.
+     * @param type The std::type_info of the thrown object, declared as void* like the compiler does.
+     * @param destructor The destructor of the thrown object.
+     */
+    [[noreturn]] void __cxa_throw(void *thrownException, void *type, void (*destructor)(void *)) {
+        ee::ThrowHook::capture(thrownException);
+
+        // Look up the next definition, that is the one of the C++ runtime
+        static auto original = reinterpret_cast<CxaThrowFunction>(dlsym(RTLD_NEXT, "__cxa_throw"));
+        if (original == nullptr) {
+            // The configuration checks for this, so only a runtime linked differently than the check ends up here
+            static const char message[] = "ee::ThrowHook: __cxa_throw of the C++ runtime not found, build without "
+                                          "EE_USE_THROW_HOOK\n";
+            auto written = ::write(STDERR_FILENO, message, sizeof(message) - 1);
+            (void) written;
+            std::abort();
+        }
+        original(thrownException, type, destructor);
+        __builtin_unreachable();
+    }
+
+}
+#endif
@@ -0,0 +1,213 @@
+#include <ee/ThrowStatistics.hpp>
+#include <ee/Formatter.hpp>
+#include <cxxabi.h>
+#include <algorithm>
+#include <unordered_map>
+#include <fstream>
+
+namespace ee {
+
+    std::mutex ThrowStatistics::Mutex;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<ThrowStatistics::Site>> ThrowStatistics::Sites;
+    std::atomic_bool ThrowStatistics::Enabled = true;
+
+    ThrowSite::ThrowSite(
+            std::string type,
+            std::string caller,
+            uint64_t count,
+            const std::chrono::system_clock::time_point &firstOccurrence,
+            const std::chrono::system_clock::time_point &lastOccurrence,
+            std::optional<std::shared_ptr<Stacktrace>> stacktrace) noexcept :
+            mType(std::move(type)),
+            mCaller(std::move(caller)),
+            mCount(count),
+            mFirstOccurrence(firstOccurrence),
+            mLastOccurrence(lastOccurrence),
+            mStacktrace(std::move(stacktrace)) {
+
+    }
+
+    const std::string &ThrowSite::getType() const noexcept {
+        return this->mType;
+    }
+
+    const std::string &ThrowSite::getCaller() const noexcept {
+        return this->mCaller;
+    }
+
+    uint64_t ThrowSite::getCount() const noexcept {
+        return this->mCount;
+    }
+
+    const std::chrono::system_clock::time_point &ThrowSite::getFirstOccurrence() const noexcept {
+        return this->mFirstOccurrence;
+    }
+
+    const std::chrono::system_clock::time_point &ThrowSite::getLastOccurrence() const noexcept {
+        return this->mLastOccurrence;
+    }
+
+    const std::optional<std::shared_ptr<Stacktrace>> &ThrowSite::getStacktrace() const noexcept {
+        return this->mStacktrace;
+    }
+
+    void ThrowStatistics::record(
+            const std::type_info &type,
+            const std::string &caller,
+            const std::optional<std::shared_ptr<Stacktrace>> &stacktrace) noexcept {
+        if (!Enabled) {
+            return;
+        }
+
+        try {
+            // Every thread remembers the sites it has already seen by the hash of type and caller
+            thread_local std::unordered_map<size_t, Site *> cache;
+            auto hash = type.hash_code() ^ (std::hash<std::string>()(caller) * 31);
+            Site *pSite = nullptr;
+            auto it = cache.find(hash);
+            if (it != cache.end() && *it->second->type == type && it->second->caller == caller) {
+                pSite = it->second;
+            } else {
+                // Unknown to this thread (or a hash collision), we have to look into the shared map
+                std::lock_guard<std::mutex> mutex(ThrowStatistics::Mutex);
+                auto &site = Sites[std::make_pair(std::string(type.name()), caller)];
+                if (site == nullptr) {
+                    site = std::make_unique<Site>();
+                    site->type = &type;
+                    site->caller = caller;
+                    site->stacktrace = stacktrace;
+                }
+                pSite = site.get();
+                cache[hash] = pSite;
+            }
+
+            // Update the counters without any lock
+            auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            int64_t unset = 0;
+            pSite->firstOccurrence.compare_exchange_strong(unset, now, std::memory_order_relaxed);
+            pSite->lastOccurrence.store(now, std::memory_order_relaxed);
+            pSite->count.fetch_add(1, std::memory_order_relaxed);
+        } catch (...) {
+            // The statistics are not important enough to report anything
+        }
+    }
+
+    std::vector<ThrowSite> ThrowStatistics::getThrowSites() noexcept {
+        std::vector<ThrowSite> throwSites;
+        try {
+            std::lock_guard<std::mutex> mutex(ThrowStatistics::Mutex);
+            for (auto &site : Sites) {
+                auto count = site.second->count.load(std::memory_order_relaxed);
+                if (count == 0) {
+                    continue;
+                }
+
+                // Try to get a readable name of the type
+                int status = 0;
+                char *demangled = __cxxabiv1::__cxa_demangle(site.second->type->name(), nullptr, nullptr, &status);
+                std::string type = (nullptr != demangled && 0 == status) ? demangled : site.second->type->name();
+                if (demangled != nullptr) {
+                    free(demangled);
+                }
+
+                throwSites.emplace_back(
+                        std::move(type),
+                        site.second->caller,
+                        count,
+                        std::chrono::system_clock::time_point(std::chrono::microseconds(
+                                site.second->firstOccurrence.load(std::memory_order_relaxed))),
+                        std::chrono::system_clock::time_point(std::chrono::microseconds(
+                                site.second->lastOccurrence.load(std::memory_order_relaxed))),
+                        site.second->stacktrace);
+            }
+        } catch (...) {
+            return throwSites;
+        }
+
+        // The most frequent sites are the interesting ones
+        std::stable_sort(throwSites.begin(), throwSites.end(), [](const ThrowSite &a, const ThrowSite &b) {
+            return a.getCount() > b.getCount();
+        });
+        return throwSites;
+    }
+
+    void ThrowStatistics::reset() noexcept {
+        // The sites remain because the threads cache pointers to them, we only reset their counters
+        std::lock_guard<std::mutex> mutex(ThrowStatistics::Mutex);
+        for (auto &site : Sites) {
+            site.second->count = 0;
+            site.second->firstOccurrence = 0;
+            site.second->lastOccurrence = 0;
+        }
+    }
+
+    void ThrowStatistics::setEnabled(bool enabled) noexcept {
+        Enabled = enabled;
+    }
+
+    bool ThrowStatistics::isEnabled() noexcept {
+        return Enabled;
+    }
+
+    bool ThrowStatistics::writeToFile(const std::string &filename, OutputFormat format) noexcept {
+        // Try to open file (for writing and appending)
+        std::ofstream file(filename, std::ios::out | std::ios::app | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        try {
+            std::string buffer;
+            for (auto &site : getThrowSites()) {
+                switch (format) {
+                    default:
+                    case String: {
+                        Formatter::appendNumber(buffer, site.getCount());
+                        buffer += "x ";
+                        buffer += site.getType();
+                        buffer += " --> ";
+                        buffer += site.getCaller();
+                        buffer += "\n\tFirst: ";
+                        Formatter::appendTimestamp(buffer, site.getFirstOccurrence());
+                        buffer += "\n\tLast: ";
+                        Formatter::appendTimestamp(buffer, site.getLastOccurrence());
+                        buffer += '\n';
+                        if (site.getStacktrace().has_value()) {
+                            buffer += "Stacktrace:\n";
+                            Formatter::write(buffer, *site.getStacktrace()->get());
+                        }
+                        buffer += '\n';
+                    } break;
+
+                    case Json: {
+                        buffer += "{\"type\":";
+                        Formatter::appendJsonString(buffer, site.getType());
+                        buffer += ",\"caller\":";
+                        Formatter::appendJsonString(buffer, site.getCaller());
+                        buffer += ",\"count\":";
+                        Formatter::appendNumber(buffer, site.getCount());
+                        buffer += ",\"first\":\"";
+                        Formatter::appendTimestamp(buffer, site.getFirstOccurrence());
+                        buffer += "\",\"last\":\"";
+                        Formatter::appendTimestamp(buffer, site.getLastOccurrence());
+                        buffer += '"';
+                        if (site.getStacktrace().has_value()) {
+                            buffer += ",\"stacktrace\":";
+                            Formatter::write(buffer, *site.getStacktrace()->get(), OutputFormat::Json);
+                        }
+                        buffer += "}\n";
+                    } break;
+                }
+            }
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        } catch (...) {
+            file.close();
+            return false;
+        }
+
+        file.close();
+        return file.good();
+    }
+
+}
@@ -33,12 +33,14 @@ TEST_CASE("ee::Log") {
 
         // Incident one will be written to file
         ee::Log::log(ee::LogLevel::Warning, "", __PRETTY_FUNCTION__, "TEST", {});
+        ee::Log::flush(false);
         auto files = ee::Helper::findLogFiles();
         REQUIRE(files.size() == 1);
         auto fs = filesize(files[0]);
 
         // Incident two will be written to the same file
         ee::Log::log(ee::LogLevel::Warning, "", __PRETTY_FUNCTION__, "TEST TWO", {});
+        ee::Log::flush(false);
         REQUIRE(ee::Helper::findLogFiles().size() == 1);
         REQUIRE(fs*1.5f < filesize(files[0]));
     }
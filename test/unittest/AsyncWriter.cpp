@@ -0,0 +1,123 @@
+#include "catch.hpp"
+#include <ee/AsyncWriter.hpp>
+#include <ee/FileSink.hpp>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Returns the content of the given file.
+ */
+static std::string readFile(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * @brief Writes several blocks through a sink and returns what the file has to contain.
+ */
+static std::string writeBlocks(ee::FileSink &sink) {
+    std::string expected;
+    bool committed = true;
+    for (int i = 0; i < 200000; i++) {
+        auto line = "[INFO] Line " + std::to_string(i) + "\n";
+        sink.getBuffer() += line;
+        expected += line;
+        committed = sink.commit() && committed;
+    }
+    REQUIRE(committed);
+
+    // A large block is split into several buffers
+    std::string block(3 * ee::AsyncWriter::BufferSize + 17, 'x');
+    for (size_t i = 0; i < block.size(); i += 4096) {
+        block[i] = static_cast<char>('a' + i % 26);
+    }
+    REQUIRE(sink.write(block.data(), block.size()));
+    expected += block;
+    REQUIRE(sink.write("Tail\n", 5));
+    expected += "Tail\n";
+    return expected;
+}
+
+TEST_CASE("ee::AsyncWriter") {
+
+    std::remove("myAsync.log");
+
+    SECTION("Backend start(Backend) noexcept") {
+        // io_uring may not be available in this environment, the thread pool always is
+        for (auto backend : {ee::AsyncWriter::Backend::IoUring, ee::AsyncWriter::Backend::ThreadPool}) {
+            std::remove("myAsync.log");
+            auto used = ee::AsyncWriter::start(backend);
+            REQUIRE(used != ee::AsyncWriter::Backend::None);
+            REQUIRE(ee::AsyncWriter::getBackend() == used);
+            if (backend == ee::AsyncWriter::Backend::ThreadPool) {
+                REQUIRE(used == ee::AsyncWriter::Backend::ThreadPool);
+            }
+
+            // The blocks complete in any order but land at their offsets
+            auto completions = ee::AsyncWriter::getNumberOfCompletions();
+            std::string expected = "Existing\n";
+            {
+                std::ofstream file("myAsync.log");
+                file << expected;
+            }
+            ee::FileSink sink("myAsync.log");
+            REQUIRE(sink.open());
+            expected += writeBlocks(sink);
+            REQUIRE(sink.sync());
+            REQUIRE(sink.wait());
+            REQUIRE(ee::AsyncWriter::getNumberOfCompletions() > completions);
+            REQUIRE(readFile("myAsync.log") == expected);
+            sink.close();
+        }
+    }
+
+    SECTION("void stop() noexcept") {
+        ee::AsyncWriter::start(ee::AsyncWriter::Backend::ThreadPool);
+        ee::FileSink sink("myAsync.log");
+        REQUIRE(sink.open());
+        auto expected = writeBlocks(sink);
+        REQUIRE(sink.flush());
+
+        // Stopping finishes the writes in flight and later writes happen on the calling thread
+        ee::AsyncWriter::stop();
+        REQUIRE(ee::AsyncWriter::getBackend() == ee::AsyncWriter::Backend::None);
+        REQUIRE(readFile("myAsync.log") == expected);
+        auto completions = ee::AsyncWriter::getNumberOfCompletions();
+        REQUIRE(sink.write("More\n", 5));
+        REQUIRE(sink.flush());
+        REQUIRE(readFile("myAsync.log") == expected + "More\n");
+        REQUIRE(ee::AsyncWriter::getNumberOfCompletions() == completions);
+    }
+
+    SECTION("bool write(const std::shared_ptr<File>&, const char*, size_t, uint64_t, bool) noexcept") {
+        ee::AsyncWriter::start();
+        auto file = std::make_shared<ee::AsyncWriter::File>(::open("myAsync.log", O_WRONLY | O_CREAT, 0644));
+        REQUIRE(file->getFileDescriptor() >= 0);
+
+        // The second block is submitted first
+        REQUIRE(ee::AsyncWriter::write(file, "World", 5, 6));
+        REQUIRE(ee::AsyncWriter::write(file, "Hello ", 6, 0, true));
+        REQUIRE(ee::AsyncWriter::write(file, nullptr, 0, 0, true));
+        ee::AsyncWriter::flush();
+        REQUIRE(file->wait());
+        REQUIRE(readFile("myAsync.log") == "Hello World");
+
+        // A file that can not be written reports the failure
+        auto broken = std::make_shared<ee::AsyncWriter::File>(::open("myAsync.log", O_RDONLY));
+        REQUIRE(ee::AsyncWriter::write(broken, "Lost", 4, 0));
+        REQUIRE_FALSE(broken->wait());
+        REQUIRE(broken->wait());
+
+        // A failed write fails the fsync linked to it as well
+        REQUIRE(ee::AsyncWriter::write(broken, "Lost", 4, 0, true));
+        ee::AsyncWriter::flush();
+        REQUIRE_FALSE(broken->wait());
+    }
+
+    ee::AsyncWriter::stop();
+    std::remove("myAsync.log");
+}
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+#include <ee/EmergencyReserve.hpp>
+
+TEST_CASE("ee::EmergencyReserve") {
+
+    SECTION("static bool reserve(size_t, size_t) noexcept") {
+        REQUIRE(ee::EmergencyReserve::reserve(64 * 1024, 4));
+        REQUIRE(ee::EmergencyReserve::getReservedSize() == 64 * 1024);
+        REQUIRE(std::get_new_handler() != nullptr);
+        ee::EmergencyReserve::release();
+    }
+
+    SECTION("static void release() noexcept") {
+        auto previousHandler = std::get_new_handler();
+        ee::EmergencyReserve::reserve(64 * 1024, 4);
+        ee::EmergencyReserve::release();
+        REQUIRE(ee::EmergencyReserve::getReservedSize() == 0);
+        REQUIRE(std::get_new_handler() == previousHandler);
+    }
+
+    SECTION("The new-handler releases one chunk per failed allocation") {
+        ee::EmergencyReserve::reserve(64 * 1024, 4);
+        REQUIRE(ee::EmergencyReserve::getNumberOfReleases() == 0);
+
+        // Simulate two failed allocations
+        std::get_new_handler()();
+        std::get_new_handler()();
+        REQUIRE(ee::EmergencyReserve::getNumberOfReleases() == 2);
+        REQUIRE(ee::EmergencyReserve::getReservedSize() == 32 * 1024);
+
+        // After the incident the reserve can be restored
+        REQUIRE(ee::EmergencyReserve::refill());
+        REQUIRE(ee::EmergencyReserve::getReservedSize() == 64 * 1024);
+        ee::EmergencyReserve::release();
+    }
+
+    SECTION("An exhausted reserve lets operator new fail as usual") {
+        ee::EmergencyReserve::reserve(1024, 1);
+        std::get_new_handler()();
+        REQUIRE(ee::EmergencyReserve::getReservedSize() == 0);
+        REQUIRE_THROWS_AS(std::get_new_handler()(), std::bad_alloc);
+        ee::EmergencyReserve::release();
+    }
+
+}
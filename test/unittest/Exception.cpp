@@ -22,6 +22,11 @@ TEST_CASE("ee::Exception") {
         }, ee::OutputFormat::Json);
         std::string json = exceptionJson.what();
         REQUIRE_FALSE(json.empty());
+        REQUIRE(json.find('\n') == std::string::npos);
+
+        ee::Exception exceptionEscaped("MyCaller", "My \"quoted\"\nmessage", {}, ee::OutputFormat::Json);
+        std::string escaped = exceptionEscaped.what();
+        REQUIRE(escaped.find("\"message\":\"My \\\"quoted\\\"\\nmessage\"") != std::string::npos);
 
         ee::Exception exceptionString("MyCaller", "MyMessage", {
                 ee::Note("MyNote", "MyValue", "CallerOfThisNote")
@@ -0,0 +1,109 @@
+#include "catch.hpp"
+#include <ee/FileSink.hpp>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Returns the content of the given file.
+ */
+static std::string readFile(const std::string &filename) {
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+TEST_CASE("ee::FileSink") {
+
+    std::remove("mySink.log");
+    ee::FileSink sink("mySink.log");
+
+    SECTION("bool commit() noexcept") {
+        REQUIRE(sink.open());
+        REQUIRE(sink.isOpen());
+
+        // Small blocks stay in the buffer until it is full or flushed
+        sink.getBuffer() += "Hello ";
+        REQUIRE(sink.commit());
+        REQUIRE(sink.getNumberOfWrites() == 0);
+        REQUIRE(readFile("mySink.log").empty());
+        sink.getBuffer().append(ee::FileSink::BufferSize, 'x');
+        REQUIRE(sink.commit());
+        REQUIRE(sink.getNumberOfWrites() == 1);
+        REQUIRE(sink.getBuffer().empty());
+        REQUIRE(readFile("mySink.log").size() == 6 + ee::FileSink::BufferSize);
+    }
+
+    SECTION("bool write(const char*, size_t) noexcept") {
+        REQUIRE(sink.open());
+        REQUIRE(sink.write("Hello ", 6));
+        REQUIRE(sink.getNumberOfWrites() == 0);
+
+        // A large block is written together with the buffer in a single call
+        std::string block(2 * ee::FileSink::BufferSize, 'x');
+        REQUIRE(sink.write(block.data(), block.size()));
+        REQUIRE(sink.getNumberOfWrites() == 1);
+        auto content = readFile("mySink.log");
+        REQUIRE(content.size() == 6 + block.size());
+        REQUIRE(content.compare(0, 6, "Hello ") == 0);
+    }
+
+    SECTION("bool flush() noexcept") {
+        REQUIRE(sink.flush());
+        REQUIRE(sink.getNumberOfWrites() == 0);
+        REQUIRE(sink.open());
+        sink.getBuffer() += "Hello";
+        REQUIRE(sink.flush());
+        REQUIRE(readFile("mySink.log") == "Hello");
+    }
+
+    SECTION("uint64_t getPosition() const noexcept") {
+        {
+            std::ofstream file("mySink.log");
+            file << "Existing";
+        }
+
+        // The position starts behind the existing content and counts the buffered bytes
+        REQUIRE(sink.open());
+        REQUIRE(sink.getPosition() == 8);
+        sink.getBuffer() += "Hello";
+        REQUIRE(sink.getPosition() == 13);
+        std::string block(2 * ee::FileSink::BufferSize, 'x');
+        REQUIRE(sink.write(block.data(), block.size()));
+        REQUIRE(sink.flush());
+        REQUIRE(sink.getPosition() == readFile("mySink.log").size());
+    }
+
+    SECTION("bool open() noexcept") {
+        REQUIRE(sink.open());
+        sink.getBuffer() += "First";
+        REQUIRE(sink.flush());
+
+        // The same file stays open
+        REQUIRE(sink.open());
+        sink.getBuffer() += "Second";
+        REQUIRE(sink.flush());
+        REQUIRE(readFile("mySink.log") == "FirstSecond");
+
+        // A removed file is created again
+        REQUIRE(std::remove("mySink.log") == 0);
+        REQUIRE(sink.open());
+        sink.getBuffer() += "Third";
+        REQUIRE(sink.flush());
+        REQUIRE(readFile("mySink.log") == "Third");
+    }
+
+    SECTION("static std::shared_ptr<FileSink> get(const std::string&) noexcept") {
+        auto first = ee::FileSink::get("mySink.log");
+        REQUIRE(first);
+        REQUIRE(ee::FileSink::get("mySink.log") == first);
+        REQUIRE(first->getFilename() == "mySink.log");
+        ee::FileSink::closeAll();
+        REQUIRE_FALSE(first->isOpen());
+        REQUIRE(ee::FileSink::get("mySink.log") != first);
+    }
+
+    sink.close();
+    ee::FileSink::closeAll();
+    std::remove("mySink.log");
+}
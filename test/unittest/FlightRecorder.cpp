@@ -0,0 +1,98 @@
+#include "catch.hpp"
+#include <ee/FlightRecorder.hpp>
+#include <fstream>
+#include <csignal>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Records the given number of log entries in a child process that is killed afterwards.
+ */
+static void recordAndDie(int numberOfLogEntries, size_t slotSize) {
+    auto pid = fork();
+    if (pid == 0) {
+        if (ee::FlightRecorder::open("myRecorder.bin", slotSize)) {
+            for (int i = 0; i < numberOfLogEntries; i++) {
+                ee::FlightRecorder::record(ee::LogEntry(ee::LogLevel::Info, "MyClass", "MyMethod", std::to_string(i),
+                                                        {}, std::nullopt, std::chrono::system_clock::now(),
+                                                        static_cast<uint64_t>(i)));
+            }
+        }
+        kill(getpid(), SIGKILL);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+/**
+ * @brief Returns the first line of every log entry of the given file.
+ */
+static std::vector<std::string> readLogEntries(const std::string &filename) {
+    std::ifstream file(filename);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("INFO", 0) == 0) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+TEST_CASE("ee::FlightRecorder") {
+
+    std::remove("myRecorder.bin");
+    std::remove("myRecovered.log");
+
+    SECTION("size_t recover(const std::string&, const std::string&) noexcept") {
+        // Nothing to recover
+        REQUIRE(ee::FlightRecorder::recover("myRecorder.bin", "myRecovered.log") == 0);
+
+        // The log entries survive the killed process
+        recordAndDie(100, 64 * 1024);
+        REQUIRE(ee::FlightRecorder::recover("myRecorder.bin", "myRecovered.log") == 100);
+        auto lines = readLogEntries("myRecovered.log");
+        REQUIRE(lines.size() == 100);
+        REQUIRE(lines.front().find("> 0 ::MyClass::") != std::string::npos);
+        REQUIRE(lines.back().find("> 99 ::MyClass::") != std::string::npos);
+
+        // The file is converted only once
+        REQUIRE(ee::FlightRecorder::recover("myRecorder.bin", "myRecovered.log") == 0);
+    }
+
+    SECTION("void record(const LogEntry&) noexcept") {
+        // The ring keeps only the youngest log entries
+        recordAndDie(10000, ee::FlightRecorder::MinSlotSize);
+        auto recovered = ee::FlightRecorder::recover("myRecorder.bin", "myRecovered.log");
+        REQUIRE(recovered > 0);
+        REQUIRE(recovered < 10000);
+        auto lines = readLogEntries("myRecovered.log");
+        REQUIRE(lines.size() == recovered);
+        REQUIRE(lines.back().find("> 9999 ::MyClass::") != std::string::npos);
+    }
+
+    SECTION("void close() noexcept") {
+        auto recorded = ee::FlightRecorder::getNumberOfRecordedLogEntries();
+        REQUIRE(ee::FlightRecorder::open("myRecorder.bin", 64 * 1024));
+        REQUIRE(ee::FlightRecorder::isOpen());
+        std::thread([]() {
+            ee::FlightRecorder::record(ee::LogEntry(ee::LogLevel::Info, "", "", "", {}, std::nullopt,
+                                                    std::chrono::system_clock::now()));
+        }).join();
+        REQUIRE(ee::FlightRecorder::getNumberOfRecordedLogEntries() == recorded + 1);
+
+        // The open file is not recovered, a clean shutdown leaves no file behind
+        REQUIRE(ee::FlightRecorder::recover("myRecorder.bin", "myRecovered.log") == 0);
+        ee::FlightRecorder::close();
+        REQUIRE_FALSE(ee::FlightRecorder::isOpen());
+        REQUIRE(access("myRecorder.bin", F_OK) == -1);
+        ee::FlightRecorder::record(ee::LogEntry(ee::LogLevel::Info, "", "", "", {}, std::nullopt,
+                                                std::chrono::system_clock::now()));
+        REQUIRE(ee::FlightRecorder::getNumberOfRecordedLogEntries() == recorded + 1);
+    }
+
+    ee::FlightRecorder::close();
+    std::remove("myRecorder.bin");
+    std::remove("myRecovered.log");
+}
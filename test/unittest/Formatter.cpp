@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include <ee/Formatter.hpp>
+#include <sstream>
+
+TEST_CASE("ee::Formatter") {
+
+    const ee::LogEntry logEntry(ee::LogLevel::Warning, "MyClass", "MyMethod", "MyMessage", {
+            ee::Note("MyNote", "MyValue", "MyCaller")
+    }, std::make_shared<ee::Stacktrace>(std::map<unsigned short, std::string>{{0, "firstline"}}),
+    std::chrono::system_clock::now());
+
+    SECTION("static void write(std::string&, const LogEntry&, OutputFormat)") {
+        std::string buffer = "prefix";
+        ee::Formatter::write(buffer, logEntry, ee::OutputFormat::String);
+        REQUIRE(buffer.find("prefixWARNING [") == 0);
+        REQUIRE(buffer.find("MyMessage ::MyClass:: --> MyMethod\n") != std::string::npos);
+        REQUIRE(buffer.find("\tMyNote: MyValue --> MyCaller\n") != std::string::npos);
+        REQUIRE(buffer.find("Stacktrace:\n[0] firstline\n") != std::string::npos);
+
+        std::string json;
+        ee::Formatter::write(json, logEntry, ee::OutputFormat::Json);
+        REQUIRE(json.front() == '{');
+        REQUIRE(json.back() == '}');
+        REQUIRE(json.find('\n') == std::string::npos);
+        REQUIRE(json.find("\"level\":\"WARNING\"") != std::string::npos);
+        REQUIRE(json.find("\"notes\":[{\"name\":\"MyNote\",\"value\":\"MyValue\",\"caller\":\"MyCaller\"}]") != std::string::npos);
+        REQUIRE(json.find("\"stacktrace\":[\"firstline\"]") != std::string::npos);
+
+        std::string jsonWithThread;
+        auto threadId = std::this_thread::get_id();
+        ee::Formatter::write(jsonWithThread, logEntry, ee::OutputFormat::Json, &threadId);
+        REQUIRE(jsonWithThread.find("\"thread\":") != std::string::npos);
+    }
+
+    SECTION("static void write(std::string&, const Exception&, OutputFormat)") {
+        ee::Exception exception("MyCaller", "MyMessage", {ee::Note("MyNote", "MyValue")});
+
+        std::string buffer;
+        ee::Formatter::write(buffer, exception, ee::OutputFormat::String);
+        REQUIRE(buffer == exception.what());
+        REQUIRE(buffer.find("In method:\n\tMyCaller\n") != std::string::npos);
+        REQUIRE(buffer.find("MyNote:\n\tMyValue\n") != std::string::npos);
+    }
+
+    SECTION("static void write(std::string&, const Stacktrace&)") {
+        std::string buffer;
+        ee::Formatter::write(buffer, ee::Stacktrace({{0, "first"}, {1, "second"}}));
+        REQUIRE(buffer == "[0] first\n[1] second\n");
+    }
+
+    SECTION("static void writeThreadHeadline(std::string&, const std::thread::id&)") {
+        std::string buffer;
+        ee::Formatter::writeThreadHeadline(buffer, std::this_thread::get_id());
+        std::ostringstream threadId;
+        threadId << std::this_thread::get_id();
+        REQUIRE(buffer == std::string(32, '#') + "### " + threadId.str() + " " + std::string(32, '#') + "\n");
+    }
+
+    SECTION("static void appendJsonString(std::string&, const char*, size_t)") {
+        std::string buffer;
+        ee::Formatter::appendJsonString(buffer, "plain");
+        REQUIRE(buffer == "\"plain\"");
+
+        buffer.clear();
+        ee::Formatter::appendJsonString(buffer, std::string("a\"b\\c\nd\te\x01" "f\0g", 13));
+        REQUIRE(buffer == "\"a\\\"b\\\\c\\nd\\te\\u0001f\\u0000g\"");
+
+        // Characters to escape at every position of long runs, so the vectorized and the scalar path are covered
+        for (size_t position = 0; position < 70; position++) {
+            std::string input(70, 'x');
+            input[position] = '"';
+            std::string expected = "\"" + input.substr(0, position) + "\\\"" + input.substr(position + 1) + "\"";
+            buffer.clear();
+            ee::Formatter::appendJsonString(buffer, input);
+            REQUIRE(buffer == expected);
+        }
+
+        // Bytes above 0x7F belong to utf-8 sequences and are copied as they are
+        buffer.clear();
+        ee::Formatter::appendJsonString(buffer, "\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC");
+        REQUIRE(buffer == "\"\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC\"");
+    }
+
+    SECTION("static void appendNumber(std::string&, uint64_t)") {
+        std::string buffer;
+        ee::Formatter::appendNumber(buffer, 0);
+        buffer += ' ';
+        ee::Formatter::appendNumber(buffer, 18446744073709551615ull);
+        REQUIRE(buffer == "0 18446744073709551615");
+    }
+
+    SECTION("static void appendDatetime(std::string&, const std::chrono::system_clock::time_point&, const char*)") {
+        std::string buffer;
+        ee::Formatter::appendDatetime(buffer, std::chrono::system_clock::now(), "%Y");
+        REQUIRE(buffer.size() == 4);
+    }
+
+    SECTION("static void appendTimestamp(std::string&, const std::chrono::system_clock::time_point&)") {
+        // The cached second is reused, only the fraction changes
+        ee::Formatter::setTimezone(ee::Formatter::Timezone::Utc);
+        REQUIRE(ee::Formatter::getTimezone() == ee::Formatter::Timezone::Utc);
+        std::chrono::system_clock::time_point epoch;
+        std::string buffer;
+        ee::Formatter::appendTimestamp(buffer, epoch + std::chrono::seconds(1614834367) + std::chrono::microseconds(123456));
+        buffer += ' ';
+        ee::Formatter::appendTimestamp(buffer, epoch + std::chrono::seconds(1614834367) + std::chrono::microseconds(7));
+        buffer += ' ';
+        ee::Formatter::appendTimestamp(buffer, epoch - std::chrono::microseconds(1));
+        REQUIRE(buffer == "2021-03-04T05:06:07.123456Z 2021-03-04T05:06:07.000007Z 1969-12-31T23:59:59.999999Z");
+
+        // Local timestamps carry their offset
+        ee::Formatter::setTimezone(ee::Formatter::Timezone::Local);
+        buffer.clear();
+        ee::Formatter::appendTimestamp(buffer, std::chrono::system_clock::now());
+        REQUIRE(buffer.size() == 32);
+        REQUIRE(buffer[10] == 'T');
+        REQUIRE(buffer[19] == '.');
+        REQUIRE((buffer[26] == '+' || buffer[26] == '-'));
+    }
+
+}
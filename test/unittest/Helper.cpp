@@ -43,4 +43,14 @@ TEST_CASE("ee::Helper") {
         REQUIRE(ee::Log::countLogLevels().count(ee::LogLevel::Warning) == 1);
     }
 
+    SECTION("size_t getNumberOfBytes(const std::string&) noexcept") {
+        // Short strings are stored inside the string object
+        REQUIRE(ee::Helper::getNumberOfBytes("") == 0);
+        REQUIRE(ee::Helper::getNumberOfBytes("short") == 0);
+
+        // Long strings allocate at least their length and the terminating zero
+        std::string longString(1000, 'x');
+        REQUIRE(ee::Helper::getNumberOfBytes(longString) >= 1001);
+    }
+
 }
\ No newline at end of file
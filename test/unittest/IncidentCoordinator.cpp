@@ -0,0 +1,97 @@
+#include "catch.hpp"
+#include <ee/IncidentCoordinator.hpp>
+#include <ee/Helper.hpp>
+#include <ee/Log.hpp>
+
+TEST_CASE("ee::IncidentCoordinator") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+
+    ee::LogEntry warning(ee::LogLevel::Warning, "", "", "", {}, std::nullopt, std::chrono::system_clock::now());
+    ee::LogEntry fatal(ee::LogLevel::Fatal, "", "", "", {}, std::nullopt, std::chrono::system_clock::now());
+    auto incidents = ee::IncidentCoordinator::getNumberOfIncidents();
+
+    SECTION("void trigger(const LogEntry&) noexcept") {
+        // Without the coordinator every warning writes its incident
+        REQUIRE_FALSE(ee::IncidentCoordinator::isRunning());
+        ee::IncidentCoordinator::trigger(warning);
+        ee::IncidentCoordinator::trigger(warning);
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents + 2);
+        REQUIRE_FALSE(ee::IncidentCoordinator::isPending());
+
+        // A fatal log entry does not wait for the coordinator
+        ee::IncidentCoordinator::start(std::chrono::seconds(10), std::chrono::seconds(10));
+        ee::IncidentCoordinator::trigger(warning);
+        REQUIRE(ee::IncidentCoordinator::isPending());
+        ee::IncidentCoordinator::trigger(fatal);
+        REQUIRE_FALSE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents + 3);
+    }
+
+    SECTION("void start(const std::chrono::milliseconds&, const std::chrono::milliseconds&, const std::chrono::milliseconds&) noexcept") {
+        // A cascade of warnings is written once after the quiet period
+        ee::IncidentCoordinator::start(std::chrono::milliseconds(50), std::chrono::seconds(10));
+        REQUIRE(ee::IncidentCoordinator::isRunning());
+        for (int i = 0; i < 10; i++) {
+            ee::Log::log(ee::LogLevel::Info, "", "", "Before " + std::to_string(i), {});
+            ee::IncidentCoordinator::trigger(warning);
+        }
+        REQUIRE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents);
+        for (int i = 0; i < 100 && ee::IncidentCoordinator::isPending(); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        REQUIRE_FALSE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents + 1);
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 0);
+
+        // The maximum delay ends an endless cascade
+        ee::IncidentCoordinator::start(std::chrono::milliseconds(100), std::chrono::milliseconds(200));
+        auto start = std::chrono::steady_clock::now();
+        while (ee::IncidentCoordinator::getNumberOfIncidents() == incidents + 1 &&
+               std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+            ee::IncidentCoordinator::trigger(warning);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() > incidents + 1);
+
+        // The tail keeps the incident open after a single warning
+        ee::IncidentCoordinator::start(std::chrono::milliseconds(1), std::chrono::seconds(10), std::chrono::seconds(10));
+        incidents = ee::IncidentCoordinator::getNumberOfIncidents();
+        ee::IncidentCoordinator::trigger(warning);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(ee::IncidentCoordinator::isPending());
+    }
+
+    SECTION("void stop() noexcept") {
+        ee::IncidentCoordinator::start(std::chrono::seconds(10), std::chrono::seconds(10));
+        ee::IncidentCoordinator::trigger(warning);
+        REQUIRE(ee::IncidentCoordinator::isPending());
+
+        // The pending incident is not lost
+        ee::IncidentCoordinator::stop();
+        REQUIRE_FALSE(ee::IncidentCoordinator::isRunning());
+        REQUIRE_FALSE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents + 1);
+    }
+
+    SECTION("void flush() noexcept") {
+        ee::IncidentCoordinator::flush();
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents);
+
+        ee::IncidentCoordinator::start(std::chrono::seconds(10), std::chrono::seconds(10));
+        ee::IncidentCoordinator::trigger(warning);
+        ee::IncidentCoordinator::flush();
+        REQUIRE_FALSE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::IncidentCoordinator::getNumberOfIncidents() == incidents + 1);
+    }
+
+    ee::IncidentCoordinator::stop();
+    for (auto &file : ee::Helper::findLogFiles()) {
+        std::remove(file.c_str());
+    }
+}
@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include <ee/IncidentWriter.hpp>
+#include <ee/Helper.hpp>
+#include <ee/Log.hpp>
+#include <fstream>
+
+/**
+ * @brief Returns the number of log entries of the given file.
+ */
+static size_t countLogEntries(const std::string &filename) {
+    std::ifstream file(filename);
+    std::string line;
+    size_t logEntries = 0;
+    while (std::getline(file, line)) {
+        if (line.rfind("INFO", 0) == 0) {
+            logEntries++;
+        }
+    }
+    return logEntries;
+}
+
+TEST_CASE("ee::IncidentWriter") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+    std::remove("myIncident.log");
+
+    auto snapshot = std::make_shared<ee::LogSnapshot>();
+    for (int i = 0; i < 10; i++) {
+        snapshot->emplace(std::this_thread::get_id()).emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {},
+                                                                    std::nullopt, std::chrono::system_clock::now());
+    }
+
+    SECTION("void submit(const std::string&, std::shared_ptr<const LogSnapshot>) noexcept") {
+        // Without the writer the snapshot is written immediately
+        REQUIRE_FALSE(ee::IncidentWriter::isRunning());
+        ee::IncidentWriter::submit("myIncident.log", snapshot);
+        REQUIRE(countLogEntries("myIncident.log") == 10);
+
+        // The writer thread appends the snapshots in the order they were submitted
+        ee::IncidentWriter::start();
+        REQUIRE(ee::IncidentWriter::isRunning());
+        for (int i = 0; i < 5; i++) {
+            ee::IncidentWriter::submit("myIncident.log", snapshot);
+        }
+        ee::IncidentWriter::flush();
+        REQUIRE(ee::IncidentWriter::getNumberOfPendingSnapshots() == 0);
+        REQUIRE(countLogEntries("myIncident.log") == 60);
+    }
+
+    SECTION("void stop() noexcept") {
+        // The submitted snapshots are not lost
+        ee::IncidentWriter::start();
+        for (int i = 0; i < 5; i++) {
+            ee::IncidentWriter::submit("myIncident.log", snapshot);
+        }
+        ee::IncidentWriter::stop();
+        REQUIRE_FALSE(ee::IncidentWriter::isRunning());
+        REQUIRE(ee::IncidentWriter::getNumberOfPendingSnapshots() == 0);
+        REQUIRE(countLogEntries("myIncident.log") == 50);
+    }
+
+    SECTION("Log::writeIncident(bool) hands the logs over to the writer") {
+        ee::IncidentWriter::start();
+        for (int i = 0; i < 10; i++) {
+            ee::Log::log(ee::LogLevel::Info, "", "", std::to_string(i), {});
+        }
+        ee::Log::writeIncident(true);
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 0);
+        REQUIRE(ee::IncidentWriter::getNumberOfPendingSnapshots() == 0);
+    }
+
+    ee::IncidentWriter::stop();
+    std::remove("myIncident.log");
+    for (auto &file : ee::Helper::findLogFiles()) {
+        std::remove(file.c_str());
+    }
+}
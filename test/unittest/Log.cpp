@@ -1,7 +1,14 @@
 #include "catch.hpp"
 #include <ee/Log.hpp>
+#include <ee/AsyncWriter.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/IncidentWriter.hpp>
+#include <ee/LogDurability.hpp>
 #include <unistd.h>
 #include <sstream>
+#include <fstream>
+#include <thread>
+#include <atomic>
 
 bool fileExists(const std::string& name) {
     return ( access( name.c_str(), F_OK ) != -1 );
@@ -15,7 +22,7 @@ TEST_CASE("ee:Log") {
     ee::Log::removeOutstreams();
     ee::Log::removeLogRetentionPolicies();
 
-    SECTION("const std::map<std::thread::id, std::list<LogEntry>>& getLogThreadMap() noexcept") {
+    SECTION("const std::map<std::thread::id, LogBuffer>& getLogThreadMap() noexcept") {
         ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", "MyMessage", {});
         REQUIRE_FALSE(ee::Log::getLogThreadMap().empty());
     }
@@ -150,6 +157,110 @@ TEST_CASE("ee:Log") {
         REQUIRE(ee::Log::writeToFile("myLog.log", ee::OutputFormat::String));
         REQUIRE(fileExists("myLog.log"));
         REQUIRE(std::remove("myLog.log") == 0);
+
+        // Json writes one entry per line
+        REQUIRE(ee::Log::writeToFile("myLog.jsonl", ee::OutputFormat::Json));
+        std::ifstream file("myLog.jsonl");
+        std::string line;
+        size_t lines = 0;
+        while (std::getline(file, line)) {
+            REQUIRE(line.front() == '{');
+            REQUIRE(line.back() == '}');
+            lines++;
+        }
+        REQUIRE(lines == 10);
+        REQUIRE(std::remove("myLog.jsonl") == 0);
+    }
+
+    SECTION("bool writeToFile(const std::string&, OutputFormat, bool) noexcept") {
+        auto countLines = []() {
+            std::ifstream file("myLog.jsonl");
+            std::string line;
+            size_t lines = 0;
+            while (std::getline(file, line)) {
+                lines++;
+            }
+            return lines;
+        };
+        for (int i = 0; i < 10; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "MyMethod", "MyMessage", {});
+        }
+
+        // Every incremental write only appends the log entries created since the last one
+        REQUIRE(ee::Log::writeToFile("myLog.jsonl", ee::OutputFormat::Json, true));
+        REQUIRE(countLines() == 10);
+        REQUIRE(ee::Log::writeToFile("myLog.jsonl", ee::OutputFormat::Json, true));
+        REQUIRE(countLines() == 10);
+        for (int i = 0; i < 5; i++) {
+            ee::Log::log(ee::LogLevel::Error, "MyClass", "MyMethod", "MyMessage", {});
+        }
+        REQUIRE(ee::Log::writeToFile("myLog.jsonl", ee::OutputFormat::Json, true));
+        REQUIRE(countLines() == 15);
+
+        // A write that fails in the background is repeated by the next incremental write
+        for (int i = 0; i < 5; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "MyMethod", "MyMessage", {});
+        }
+        ee::AsyncWriter::start();
+        REQUIRE_FALSE(ee::Log::writeToFile("/dev/full", ee::OutputFormat::Json, true));
+        ee::FileSink::release("/dev/full");
+        ee::LogDurability::markRemoved("/dev/full");
+        ee::AsyncWriter::stop();
+        REQUIRE(ee::Log::writeToFile("myLog.jsonl", ee::OutputFormat::Json, true));
+        REQUIRE(countLines() == 20);
+
+        // The log entries stay in memory for a full write
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 20);
+        REQUIRE(ee::Log::writeToFile("myLog.jsonl", ee::OutputFormat::Json));
+        REQUIRE(countLines() == 40);
+        REQUIRE(std::remove("myLog.jsonl") == 0);
+    }
+
+    SECTION("std::shared_ptr<LogSnapshot> takeSnapshot(const std::chrono::system_clock::time_point&, const std::chrono::system_clock::time_point&) noexcept") {
+        for (int i = 0; i < 10; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "MyMethod", "MyMessage", {});
+        }
+
+        // The log is empty afterwards, but the buffer of this thread remains
+        auto snapshot = ee::Log::takeSnapshot();
+        REQUIRE(snapshot);
+        REQUIRE(snapshot->size() == 10);
+        REQUIRE(snapshot->getThreads().count(std::this_thread::get_id()) == 1);
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 0);
+        REQUIRE(ee::Log::getLogThreadMap().count(std::this_thread::get_id()) == 1);
+
+        // Logging continues while the snapshot is written
+        ee::Log::log(ee::LogLevel::Info, "MyClass", "MyMethod", "MyMessage", {});
+        REQUIRE(snapshot->writeToFile("mySnapshot.log"));
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 1);
+        REQUIRE(std::remove("mySnapshot.log") == 0);
+
+        // Snapshots taken on another thread never take a log entry its thread still formats
+        ee::Log::reset();
+        std::stringstream stream;
+        ee::Log::registerOutstream(ee::LogLevel::Info, stream, ee::OutputFormat::Json);
+        std::atomic_bool running = true;
+        size_t moved = 0;
+        std::thread coordinator([&running, &moved]() {
+            while (running) {
+                auto snapshot = ee::Log::takeSnapshot();
+                moved += snapshot ? snapshot->size() : 0;
+            }
+        });
+        for (int i = 0; i < 10000; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "MyMethod", "MyMessage", {});
+        }
+        running = false;
+        coordinator.join();
+        ee::Log::removeOutstreams();
+        REQUIRE(moved + ee::Log::getNumberOfLogEntries() == 10000);
+        size_t lines = 0;
+        bool complete = true;
+        for (std::string line; std::getline(stream, line); lines++) {
+            complete = line.find("\"MyMessage\"") != std::string::npos && complete;
+        }
+        REQUIRE(complete);
+        REQUIRE(lines == 10000);
     }
 
     SECTION("void registerOutstream(LogLevel, std::ostream&) noexcept") {
@@ -173,6 +284,13 @@ TEST_CASE("ee:Log") {
 
         // We have to remove the outstream because it will be destroyed here on end of scope
         ee::Log::removeOutstreams();
+
+        // Register a stream that prints json lines
+        stringBuffer.str("");
+        ee::Log::registerOutstream(ee::LogLevel::Warning, stream, ee::OutputFormat::Json);
+        ee::Log::log(ee::LogLevel::Warning, "MyClass", "SomeMethod", "My \"quoted\" message", {});
+        REQUIRE(stringBuffer.str().find("\"message\":\"My \\\"quoted\\\" message\"}\n") != std::string::npos);
+        ee::Log::removeOutstreams();
     }
 
     SECTION("void removeOutstreams() noexcept") {
@@ -206,6 +324,8 @@ TEST_CASE("ee:Log") {
 
         REQUIRE(ee::Log::getOutstreams().size() == 4);
         REQUIRE(ee::Log::getCallbackMap().size() == 3);
+        REQUIRE(ee::IncidentWriter::isRunning());
+        ee::IncidentWriter::stop();
     }
 
     SECTION("void registerLogRententionPolicy(std::shared_ptr<LogRetentionPolicy>) noexcept") {
@@ -214,6 +334,15 @@ TEST_CASE("ee:Log") {
         ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(16));
 
         REQUIRE(ee::Log::getLogRetentionPolicies().size() == 1);
+
+        // The same kind of policy for the same log levels is replaced
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(32));
+        REQUIRE(ee::Log::getLogRetentionPolicies().size() == 1);
+
+        // Other log levels are added
+        ee::Log::registerLogRententionPolicy(
+                std::make_shared<ee::LogRetentionMaxNumber>(32, ee::LogLevel::Trace, ee::LogLevel::Info));
+        REQUIRE(ee::Log::getLogRetentionPolicies().size() == 2);
     }
 
     SECTION("void removeLogRetentionPolicies() noexcept") {
@@ -224,13 +353,13 @@ TEST_CASE("ee:Log") {
         REQUIRE(ee::Log::getLogRetentionPolicies().empty());
     }
 
-    SECTION("const std::map<uint8_t,std::shared_ptr<LogRetentionPolicy>>& getLogRetentionPolicies() noexcept") {
+    SECTION("const std::multimap<uint8_t,std::shared_ptr<LogRetentionPolicy>>& getLogRetentionPolicies() noexcept") {
         REQUIRE(ee::Log::getLogRetentionPolicies().empty());
         ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(16));
         REQUIRE(ee::Log::getLogRetentionPolicies().size() == 1);
     }
 
-    SECTION("void releaseLogs() noexcept") {
+    SECTION("size_t releaseLogs() noexcept") {
         // Create 64 logs
         for (int i = 0; i < 64; i++) {
             ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", "MyMessage", {});
@@ -239,8 +368,98 @@ TEST_CASE("ee:Log") {
 
         // Register log retention policy that only retains 32 log entries
         ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(32));
-        ee::Log::releaseLogs();
+        auto releasedBefore = ee::Log::getNumberOfReleasedLogEntries();
+        REQUIRE(ee::Log::releaseLogs() == 32);
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 32);
+        REQUIRE(ee::Log::getNumberOfReleasedLogEntries() == releasedBefore + 32);
+
+        // Nothing left to release
+        REQUIRE(ee::Log::releaseLogs() == 0);
+    }
+
+    SECTION("size_t getNumberOfBytes() noexcept") {
+        REQUIRE(ee::Log::getNumberOfBytes() == 0);
+        ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", "MyMessage", {});
+        auto numberOfBytes = ee::Log::getNumberOfBytes();
+        REQUIRE(numberOfBytes > sizeof(ee::LogEntry));
+
+        // Long messages add their length
+        ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::string(1000, 'x'), {});
+        REQUIRE(ee::Log::getNumberOfBytes() > numberOfBytes + 1000);
+    }
+
+    SECTION("size_t compressLogs(const std::chrono::milliseconds&) noexcept") {
+        for (int i = 0; i < 100; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::to_string(i), {});
+        }
+        auto numberOfBytes = ee::Log::getNumberOfBytes();
+
+        // Nothing is old enough yet
+        REQUIRE(ee::Log::compressLogs(std::chrono::hours(1)) == 0);
+
+        // The youngest segment remains, because it is still appended to
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        REQUIRE(ee::Log::compressLogs(std::chrono::milliseconds(1)) > 0);
+        REQUIRE(ee::Log::getNumberOfBytes() < numberOfBytes);
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 100);
+
+        // The log retention works with compressed segments
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(50));
+        REQUIRE(ee::Log::releaseLogs() == 50);
+        size_t i = 50;
+        for (auto &logEntry : ee::Log::getLogThreadMap().at(std::this_thread::get_id())) {
+            REQUIRE(logEntry.getMessage() == std::to_string(i++));
+        }
+        REQUIRE(i == 100);
+    }
+
+    SECTION("void startRetentionThread(const std::chrono::milliseconds&) noexcept") {
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(32));
+        ee::Log::startRetentionThread(std::chrono::milliseconds(1));
+        REQUIRE(ee::Log::isRetentionThreadRunning());
+
+        // Keep logging while the housekeeping thread releases logs, the outstream and the callback still see every
+        // log entry intact
+        std::stringstream stream;
+        ee::Log::registerOutstream(ee::LogLevel::Warning, stream, ee::OutputFormat::Json);
+        size_t intact = 0;
+        ee::Log::registerCallback(ee::LogLevel::Warning, [&intact](const ee::LogEntry &logEntry) {
+            intact += logEntry.getMessage() == "MyWarning" ? 1 : 0;
+        });
+        for (int i = 0; i < 10000; i++) {
+            ee::Log::log(i % 10 == 0 ? ee::LogLevel::Warning : ee::LogLevel::Info, "MyClass", "SomeMethod",
+                         i % 10 == 0 ? "MyWarning" : "MyMessage", {});
+        }
+        REQUIRE(intact == 1000);
+        size_t lines = 0;
+        bool complete = true;
+        for (std::string line; std::getline(stream, line); lines++) {
+            complete = line.find("\"MyWarning\"") != std::string::npos && complete;
+        }
+        REQUIRE(complete);
+        REQUIRE(lines == 1000);
+
+        // Wait until the housekeeping thread has done its work
+        for (int i = 0; i < 1000 && ee::Log::getNumberOfLogEntries() > 32; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
         REQUIRE(ee::Log::getNumberOfLogEntries() == 32);
+
+        ee::Log::stopRetentionThread();
+        REQUIRE_FALSE(ee::Log::isRetentionThreadRunning());
+    }
+
+    SECTION("void stopRetentionThread() noexcept") {
+        // Stopping without a running thread does nothing
+        ee::Log::stopRetentionThread();
+        REQUIRE_FALSE(ee::Log::isRetentionThreadRunning());
+
+        // A long period must not delay stopping
+        ee::Log::startRetentionThread(std::chrono::hours(1));
+        auto start = std::chrono::steady_clock::now();
+        ee::Log::stopRetentionThread();
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+        REQUIRE_FALSE(ee::Log::isRetentionThreadRunning());
     }
 
     SECTION("std::map<LogLevel,size_t> countLogLevels() noexcept") {
@@ -0,0 +1,236 @@
+#include "catch.hpp"
+#include <ee/LogBuffer.hpp>
+#include <thread>
+
+TEST_CASE("ee::LogBuffer") {
+
+    auto now = std::chrono::system_clock::now();
+    ee::LogBuffer buffer;
+
+    SECTION("LogEntry& emplace_back(...)") {
+        REQUIRE(buffer.empty());
+        for (size_t i = 0; i < 3 * ee::LogSegment::MaxCapacity; i++) {
+            buffer.emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {}, std::nullopt, now);
+        }
+        REQUIRE(buffer.size() == 3 * ee::LogSegment::MaxCapacity);
+        REQUIRE(buffer.getSegments(ee::LogLevel::Info).size() > 1);
+
+        // The iterator visits all log entries in order
+        size_t i = 0;
+        for (auto &logEntry : buffer) {
+            REQUIRE(logEntry.getMessage() == std::to_string(i++));
+        }
+        REQUIRE(i == buffer.size());
+    }
+
+    SECTION("Every log level has its own chain of segments") {
+        // Interleave the log levels
+        for (int i = 0; i < 100; i++) {
+            buffer.emplace_back(i % 3 == 0 ? ee::LogLevel::Trace : ee::LogLevel::Error, "", "", std::to_string(i), {},
+                                std::nullopt, now);
+        }
+        REQUIRE(buffer.size(ee::LogLevel::Trace) == 34);
+        REQUIRE(buffer.size(ee::LogLevel::Error) == 66);
+        REQUIRE(buffer.getSegments(ee::LogLevel::Info).empty());
+        REQUIRE(buffer.getSegments(ee::LogLevel::Trace).front().getEntries().front().getLogLevel() == ee::LogLevel::Trace);
+
+        // The iterator restores the order of creation, the sequence numbers are shared by all buffers
+        size_t i = 0;
+        auto first = buffer.begin()->getSequenceNumber();
+        for (auto &logEntry : buffer) {
+            REQUIRE(logEntry.getSequenceNumber() == first + i);
+            REQUIRE(logEntry.getMessage() == std::to_string(i++));
+        }
+        REQUIRE(i == 100);
+
+        // Releasing a log level keeps the others
+        while (!buffer.getSegments(ee::LogLevel::Trace).empty()) {
+            buffer.release(ee::LogLevel::Trace, 0);
+        }
+        REQUIRE(buffer.size() == 66);
+        REQUIRE(buffer.begin()->getMessage() == "1");
+    }
+
+    SECTION("size_t release(LogLevel, size_t) noexcept") {
+        for (size_t i = 0; i < 2 * ee::LogSegment::MaxCapacity; i++) {
+            buffer.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        }
+        auto segments = buffer.getSegments(ee::LogLevel::Info).size();
+        auto released = buffer.getSegments(ee::LogLevel::Info).front().size();
+        REQUIRE(buffer.release(ee::LogLevel::Info, 0) == released);
+        REQUIRE(buffer.getSegments(ee::LogLevel::Info).size() == segments - 1);
+        REQUIRE(buffer.size() == 2 * ee::LogSegment::MaxCapacity - released);
+    }
+
+    SECTION("size_t release(LogLevel, size_t, const std::vector<bool>&) noexcept") {
+        for (int i = 0; i < 4; i++) {
+            buffer.emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {}, std::nullopt, now);
+        }
+        REQUIRE(buffer.release(ee::LogLevel::Info, 0, {false, true, true, false}) == 2);
+        REQUIRE(buffer.size() == 2);
+        REQUIRE(buffer.begin()->getMessage() == "0");
+        REQUIRE((++buffer.begin())->getMessage() == "3");
+
+        // Segments that become empty are removed
+        REQUIRE(buffer.release(ee::LogLevel::Info, 0, {true, true}) == 2);
+        REQUIRE(buffer.getSegments(ee::LogLevel::Info).empty());
+        REQUIRE(buffer.begin() == buffer.end());
+    }
+
+    SECTION("size_t getNumberOfBytes() const noexcept") {
+        REQUIRE(buffer.getNumberOfBytes() == 0);
+
+        // The first log entry reserves the whole segment
+        auto stacktrace = ee::Stacktrace::create();
+        buffer.emplace_back(ee::LogLevel::Info, "", "", "", {}, stacktrace, now);
+        auto first = buffer.getNumberOfBytes();
+        auto &segment = buffer.getSegments(ee::LogLevel::Info).front();
+        REQUIRE(first == sizeof(ee::LogSegment) + segment.getCapacity() * sizeof(ee::LogEntry) +
+                         stacktrace.value()->getNumberOfBytes());
+
+        // The shared stacktrace is counted only once
+        buffer.emplace_back(ee::LogLevel::Info, "", "", std::string(1000, 'x'), {}, stacktrace, now);
+        REQUIRE(buffer.getNumberOfBytes() == first + segment.getEntries()[1].getNumberOfBytes() - sizeof(ee::LogEntry));
+        REQUIRE(buffer.release(ee::LogLevel::Info, 0, {false, true}) == 1);
+        REQUIRE(buffer.getNumberOfBytes() == first);
+
+        // Releasing everything releases all bytes
+        REQUIRE(buffer.release(ee::LogLevel::Info, 0) == 1);
+        REQUIRE(buffer.getNumberOfBytes() == 0);
+    }
+
+    SECTION("bool compress(LogLevel, size_t) noexcept") {
+        auto stacktrace = ee::Stacktrace::create();
+        for (size_t i = 0; i < 100; i++) {
+            buffer.emplace_back(ee::LogLevel::Info, "MyClass", "MyMethod", "Message " + std::to_string(i), {},
+                    stacktrace, now);
+        }
+        auto numberOfBytes = buffer.getNumberOfBytes();
+        auto &chain = buffer.getSegments(ee::LogLevel::Info);
+        REQUIRE(chain.size() > 1);
+
+        // The youngest segment is still appended to
+        REQUIRE_FALSE(buffer.compress(ee::LogLevel::Info, chain.size() - 1));
+        REQUIRE(buffer.compress(ee::LogLevel::Info, 0));
+        REQUIRE(chain[0].isCompressed());
+        REQUIRE(buffer.getNumberOfBytes() < numberOfBytes);
+        REQUIRE(buffer.size() == 100);
+
+        // Iterating thaws the segment, it has its own copy of the stacktrace the other segment still holds
+        size_t i = 0;
+        for (auto &logEntry : buffer) {
+            REQUIRE(logEntry.getMessage() == "Message " + std::to_string(i++));
+        }
+        REQUIRE(i == 100);
+        REQUIRE_FALSE(chain[0].isCompressed());
+        REQUIRE(buffer.getNumberOfBytes() == numberOfBytes + stacktrace.value()->getNumberOfBytes());
+
+        // Compressed segments are released without thawing them
+        REQUIRE(buffer.compress(ee::LogLevel::Info, 0));
+        auto released = chain[0].size();
+        REQUIRE(buffer.release(ee::LogLevel::Info, 0) == released);
+        REQUIRE(buffer.size() == 100 - released);
+
+        // Releasing single log entries thaws the segment first
+        buffer.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        while (!chain.back().full()) {
+            buffer.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        }
+        REQUIRE(buffer.compress(ee::LogLevel::Info, chain.size() - 1));
+        REQUIRE(buffer.release(ee::LogLevel::Info, chain.size() - 1, {true}) == 1);
+        REQUIRE_FALSE(chain.back().isCompressed());
+
+        buffer.clear();
+        REQUIRE(buffer.getNumberOfBytes() == 0);
+    }
+
+    SECTION("const_iterator begin() const noexcept") {
+        for (size_t i = 0; i < 3 * ee::LogSegment::MaxCapacity; i++) {
+            buffer.emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {}, std::nullopt, now);
+        }
+
+        // The housekeeping thread compresses the segments while a reader thaws them
+        std::atomic_bool running = true;
+        std::thread housekeeping([&buffer, &running]() {
+            while (running) {
+                std::lock_guard<std::recursive_mutex> lock(buffer.getMutex());
+                buffer.compress(ee::LogLevel::Info, 0);
+            }
+        });
+        bool complete = true;
+        for (int round = 0; round < 100; round++) {
+            // The reader holds the mutex while iterating, thawing locks it again
+            std::lock_guard<std::recursive_mutex> lock(buffer.getMutex());
+            size_t i = 0;
+            for (auto &logEntry : buffer) {
+                complete = logEntry.getMessage() == std::to_string(i++) && complete;
+            }
+            complete = i == buffer.size() && complete;
+        }
+        running = false;
+        housekeeping.join();
+        REQUIRE(complete);
+    }
+
+    SECTION("const_iterator begin(uint64_t) const noexcept") {
+        for (size_t i = 0; i < 3 * ee::LogSegment::MaxCapacity; i++) {
+            buffer.emplace_back(i % 3 == 0 ? ee::LogLevel::Info : ee::LogLevel::Error, "", "", std::to_string(i), {},
+                                std::nullopt, now);
+        }
+        auto first = buffer.begin()->getSequenceNumber();
+        REQUIRE(buffer.getMaxSequenceNumber() == first + 3 * ee::LogSegment::MaxCapacity - 1);
+        REQUIRE(buffer.getWatermark() == 0);
+
+        // The older segments stay compressed while we visit the younger log entries
+        auto &chain = buffer.getSegments(ee::LogLevel::Error);
+        REQUIRE(buffer.compress(ee::LogLevel::Error, 0));
+        size_t from = 2 * ee::LogSegment::MaxCapacity + 1;
+        size_t i = from;
+        for (auto it = buffer.begin(first + from); it != buffer.end(); ++it) {
+            REQUIRE(it->getMessage() == std::to_string(i++));
+        }
+        REQUIRE(i == 3 * ee::LogSegment::MaxCapacity);
+        REQUIRE(chain[0].isCompressed());
+        REQUIRE(buffer.size(first + from) >= 3 * ee::LogSegment::MaxCapacity - from);
+        REQUIRE(buffer.size(first + from) < buffer.size());
+
+        // Nothing is left behind the youngest log entry
+        buffer.setWatermark(buffer.getMaxSequenceNumber() + 1);
+        REQUIRE(buffer.begin(buffer.getWatermark()) == buffer.end());
+        REQUIRE(buffer.size(buffer.getWatermark()) == 0);
+        REQUIRE(buffer.begin(0)->getMessage() == "0");
+    }
+
+    SECTION("void moveTo(LogBuffer&) noexcept") {
+        for (size_t i = 0; i < 2 * ee::LogSegment::MaxCapacity; i++) {
+            buffer.emplace_back(i % 2 == 0 ? ee::LogLevel::Info : ee::LogLevel::Error, "", "", std::to_string(i), {},
+                                std::nullopt, now);
+        }
+        auto numberOfBytes = buffer.getNumberOfBytes();
+
+        // All log entries change hands in their order
+        ee::LogBuffer target;
+        buffer.moveTo(target);
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.getNumberOfBytes() == 0);
+        REQUIRE(target.size() == 2 * ee::LogSegment::MaxCapacity);
+        REQUIRE(target.getNumberOfBytes() == numberOfBytes);
+        size_t i = 0;
+        uint64_t last = 0;
+        for (auto &logEntry : target) {
+            REQUIRE(logEntry.getMessage() == std::to_string(i++));
+            last = logEntry.getSequenceNumber();
+        }
+
+        // New log entries are younger than the moved ones
+        auto &logEntry = buffer.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        REQUIRE(logEntry.getSequenceNumber() > last);
+    }
+
+    SECTION("void clear() noexcept") {
+        buffer.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        buffer.clear();
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.cbegin() == buffer.cend());
+    }
+}
@@ -0,0 +1,59 @@
+#include "catch.hpp"
+#include <ee/LogCodec.hpp>
+
+TEST_CASE("ee::LogCodec") {
+
+    auto now = std::chrono::system_clock::now();
+
+    SECTION("void encode(std::string&, const LogEntry&, size_t)") {
+        std::string buffer = "prefix";
+        ee::LogEntry logEntry(ee::LogLevel::Info, "MyClass", "MyMethod", "MyMessage", {}, std::nullopt, now);
+        ee::LogCodec::encode(buffer, logEntry, 42);
+        REQUIRE(buffer.compare(0, 6, "prefix") == 0);
+        REQUIRE(buffer[6] == static_cast<char>(ee::LogCodec::Version));
+        REQUIRE(buffer[7] == static_cast<char>(ee::LogLevel::Info));
+    }
+
+    SECTION("std::optional<LogEntry> decode(const char*, size_t, size_t&) noexcept") {
+        auto stacktrace = ee::Stacktrace::create();
+        ee::LogEntry logEntry(ee::LogLevel::Error, "MyClass", "MyMethod", "MyMessage",
+                {ee::Note("Name", "Value", "Caller"), ee::Note("Index", 7)}, stacktrace, now, 123);
+        std::string buffer;
+        ee::LogCodec::encode(buffer, logEntry, 42);
+
+        size_t threadHash = 0;
+        auto decoded = ee::LogCodec::decode(buffer.data(), buffer.size(), threadHash);
+        REQUIRE(decoded.has_value());
+        REQUIRE(threadHash == 42);
+        REQUIRE(decoded->getLogLevel() == ee::LogLevel::Error);
+        REQUIRE(decoded->getClassname() == "MyClass");
+        REQUIRE(decoded->getMethod() == "MyMethod");
+        REQUIRE(decoded->getMessage() == "MyMessage");
+        REQUIRE(decoded->getNotes().size() == 2);
+        REQUIRE(decoded->getNotes()[0].getName() == "Name");
+        REQUIRE(decoded->getNotes()[0].getValue() == "Value");
+        REQUIRE(decoded->getNotes()[0].getCaller() == "Caller");
+        REQUIRE(decoded->getNotes()[1].getValue() == "7");
+        REQUIRE(decoded->getStacktrace().has_value());
+        REQUIRE(decoded->getStacktrace().value()->getLines() == stacktrace.value()->getLines());
+        REQUIRE(decoded->getDateOfCreation() == now);
+        REQUIRE(decoded->getSequenceNumber() == 123);
+
+        // Without a stacktrace
+        buffer.clear();
+        ee::LogCodec::encode(buffer, ee::LogEntry(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now), 1);
+        decoded = ee::LogCodec::decode(buffer.data(), buffer.size(), threadHash);
+        REQUIRE(decoded.has_value());
+        REQUIRE_FALSE(decoded->getStacktrace().has_value());
+
+        // Truncated records are rejected
+        for (size_t size = 0; size < buffer.size(); size++) {
+            REQUIRE_FALSE(ee::LogCodec::decode(buffer.data(), size, threadHash).has_value());
+        }
+
+        // Unknown versions are rejected
+        buffer[0] = 0;
+        REQUIRE_FALSE(ee::LogCodec::decode(buffer.data(), buffer.size(), threadHash).has_value());
+    }
+
+}
@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include <ee/LogDurability.hpp>
+#include <ee/FileSink.hpp>
+#include <ee/Helper.hpp>
+#include <ee/IncidentCoordinator.hpp>
+#include <ee/Log.hpp>
+#include <vector>
+
+TEST_CASE("ee::LogDurability") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+    std::remove("myDurable.log");
+    ee::LogDurability::sync();
+    auto syncs = ee::LogDurability::getNumberOfSyncs();
+
+    SECTION("bool sync() noexcept") {
+        // Every sink marks the files it wrote
+        {
+            ee::FileSink sink("myDurable.log");
+            REQUIRE(sink.write("Hello\n", 6));
+            REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+            REQUIRE(sink.flush());
+        }
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 1);
+        REQUIRE(ee::LogDurability::sync());
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs + 1);
+
+        // A file that vanished before it was synced lost its data, unless it was removed on purpose
+        ee::LogDurability::markDirty("myMissing.log");
+        REQUIRE_FALSE(ee::LogDurability::sync());
+        ee::LogDurability::markDirty("myMissing.log");
+        ee::LogDurability::markRemoved("myMissing.log");
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+
+        // A created file is synced together with its folder
+        ee::LogDurability::markDirty("myDurable.log", true);
+        ee::LogDurability::markDirty("myDurable.log");
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 1);
+        REQUIRE(ee::LogDurability::sync());
+        ee::LogDurability::markDirty("myMissingFolder/myDurable.log", true);
+        REQUIRE_FALSE(ee::LogDurability::sync());
+
+        // Concurrent requests share the syncs
+        syncs = ee::LogDurability::getNumberOfSyncs();
+        std::vector<std::thread> threads;
+        std::atomic_size_t failures(0);
+        for (int i = 0; i < 8; i++) {
+            threads.emplace_back([&failures]() {
+                for (int j = 0; j < 20; j++) {
+                    ee::LogDurability::markDirty("myDurable.log");
+                    if (!ee::LogDurability::sync()) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        REQUIRE(failures == 0);
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() <= syncs + 1 + 8 * 20);
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+    }
+
+    SECTION("void setMode(Mode, const std::chrono::milliseconds&) noexcept") {
+        // The periodic mode syncs the dirty files in the background
+        ee::LogDurability::setMode(ee::LogDurability::Mode::Periodic, std::chrono::milliseconds(10));
+        REQUIRE(ee::LogDurability::getMode() == ee::LogDurability::Mode::Periodic);
+        ee::LogDurability::markDirty("myDurable.log");
+        for (int i = 0; i < 200 && ee::LogDurability::getNumberOfDirtyFiles() > 0; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() > syncs);
+    }
+
+    SECTION("bool commit(bool) noexcept") {
+        // Without a mode only explicit requests sync
+        ee::LogDurability::setMode(ee::LogDurability::Mode::None);
+        REQUIRE(ee::LogDurability::commit(true));
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs);
+
+        // The periodic mode syncs fatal incidents immediately
+        ee::LogDurability::setMode(ee::LogDurability::Mode::Periodic, std::chrono::hours(1));
+        REQUIRE(ee::LogDurability::commit());
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs);
+        REQUIRE(ee::LogDurability::commit(true));
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs + 1);
+
+        // The group commit mode syncs after every incident
+        ee::LogDurability::setMode(ee::LogDurability::Mode::GroupCommit);
+        ee::Log::log(ee::LogLevel::Info, "", "", "Before", {});
+        ee::Log::writeIncident();
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs + 2);
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+    }
+
+    SECTION("bool Log::flush(bool) noexcept") {
+        // The pending incident is written and synced
+        ee::IncidentCoordinator::start(std::chrono::seconds(10), std::chrono::seconds(10));
+        ee::Log::log(ee::LogLevel::Info, "", "", "Before", {});
+        ee::IncidentCoordinator::trigger(ee::LogEntry(ee::LogLevel::Warning, "", "", "", {}, std::nullopt,
+                                                      std::chrono::system_clock::now()));
+        REQUIRE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::Log::flush());
+        REQUIRE_FALSE(ee::IncidentCoordinator::isPending());
+        REQUIRE(ee::LogDurability::getNumberOfDirtyFiles() == 0);
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs + 1);
+        REQUIRE(ee::Log::flush(false));
+        REQUIRE(ee::LogDurability::getNumberOfSyncs() == syncs + 1);
+        ee::IncidentCoordinator::stop();
+    }
+
+    ee::LogDurability::setMode(ee::LogDurability::Mode::None);
+    std::remove("myDurable.log");
+    for (auto &file : ee::Helper::findLogFiles()) {
+        std::remove(file.c_str());
+    }
+}
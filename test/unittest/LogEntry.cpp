@@ -54,6 +54,24 @@ TEST_CASE("ee::LogEntry") {
         REQUIRE(logEntry.getDateOfCreation() == dateOfCreation);
     }
 
+    SECTION("size_t getNumberOfBytes() const noexcept") {
+        REQUIRE(logEntry.getNumberOfBytes() >= sizeof(ee::LogEntry) + 3 * sizeof(ee::Note));
+
+        // Long messages are allocated on the heap
+        const ee::LogEntry longLogEntry(ee::LogLevel::Info, "MyClass", "MyMethod", std::string(1000, 'x'), {
+                ee::Note("MyNote", "MyValue", __PRETTY_FUNCTION__),
+                ee::Note("MyAge", 21, __PRETTY_FUNCTION__),
+                ee::Note("MyWeight", 88.3f, __PRETTY_FUNCTION__)
+        }, std::nullopt, dateOfCreation);
+        REQUIRE(longLogEntry.getNumberOfBytes() >= logEntry.getNumberOfBytes() + 1000);
+    }
+
+    SECTION("uint64_t getSequenceNumber() const noexcept") {
+        REQUIRE(logEntry.getSequenceNumber() == 0);
+        const ee::LogEntry numberedLogEntry(ee::LogLevel::Info, "", "", "", {}, std::nullopt, dateOfCreation, 42);
+        REQUIRE(numberedLogEntry.getSequenceNumber() == 42);
+    }
+
     SECTION("void write(std::ostream&) const noexcept") {
         // Create a out stream buffer that simulates e.g. std::cout
         std::stringbuf stringBuffer;
@@ -0,0 +1,117 @@
+#include "catch.hpp"
+#include <ee/LogIndex.hpp>
+#include <ee/LogMerge.hpp>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+/**
+ * @brief Returns the number of lines of the given text.
+ */
+static size_t countLines(const std::string &content) {
+    return static_cast<size_t>(std::count(content.begin(), content.end(), '\n'));
+}
+
+TEST_CASE("ee::LogIndex") {
+
+    std::remove("myIndex.log");
+    auto now = std::chrono::system_clock::now();
+    std::map<std::thread::id, ee::LogBuffer> threads;
+    std::thread::id first = std::this_thread::get_id();
+    std::thread::id second;
+    std::thread([&second]() { second = std::this_thread::get_id(); }).join();
+
+    // Enough log entries for several index lines, the second thread only logs a few errors
+    size_t numberOfLogEntries = 0;
+    for (size_t i = 0; i < (ee::LogIndex::BlocksPerIndex + 8) * ee::LogIndex::EntriesPerBlock; i++) {
+        auto date = now + std::chrono::milliseconds(i);
+        threads[first].emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {}, std::nullopt, date);
+        if (i % 20000 == 10000) {
+            threads[second].emplace_back(ee::LogLevel::Error, "", "", "Error " + std::to_string(i), {}, std::nullopt,
+                                         date);
+            numberOfLogEntries++;
+        }
+        numberOfLogEntries++;
+    }
+
+    SECTION("static bool readBlocks(const std::string&, std::vector<Block>&) noexcept") {
+        // A file without an index has no footer
+        {
+            ee::FileSink sink("myIndex.log");
+            REQUIRE(sink.open());
+            ee::LogMerge(threads).write(sink, ee::OutputFormat::Json);
+        }
+        std::vector<ee::LogIndex::Block> blocks;
+        REQUIRE_FALSE(ee::LogIndex::readBlocks("myIndex.log", blocks));
+
+        // The merges on one and on several threads are indexed and chained
+        ee::LogIndex::setEnabled(true);
+        REQUIRE(ee::LogIndex::isEnabled());
+        auto workers = ee::LogMerge::getNumberOfWorkers();
+        for (size_t numberOfWorkers : {size_t(1), size_t(3)}) {
+            ee::LogMerge::setNumberOfWorkers(numberOfWorkers);
+            ee::FileSink sink("myIndex.log");
+            REQUIRE(sink.open());
+            ee::LogMerge(threads).write(sink, ee::OutputFormat::Json);
+        }
+        ee::LogMerge::setNumberOfWorkers(workers);
+        ee::LogIndex::setEnabled(false);
+
+        // Every block holds whole log entries and the indexed merges hold all of them
+        REQUIRE(ee::LogIndex::readBlocks("myIndex.log", blocks));
+        REQUIRE(blocks.size() > ee::LogIndex::BlocksPerIndex);
+        size_t lines = 0;
+        uint64_t end = blocks.front().offset;
+        bool complete = true;
+        for (auto &block : blocks) {
+            std::string content;
+            complete = ee::LogIndex::readContent("myIndex.log", block, content) && complete;
+            complete = !content.empty() && content.front() == '{' && content.back() == '\n' && complete;
+            complete = content.find("eeIndex") == std::string::npos && content.find("eeFooter") == std::string::npos &&
+                       complete;
+            complete = block.offset >= end && complete;
+            end = block.offset + block.size;
+            lines += countLines(content);
+        }
+        REQUIRE(complete);
+        REQUIRE(lines == 2 * numberOfLogEntries);
+
+        // The file still starts with the merge that has not been indexed
+        REQUIRE(blocks.front().offset > 0);
+    }
+
+    SECTION("static std::vector<Block> find(const std::string&, const std::chrono::system_clock::time_point&, const std::chrono::system_clock::time_point&, LogLevel, std::optional<size_t>) noexcept") {
+        ee::LogIndex::setEnabled(true);
+        {
+            ee::FileSink sink("myIndex.log");
+            REQUIRE(sink.open());
+            ee::LogMerge(threads).write(sink, ee::OutputFormat::String);
+        }
+        ee::LogIndex::setEnabled(false);
+
+        // Only the block around the given time range is read
+        auto since = now + std::chrono::milliseconds(40000);
+        auto blocks = ee::LogIndex::find("myIndex.log", since, since + std::chrono::milliseconds(10));
+        REQUIRE(blocks.size() == 1);
+        REQUIRE(blocks.front().since <= since);
+        REQUIRE(blocks.front().until >= since + std::chrono::milliseconds(10));
+        std::string content;
+        REQUIRE(ee::LogIndex::readContent("myIndex.log", blocks.front(), content));
+        REQUIRE(content.find(" 40005\n") != std::string::npos);
+
+        // The errors of the second thread are found by their log level and by their thread
+        auto all = std::chrono::system_clock::time_point::max();
+        auto errors = ee::LogIndex::find("myIndex.log", now, all, ee::LogLevel::Error);
+        REQUIRE(errors.size() == 4);
+        auto threadHash = std::hash<std::thread::id>()(second);
+        REQUIRE(ee::LogIndex::find("myIndex.log", now, all, ee::LogLevel::Trace, threadHash).size() == 4);
+        REQUIRE(ee::LogIndex::find("myIndex.log", now, all, ee::LogLevel::Fatal).empty());
+        REQUIRE(ee::LogIndex::readContent("myIndex.log", errors.back(), content));
+        REQUIRE(content.find("Error 70000") != std::string::npos);
+
+        // Nothing matches before the first log entry
+        REQUIRE(ee::LogIndex::find("myIndex.log", now - std::chrono::seconds(2), now - std::chrono::seconds(1)).empty());
+    }
+
+    std::remove("myIndex.log");
+}
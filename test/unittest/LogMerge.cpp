@@ -0,0 +1,91 @@
+#include "catch.hpp"
+#include <ee/LogMerge.hpp>
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("ee::LogMerge") {
+
+    auto now = std::chrono::system_clock::now();
+    std::map<std::thread::id, ee::LogBuffer> threads;
+    std::thread::id first = std::this_thread::get_id();
+    std::thread::id second;
+    std::thread([&second]() { second = std::this_thread::get_id(); }).join();
+
+    SECTION("const LogEntry* next(size_t&) noexcept") {
+        size_t threadHash = 0;
+        REQUIRE(ee::LogMerge(threads).next(threadHash) == nullptr);
+
+        // Both threads log alternately, the second one at the same dates
+        for (size_t i = 0; i < 3 * ee::LogSegment::MaxCapacity; i++) {
+            auto date = now + std::chrono::milliseconds(i);
+            threads[first].emplace_back(ee::LogLevel::Info, "", "", std::to_string(2 * i), {}, std::nullopt, date);
+            threads[second].emplace_back(i % 2 == 0 ? ee::LogLevel::Info : ee::LogLevel::Error, "", "",
+                                         std::to_string(2 * i + 1), {}, std::nullopt, date);
+        }
+
+        // The sequence numbers break the ties between the threads
+        ee::LogMerge merge(threads);
+        size_t i = 0;
+        for (auto logEntry = merge.next(threadHash); logEntry != nullptr; logEntry = merge.next(threadHash)) {
+            REQUIRE(logEntry->getMessage() == std::to_string(i));
+            REQUIRE(threadHash == std::hash<std::thread::id>()(i % 2 == 0 ? first : second));
+            i++;
+        }
+        REQUIRE(i == 6 * ee::LogSegment::MaxCapacity);
+        REQUIRE(merge.next(threadHash) == nullptr);
+    }
+
+    SECTION("LogMerge(const std::map<std::thread::id, LogBuffer>&, const SpilledLogEntries*)") {
+        threads[first].emplace_back(ee::LogLevel::Info, "", "", "Memory", {}, std::nullopt,
+                                    now + std::chrono::milliseconds(1));
+        ee::LogMerge::SpilledLogEntries spilled;
+        spilled.emplace_back(1, ee::LogEntry(ee::LogLevel::Info, "", "", "Older", {}, std::nullopt, now));
+        spilled.emplace_back(2, ee::LogEntry(ee::LogLevel::Info, "", "", "Younger", {}, std::nullopt,
+                                             now + std::chrono::milliseconds(2)));
+
+        // The spilled log entries keep the hash of their threads
+        ee::LogMerge merge(threads, &spilled);
+        size_t threadHash = 0;
+        REQUIRE(merge.next(threadHash)->getMessage() == "Older");
+        REQUIRE(threadHash == 1);
+        REQUIRE(merge.next(threadHash)->getMessage() == "Memory");
+        REQUIRE(threadHash == std::hash<std::thread::id>()(first));
+        REQUIRE(merge.next(threadHash)->getMessage() == "Younger");
+        REQUIRE(threadHash == 2);
+        REQUIRE(merge.next(threadHash) == nullptr);
+    }
+
+    SECTION("void write(FileSink&, OutputFormat)") {
+        // Enough log entries for several rounds of all workers
+        for (size_t i = 0; i < 5 * ee::LogMerge::ChunkSize; i++) {
+            auto date = now + std::chrono::microseconds(i / 3);
+            threads[i % 2 == 0 ? first : second].emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {},
+                                                              std::nullopt, date);
+        }
+
+        // The workers produce exactly what a single thread produces
+        auto workers = ee::LogMerge::getNumberOfWorkers();
+        std::string content[2];
+        for (size_t numberOfWorkers : {size_t(1), size_t(3)}) {
+            ee::LogMerge::setNumberOfWorkers(numberOfWorkers);
+            REQUIRE(ee::LogMerge::getNumberOfWorkers() == numberOfWorkers);
+            std::remove("myMerge.log");
+            {
+                ee::FileSink sink("myMerge.log");
+                REQUIRE(sink.open());
+                ee::LogMerge(threads).write(sink, ee::OutputFormat::Json);
+                REQUIRE(sink.flush());
+            }
+            std::ifstream file("myMerge.log");
+            std::stringstream stream;
+            stream << file.rdbuf();
+            content[numberOfWorkers == 1 ? 0 : 1] = stream.str();
+        }
+        REQUIRE(!content[0].empty());
+        REQUIRE(content[0] == content[1]);
+        ee::LogMerge::setNumberOfWorkers(100);
+        REQUIRE(ee::LogMerge::getNumberOfWorkers() == ee::LogMerge::MaxNumberOfWorkers);
+        ee::LogMerge::setNumberOfWorkers(workers);
+        std::remove("myMerge.log");
+    }
+}
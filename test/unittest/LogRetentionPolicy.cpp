@@ -40,6 +40,31 @@ TEST_CASE("ee::LogRetentionMaxNumber") {
         REQUIRE_FALSE(maxNumberOfLogs.retain(logEntry));
     }
 
+    SECTION("bool releaseSegment(const LogSegment &) noexcept") {
+        ee::LogSegment segment(8);
+        for (int i = 0; i < 8; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, std::chrono::system_clock::now());
+        }
+
+        // Two segments fit, the third one is decided per log entry and the fourth is released at once
+        REQUIRE_FALSE(maxNumberOfLogs.releaseSegment(segment));
+        REQUIRE(maxNumberOfLogs.retainSegment(segment));
+        REQUIRE(maxNumberOfLogs.retainSegment(segment));
+        REQUIRE_FALSE(maxNumberOfLogs.retainSegment(segment));
+        REQUIRE(maxNumberOfLogs.releaseSegment(segment));
+        REQUIRE_FALSE(maxNumberOfLogs.retain(logEntry));
+    }
+
+    SECTION("size_t releaseSpan(const LogEntry*, size_t) noexcept") {
+        std::vector<ee::LogEntry> entries(10, logEntry);
+        REQUIRE(maxNumberOfLogs.releaseSpan(entries.data(), entries.size()) == 0);
+
+        // Only 6 of the next 10 log entries fit
+        REQUIRE(maxNumberOfLogs.releaseSpan(entries.data(), entries.size()) == 4);
+        REQUIRE(maxNumberOfLogs.releaseSpan(entries.data(), entries.size()) == 10);
+        REQUIRE_FALSE(maxNumberOfLogs.retain(logEntry));
+    }
+
     SECTION("Check the basic functionality of this class") {
         // Create 64 logs
         for (int i = 0; i < 64; i++) {
@@ -52,6 +77,308 @@ TEST_CASE("ee::LogRetentionMaxNumber") {
         ee::Log::releaseLogs();
         REQUIRE(ee::Log::getNumberOfLogEntries() == 32);
     }
+
+    SECTION("Release across multiple segments") {
+        // Create enough logs to fill several segments
+        for (size_t i = 0; i < 4 * ee::LogSegment::MaxCapacity; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::to_string(i), {});
+        }
+
+        // The youngest log entries are retained
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(1500));
+        ee::Log::releaseLogs();
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 1500);
+        auto &buffer = ee::Log::getLogThreadMap().at(std::this_thread::get_id());
+        REQUIRE(buffer.begin()->getMessage() == std::to_string(4 * ee::LogSegment::MaxCapacity - 1500));
+    }
+
+    SECTION("Release across log levels") {
+        // The older trace log entry is released, not the warning between both trace log entries
+        ee::Log::log(ee::LogLevel::Trace, "MyClass", "SomeMethod", "1", {});
+        ee::Log::log(ee::LogLevel::Warning, "MyClass", "SomeMethod", "2", {});
+        ee::Log::log(ee::LogLevel::Trace, "MyClass", "SomeMethod", "3", {});
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(2));
+        REQUIRE(ee::Log::releaseLogs() == 1);
+        std::vector<std::string> messages;
+        for (auto &entry : ee::Log::getLogThreadMap().at(std::this_thread::get_id())) {
+            messages.push_back(entry.getMessage());
+        }
+        REQUIRE(messages == std::vector<std::string>{"2", "3"});
+
+        // Interleaved log levels across several segments keep exactly the youngest log entries
+        ee::Log::reset();
+        size_t numberOfLogEntries = 3 * ee::LogSegment::MaxCapacity;
+        for (size_t i = 0; i < numberOfLogEntries; i++) {
+            ee::Log::log(i % 3 == 0 ? ee::LogLevel::Warning : ee::LogLevel::Info, "MyClass", "SomeMethod",
+                         std::to_string(i), {});
+        }
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(1000));
+        ee::Log::releaseLogs();
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 1000);
+        size_t expected = numberOfLogEntries - 1000;
+        bool ordered = true;
+        for (auto &entry : ee::Log::getLogThreadMap().at(std::this_thread::get_id())) {
+            ordered = entry.getMessage() == std::to_string(expected++) && ordered;
+        }
+        REQUIRE(ordered);
+    }
+}
+
+TEST_CASE("ee::LogRetentionPolicy") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+
+    SECTION("bool appliesTo(LogLevel) const noexcept") {
+        ee::LogRetentionOlderThan allLevels(std::chrono::seconds(10));
+        REQUIRE(allLevels.getMinLogLevel() == ee::LogLevel::Trace);
+        REQUIRE(allLevels.getMaxLogLevel() == ee::LogLevel::Fatal);
+        REQUIRE(allLevels.appliesTo(ee::LogLevel::Trace));
+        REQUIRE(allLevels.appliesTo(ee::LogLevel::Fatal));
+
+        ee::LogRetentionOlderThan warningAndAbove(std::chrono::seconds(10), ee::LogLevel::Warning);
+        REQUIRE_FALSE(warningAndAbove.appliesTo(ee::LogLevel::Info));
+        REQUIRE(warningAndAbove.appliesTo(ee::LogLevel::Warning));
+        REQUIRE(warningAndAbove.appliesTo(ee::LogLevel::Fatal));
+    }
+
+    SECTION("size_t releaseSpan(const LogEntry*, size_t) noexcept") {
+        // A custom policy that only implements retain() is asked from the youngest log entry on
+        struct RetainEven : public ee::LogRetentionPolicy {
+            RetainEven() noexcept : ee::LogRetentionPolicy(1) {}
+            void init() noexcept override {}
+            bool retain(const ee::LogEntry &logEntry) noexcept override {
+                return std::stoi(logEntry.getMessage()) % 2 == 0;
+            }
+        } policy;
+
+        std::vector<ee::LogEntry> entries;
+        for (int i : {1, 2, 3, 4, 6}) {
+            entries.emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), std::vector<ee::Note>(), std::nullopt,
+                    std::chrono::system_clock::now());
+        }
+        REQUIRE(policy.releaseSpan(entries.data(), entries.size()) == 3);
+        REQUIRE(policy.releaseSpan(entries.data() + 3, 2) == 0);
+    }
+
+    SECTION("Retain every log level on its own") {
+        // Traces are cheap to lose, warnings are kept much longer
+        ee::Log::registerLogRententionPolicy(
+                std::make_shared<ee::LogRetentionMaxNumber>(10, ee::LogLevel::Trace, ee::LogLevel::Trace));
+        ee::Log::registerLogRententionPolicy(
+                std::make_shared<ee::LogRetentionMaxNumber>(1000, ee::LogLevel::Warning));
+        REQUIRE(ee::Log::getLogRetentionPolicies().size() == 2);
+
+        // Interleave the log levels
+        for (int i = 0; i < 100; i++) {
+            ee::Log::log(ee::LogLevel::Trace, "MyClass", "SomeMethod", std::to_string(i), {});
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::to_string(i), {});
+            ee::Log::log(ee::LogLevel::Error, "MyClass", "SomeMethod", std::to_string(i), {});
+        }
+        REQUIRE(ee::Log::releaseLogs() == 90);
+
+        // The youngest traces are retained, other log levels are not touched
+        auto logLevels = ee::Log::countLogLevels();
+        REQUIRE(logLevels[ee::LogLevel::Trace] == 10);
+        REQUIRE(logLevels[ee::LogLevel::Info] == 100);
+        REQUIRE(logLevels[ee::LogLevel::Error] == 100);
+        auto &buffer = ee::Log::getLogThreadMap().at(std::this_thread::get_id());
+        REQUIRE(buffer.getSegments(ee::LogLevel::Trace).front().getEntries().front().getMessage() == "90");
+    }
+}
+
+TEST_CASE("ee::LogRetentionMaxBytes") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+
+    auto stacktrace = ee::Stacktrace::create();
+    ee::LogEntry logEntry(ee::LogLevel::Info, "", "", "", {}, stacktrace, std::chrono::system_clock::now());
+    auto logEntryBytes = logEntry.getNumberOfBytes();
+    auto stacktraceBytes = stacktrace.value()->getNumberOfBytes();
+
+    SECTION("bool retain(const LogEntry &) noexcept") {
+        // The shared stacktrace is only counted for the first log entry
+        ee::LogRetentionMaxBytes maxBytes(stacktraceBytes + 3 * logEntryBytes);
+        maxBytes.init();
+        REQUIRE(maxBytes.retain(logEntry));
+        REQUIRE(maxBytes.retain(logEntry));
+        REQUIRE(maxBytes.retain(logEntry));
+        REQUIRE_FALSE(maxBytes.retain(logEntry));
+
+        // An init call resets the budget
+        maxBytes.init();
+        REQUIRE(maxBytes.retain(logEntry));
+    }
+
+    SECTION("bool releaseSegment(const LogSegment &) noexcept") {
+        ee::LogSegment segment(4);
+        for (int i = 0; i < 4; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, std::chrono::system_clock::now());
+        }
+
+        ee::LogRetentionMaxBytes maxBytes(sizeof(ee::LogSegment) + segment.getNumberOfBytes() + 1);
+        maxBytes.init();
+        REQUIRE(maxBytes.isGlobal());
+        REQUIRE_FALSE(maxBytes.releaseSegment(segment));
+        REQUIRE(maxBytes.retainSegment(segment));
+        REQUIRE_FALSE(maxBytes.releaseSegment(segment));
+        REQUIRE_FALSE(maxBytes.retainSegment(segment));
+        REQUIRE_FALSE(maxBytes.retain(segment.getEntries()[0]));
+        REQUIRE(maxBytes.releaseSegment(segment));
+    }
+
+    SECTION("size_t releaseSpan(const LogEntry*, size_t) noexcept") {
+        std::vector<ee::LogEntry> entries(5, logEntry);
+        ee::LogRetentionMaxBytes maxBytes(stacktraceBytes + 3 * logEntryBytes);
+        maxBytes.init();
+        REQUIRE(maxBytes.releaseSpan(entries.data(), entries.size()) == 2);
+    }
+
+    SECTION("void enterSegment(const LogSegment &) noexcept") {
+        // A sparse segment counts its whole capacity, its log entry only adds the memory it owns
+        ee::LogSegment segment;
+        segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, std::chrono::system_clock::now());
+        auto segmentBytes = sizeof(ee::LogSegment) + segment.getNumberOfReservedBytes();
+        auto totalBytes = segmentBytes + segment.getNumberOfBytes() - sizeof(ee::LogEntry);
+        ee::LogRetentionMaxBytes maxBytes(totalBytes - 1);
+        maxBytes.init();
+        REQUIRE_FALSE(maxBytes.retainSegment(ee::LogSegment(segment)));
+        maxBytes.enterSegment(segment);
+        REQUIRE(maxBytes.releaseSpan(segment.getEntries().data(), segment.size()) == 1);
+
+        // The log entry fits exactly once the segment is counted with its capacity
+        ee::LogRetentionMaxBytes totalBytesPolicy(totalBytes);
+        totalBytesPolicy.init();
+        totalBytesPolicy.enterSegment(segment);
+        REQUIRE(totalBytesPolicy.releaseSpan(segment.getEntries().data(), segment.size()) == 0);
+        REQUIRE(totalBytesPolicy.releaseSegment(segment));
+
+        // The capacity alone can exhaust the budget
+        ee::LogRetentionMaxBytes capacityBytes(segmentBytes - 1);
+        capacityBytes.init();
+        capacityBytes.enterSegment(segment);
+        REQUIRE(capacityBytes.releaseSpan(segment.getEntries().data(), segment.size()) == 1);
+    }
+
+    SECTION("Count an upper bound of the bytes") {
+        // Two stacktraces shared by alternating log entries
+        auto other = ee::Stacktrace::create();
+        auto otherBytes = other.value()->getNumberOfBytes();
+        ee::LogSegment segment(4);
+        for (int i = 0; i < 4; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, i % 2 == 0 ? stacktrace : other,
+                                 std::chrono::system_clock::now());
+        }
+        auto exactBytes = 4 * logEntryBytes + stacktraceBytes + otherBytes;
+        REQUIRE(segment.getNumberOfBytes() == exactBytes + stacktraceBytes + otherBytes);
+
+        // Decided one by one the log entries fit exactly, as a whole segment every run counts its stacktrace
+        ee::LogRetentionMaxBytes maxBytes(sizeof(ee::LogSegment) + exactBytes);
+        maxBytes.init();
+        REQUIRE_FALSE(maxBytes.retainSegment(segment));
+        maxBytes.enterSegment(segment);
+        REQUIRE(maxBytes.releaseSpan(segment.getEntries().data(), segment.size()) == 0);
+
+        // A stacktrace already counted by a retained segment is counted again
+        ee::LogRetentionMaxBytes segmentBytes(sizeof(ee::LogSegment) + segment.getNumberOfBytes() + logEntryBytes);
+        segmentBytes.init();
+        REQUIRE(segmentBytes.retainSegment(segment));
+        REQUIRE_FALSE(segmentBytes.retain(logEntry));
+    }
+
+    SECTION("Limit the bytes of all threads") {
+        // Create logs in two threads
+        auto createLogs = []() {
+            for (size_t i = 0; i < 4 * ee::LogSegment::MaxCapacity; i++) {
+                ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::string(100, 'x'), {});
+            }
+        };
+        std::thread thread(createLogs);
+        thread.join();
+        createLogs();
+
+        // The budget is shared by both threads
+        size_t maxBytes = 1024 * 1024;
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxBytes>(maxBytes));
+        REQUIRE(ee::Log::releaseLogs() > 0);
+        size_t retainedBytes = 0;
+        for (auto &buffer : ee::Log::getLogThreadMap()) {
+            for (auto &entry : buffer.second) {
+                retainedBytes += entry.getNumberOfBytes();
+            }
+        }
+        REQUIRE(retainedBytes <= maxBytes);
+        REQUIRE(retainedBytes > maxBytes / 2);
+        REQUIRE(ee::Log::getNumberOfBytes() >= retainedBytes);
+
+        // The reserved capacity of the segments counts as well, so the budget is a ceiling of the memory
+        REQUIRE(ee::Log::getNumberOfBytes() <= maxBytes);
+    }
+}
+
+TEST_CASE("ee::LogRetentionGlobalMaxNumber") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+
+    SECTION("bool isGlobal() const noexcept") {
+        REQUIRE(ee::LogRetentionGlobalMaxNumber(16).isGlobal());
+        REQUIRE_FALSE(ee::LogRetentionMaxNumber(16).isGlobal());
+    }
+
+    SECTION("Retain the youngest log entries of all threads") {
+        // Every thread logs after the previous one has finished
+        auto createLogs = [](size_t number) {
+            for (size_t i = 0; i < number; i++) {
+                ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::to_string(i), {});
+            }
+        };
+        std::thread first(createLogs, 3000);
+        first.join();
+        std::thread second(createLogs, 3000);
+        auto secondId = second.get_id();
+        second.join();
+        createLogs(1000);
+
+        // A global policy and a per thread policy of the same kind are both registered
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(2000));
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionGlobalMaxNumber>(1500));
+        REQUIRE(ee::Log::getLogRetentionPolicies().size() == 2);
+        REQUIRE(ee::Log::releaseLogs() == 5500);
+
+        // The youngest 1000 are from this thread, the other 500 are the youngest of the second thread
+        auto &logThreadMap = ee::Log::getLogThreadMap();
+        REQUIRE(logThreadMap.at(std::this_thread::get_id()).size() == 1000);
+        REQUIRE(logThreadMap.at(secondId).size() == 500);
+        REQUIRE(logThreadMap.at(secondId).begin()->getMessage() == "2500");
+        REQUIRE(ee::Log::getNumberOfLogEntries() == 1500);
+    }
+
+    SECTION("Retain the youngest log entries of all log levels") {
+        // Interleave two log levels, so their segments overlap in time
+        for (int i = 0; i < 200; i++) {
+            ee::Log::log(i % 2 == 0 ? ee::LogLevel::Trace : ee::LogLevel::Error, "MyClass", "SomeMethod",
+                         std::to_string(i), {});
+        }
+
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionGlobalMaxNumber>(50));
+        REQUIRE(ee::Log::releaseLogs() == 150);
+        auto logLevels = ee::Log::countLogLevels();
+        REQUIRE(logLevels[ee::LogLevel::Trace] == 25);
+        REQUIRE(logLevels[ee::LogLevel::Error] == 25);
+        auto &buffer = ee::Log::getLogThreadMap().at(std::this_thread::get_id());
+        REQUIRE(buffer.begin()->getMessage() == "150");
+    }
 }
 
 TEST_CASE("ee::LogRetentionOlderThan") {
@@ -75,4 +402,41 @@ TEST_CASE("ee::LogRetentionOlderThan") {
         REQUIRE(logRetentionPolicy.retain(logEntryYounger));
     }
 
+    SECTION("bool releaseSegment(const LogSegment &) noexcept") {
+        auto now = std::chrono::system_clock::now();
+        ee::LogSegment olderSegment, mixedSegment, youngerSegment;
+        olderSegment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now - std::chrono::seconds(100));
+        mixedSegment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now - std::chrono::seconds(100));
+        mixedSegment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now - std::chrono::seconds(32));
+        youngerSegment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now - std::chrono::seconds(32));
+
+        REQUIRE(logRetentionPolicy.releaseSegment(olderSegment));
+        REQUIRE_FALSE(logRetentionPolicy.releaseSegment(mixedSegment));
+        REQUIRE_FALSE(logRetentionPolicy.retainSegment(mixedSegment));
+        REQUIRE_FALSE(logRetentionPolicy.releaseSegment(youngerSegment));
+        REQUIRE(logRetentionPolicy.retainSegment(youngerSegment));
+    }
+
+    SECTION("size_t releaseSpan(const LogEntry*, size_t) noexcept") {
+        auto now = std::chrono::system_clock::now();
+        std::vector<ee::LogEntry> entries;
+        for (int seconds : {200, 100, 65, 63, 32, 0}) {
+            entries.emplace_back(ee::LogLevel::Info, "", "", "", std::vector<ee::Note>(), std::nullopt,
+                    now - std::chrono::seconds(seconds));
+        }
+        REQUIRE(logRetentionPolicy.releaseSpan(entries.data(), entries.size()) == 3);
+        REQUIRE(logRetentionPolicy.releaseSpan(entries.data() + 3, 3) == 0);
+        REQUIRE(logRetentionPolicy.releaseSpan(entries.data(), 2) == 2);
+
+        // The system clock was set back, the dates are not sorted anymore
+        std::vector<ee::LogEntry> unsorted;
+        for (int seconds : {0, 200, 32, 100, 0}) {
+            unsorted.emplace_back(ee::LogLevel::Info, "", "", "", std::vector<ee::Note>(), std::nullopt,
+                    now - std::chrono::seconds(seconds));
+        }
+        REQUIRE(logRetentionPolicy.releaseSpan(unsorted.data(), unsorted.size()) == 4);
+        REQUIRE(logRetentionPolicy.releaseSpan(unsorted.data(), 3) == 2);
+        REQUIRE(logRetentionPolicy.releaseSpan(unsorted.data() + 2, 1) == 0);
+    }
+
 }
\ No newline at end of file
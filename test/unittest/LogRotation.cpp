@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include <ee/LogRotation.hpp>
+#include <ee/Helper.hpp>
+#include <ee/Log.hpp>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Returns the content of the given file.
+ */
+static std::string readFile(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * @brief Replaces the content of the given file.
+ */
+static void writeFile(const std::string &filename, const std::string &content) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+/**
+ * @brief Returns whether the given file exists.
+ */
+static bool exists(const std::string &filename) {
+    struct stat status{};
+    return ::stat(filename.c_str(), &status) == 0;
+}
+
+TEST_CASE("ee::LogRotation") {
+
+    // Reset the log before every test
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+    ::mkdir("myRotation", 0755);
+
+    SECTION("bool compress(const std::string&) noexcept") {
+        // The file spans several blocks and one of them does not shrink
+        std::string content;
+        for (int i = 0; content.size() < ee::LogRotation::BlockSize * 2; i++) {
+            content += "[INFO] Entry " + std::to_string(i % 100) + " of the log file\n";
+        }
+        std::mt19937 random(42);
+        for (size_t i = 0; i < ee::LogRotation::BlockSize; i++) {
+            content += static_cast<char>(random());
+        }
+        writeFile("myRotation/myFile.log", content);
+
+        REQUIRE(ee::LogRotation::compress("myRotation/myFile.log"));
+        REQUIRE_FALSE(exists("myRotation/myFile.log"));
+        REQUIRE(readFile("myRotation/myFile.log.lz").size() < content.size());
+        REQUIRE(ee::LogRotation::decompress("myRotation/myFile.log.lz", "myRotation/myFile.log"));
+        REQUIRE(readFile("myRotation/myFile.log") == content);
+
+        // A damaged file is not decompressed
+        writeFile("myRotation/myDamaged.lz", "EELZ0001\x10");
+        REQUIRE_FALSE(ee::LogRotation::decompress("myRotation/myDamaged.lz", "myRotation/myDamaged.log"));
+        REQUIRE_FALSE(ee::LogRotation::compress("myRotation/myMissing.log"));
+    }
+
+    SECTION("bool isDue(const std::string&, const std::chrono::system_clock::time_point&) noexcept") {
+        writeFile("myRotation/myFile.log", std::string(100, 'x'));
+        auto now = std::chrono::system_clock::now();
+
+        // Without the rotation files are never due
+        REQUIRE_FALSE(ee::LogRotation::isDue("myRotation/myFile.log", now - std::chrono::hours(100)));
+
+        ee::LogRotation::start(100, std::chrono::seconds::zero(), 0);
+        REQUIRE(ee::LogRotation::isRunning());
+        REQUIRE(ee::LogRotation::isDue("myRotation/myFile.log", now));
+        ee::LogRotation::start(101, std::chrono::hours(1), 0);
+        REQUIRE_FALSE(ee::LogRotation::isDue("myRotation/myFile.log", now));
+        REQUIRE(ee::LogRotation::isDue("myRotation/myFile.log", now - std::chrono::hours(2)));
+    }
+
+    SECTION("size_t enforceLimit(const std::string&, size_t) noexcept") {
+        writeFile("myRotation/ee-log-3.log", std::string(100, 'x'));
+        writeFile("myRotation/ee-log-1.log.lz", std::string(100, 'x'));
+        writeFile("myRotation/ee-log-2.log.lz", std::string(100, 'x'));
+        writeFile("myRotation/other.log", std::string(1000, 'x'));
+
+        // The oldest files are deleted first and other files are not counted
+        REQUIRE(ee::LogRotation::enforceLimit("myRotation", 250) == 1);
+        REQUIRE_FALSE(exists("myRotation/ee-log-1.log.lz"));
+        REQUIRE(exists("myRotation/ee-log-2.log.lz"));
+
+        // The youngest file is kept even if it is too large on its own
+        REQUIRE(ee::LogRotation::enforceLimit("myRotation", 0) == 1);
+        REQUIRE(exists("myRotation/ee-log-3.log"));
+        REQUIRE(exists("myRotation/other.log"));
+    }
+
+    SECTION("void close(const std::string&) noexcept") {
+        auto compressed = ee::LogRotation::getNumberOfCompressedFiles();
+        writeFile("myRotation/ee-log-1.log", std::string(1000, 'x'));
+        writeFile("myRotation/ee-log-2.log", std::string(1000, 'x'));
+
+        // Closed files are compressed in the background and the disk usage is capped afterwards
+        ee::LogRotation::start(0, std::chrono::seconds::zero(), 500);
+        ee::LogRotation::close("myRotation/ee-log-1.log");
+        ee::LogRotation::flush();
+        REQUIRE(ee::LogRotation::getNumberOfCompressedFiles() == compressed + 1);
+        REQUIRE_FALSE(exists("myRotation/ee-log-1.log"));
+        REQUIRE_FALSE(exists("myRotation/ee-log-1.log.lz"));
+        REQUIRE(exists("myRotation/ee-log-2.log"));
+    }
+
+    SECTION("void Log::writeIncident(bool) noexcept") {
+        // Every incident exceeds the size, so the second one starts a new file
+        ee::LogRotation::start(1, std::chrono::seconds::zero(), 0);
+        ee::Log::log(ee::LogLevel::Info, "", "", "First", {});
+        ee::Log::writeIncident();
+        ee::Log::log(ee::LogLevel::Info, "", "", "Second", {});
+        ee::Log::writeIncident();
+        ee::LogRotation::flush();
+
+        size_t plain = 0, compressed = 0;
+        for (auto &file : ee::Helper::findLogFiles()) {
+            auto isCompressed = file.size() > 3 && file.compare(file.size() - 3, 3, ee::LogRotation::Extension) == 0;
+            (isCompressed ? compressed : plain)++;
+        }
+        REQUIRE(plain == 1);
+        REQUIRE(compressed == 1);
+    }
+
+    ee::LogRotation::stop();
+    REQUIRE_FALSE(ee::LogRotation::isRunning());
+    for (auto &file : {"myFile.log", "myFile.log.lz", "myDamaged.lz", "myDamaged.log", "ee-log-1.log", "ee-log-2.log",
+                       "ee-log-1.log.lz", "ee-log-2.log.lz", "ee-log-3.log", "other.log"}) {
+        std::remove((std::string("myRotation/") + file).c_str());
+    }
+    ::rmdir("myRotation");
+    for (auto &file : ee::Helper::findLogFiles()) {
+        std::remove(file.c_str());
+    }
+}
@@ -0,0 +1,130 @@
+#include "catch.hpp"
+#include <ee/LogSegment.hpp>
+
+TEST_CASE("ee::LogSegment") {
+
+    auto now = std::chrono::system_clock::now();
+    ee::LogSegment segment(4);
+
+    SECTION("LogEntry& emplace_back(...)") {
+        REQUIRE(segment.empty());
+        auto &logEntry = segment.emplace_back(ee::LogLevel::Info, "", "", "first", {}, std::nullopt, now);
+        REQUIRE(logEntry.getMessage() == "first");
+        REQUIRE(segment.size() == 1);
+
+        // References remain valid until the capacity is reached
+        for (int i = 0; i < 3; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        }
+        REQUIRE(&logEntry == &segment.getEntries().front());
+        REQUIRE(segment.full());
+    }
+
+    SECTION("const std::chrono::system_clock::time_point& getMinDateOfCreation() const noexcept") {
+        segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now - std::chrono::seconds(10));
+        segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now + std::chrono::seconds(10));
+        REQUIRE(segment.getMinDateOfCreation() == now - std::chrono::seconds(10));
+        REQUIRE(segment.getMaxDateOfCreation() == now + std::chrono::seconds(10));
+    }
+
+    SECTION("size_t release(const std::vector<bool>&) noexcept") {
+        for (int i = 0; i < 4; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "", "", std::to_string(i), {}, std::nullopt,
+                    now + std::chrono::seconds(i));
+        }
+        REQUIRE(segment.release({true, false, true, false}) == 2);
+        REQUIRE(segment.size() == 2);
+        REQUIRE(segment.getEntries()[0].getMessage() == "1");
+        REQUIRE(segment.getEntries()[1].getMessage() == "3");
+        REQUIRE(segment.getMinDateOfCreation() == now + std::chrono::seconds(1));
+        REQUIRE(segment.getMaxDateOfCreation() == now + std::chrono::seconds(3));
+        REQUIRE_FALSE(segment.full());
+    }
+
+    SECTION("size_t getNumberOfBytes() const noexcept") {
+        REQUIRE(segment.getNumberOfBytes() == 0);
+        auto stacktrace = ee::Stacktrace::create();
+        segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, stacktrace, now);
+        auto first = segment.getNumberOfBytes();
+        REQUIRE(first == segment.getEntries()[0].getNumberOfBytes() + stacktrace.value()->getNumberOfBytes());
+
+        // The previous log entry shares the stacktrace
+        segment.emplace_back(ee::LogLevel::Info, "", "", "", {}, stacktrace, now);
+        REQUIRE(segment.getNumberOfBytes() == first + segment.getEntries()[1].getNumberOfBytes());
+
+        // Releasing recalculates the number of bytes
+        segment.release({true, false});
+        REQUIRE(segment.getNumberOfBytes() == first);
+    }
+
+    SECTION("LogSegment(const LogSegment&)") {
+        segment.emplace_back(ee::LogLevel::Info, "", "", "first", {}, std::nullopt, now);
+        ee::LogSegment copy(segment);
+        REQUIRE(copy.size() == 1);
+        REQUIRE(copy.getEntries()[0].getMessage() == "first");
+        REQUIRE(copy.getMinDateOfCreation() == now);
+    }
+
+    SECTION("bool compress(std::vector<LogEntry>&)") {
+        REQUIRE_FALSE(segment.isCompressed());
+        auto stacktrace = ee::Stacktrace::create();
+        for (int i = 0; i < 4; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "MyClass", "MyMethod", "Message number " + std::to_string(i),
+                    {ee::Note("Index", i)}, stacktrace, now + std::chrono::seconds(i), static_cast<uint64_t>(i));
+        }
+        auto numberOfBytes = segment.getNumberOfBytes();
+
+        std::vector<ee::LogEntry> entries;
+        REQUIRE(segment.compress(entries));
+        REQUIRE(entries.size() == 4);
+        REQUIRE(segment.isCompressed());
+        REQUIRE(segment.getEntries().empty());
+        REQUIRE(segment.getNumberOfBytes() < numberOfBytes);
+        REQUIRE(segment.getNumberOfReservedBytes() == segment.getNumberOfBytes());
+
+        // Everything the log retention needs remains available
+        REQUIRE(segment.size() == 4);
+        REQUIRE(segment.full());
+        REQUIRE(segment.getMinDateOfCreation() == now);
+        REQUIRE(segment.getMaxDateOfCreation() == now + std::chrono::seconds(3));
+        REQUIRE(segment.getMaxSequenceNumber() == 3);
+        REQUIRE(segment.release({true}) == 0);
+
+        // A compressed segment can be copied
+        ee::LogSegment copy(segment);
+        REQUIRE(copy.isCompressed());
+        REQUIRE(copy.thaw());
+        REQUIRE(copy.size() == 4);
+    }
+
+    SECTION("bool thaw() noexcept") {
+        auto stacktrace = ee::Stacktrace::create();
+        for (int i = 0; i < 4; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "MyClass", "MyMethod", "Message number " + std::to_string(i),
+                    {ee::Note("Index", i)}, stacktrace, now + std::chrono::seconds(i), static_cast<uint64_t>(i));
+        }
+        auto numberOfBytes = segment.getNumberOfBytes();
+        std::vector<ee::LogEntry> entries;
+        REQUIRE(segment.compress(entries));
+
+        REQUIRE(segment.thaw());
+        REQUIRE_FALSE(segment.isCompressed());
+        REQUIRE(segment.size() == 4);
+        for (int i = 0; i < 4; i++) {
+            auto &logEntry = segment.getEntries()[i];
+            REQUIRE(logEntry.getMessage() == "Message number " + std::to_string(i));
+            REQUIRE(logEntry.getNotes()[0].getValue() == std::to_string(i));
+            REQUIRE(logEntry.getDateOfCreation() == now + std::chrono::seconds(i));
+            REQUIRE(logEntry.getSequenceNumber() == static_cast<uint64_t>(i));
+        }
+
+        // The log entries share their stacktrace again
+        REQUIRE(segment.getEntries()[0].getStacktrace() == segment.getEntries()[3].getStacktrace());
+        REQUIRE(segment.getNumberOfBytes() == numberOfBytes);
+
+        // Thawing twice changes nothing
+        REQUIRE(segment.thaw());
+        REQUIRE(segment.size() == 4);
+    }
+}
@@ -0,0 +1,51 @@
+#include "catch.hpp"
+#include <ee/LogSnapshot.hpp>
+#include <ee/LogSpill.hpp>
+#include <fstream>
+
+TEST_CASE("ee::LogSnapshot") {
+
+    auto now = std::chrono::system_clock::now();
+
+    SECTION("LogBuffer& emplace(const std::thread::id&)") {
+        ee::LogSnapshot snapshot;
+        REQUIRE(snapshot.size() == 0);
+        snapshot.emplace(std::this_thread::get_id()).emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        snapshot.emplace(std::this_thread::get_id()).emplace_back(ee::LogLevel::Info, "", "", "", {}, std::nullopt, now);
+        REQUIRE(snapshot.getThreads().size() == 1);
+        REQUIRE(snapshot.size() == 2);
+        REQUIRE(snapshot.getSpillSince() == std::chrono::system_clock::time_point::max());
+    }
+
+    SECTION("bool writeToFile(const std::string&, OutputFormat) const noexcept") {
+        // The spilled log entries of the window are merged with the ones in memory
+        std::remove("mySnapshot.bin");
+        std::remove("mySnapshot.jsonl");
+        REQUIRE(ee::LogSpill::open("mySnapshot.bin", 1024 * 1024));
+        ee::LogSegment segment(4);
+        for (int i = 0; i < 4; i++) {
+            segment.emplace_back(ee::LogLevel::Info, "", "", "Spilled " + std::to_string(i), {}, std::nullopt,
+                                 now + std::chrono::milliseconds(i), static_cast<uint64_t>(i));
+        }
+        ee::LogSpill::append(std::this_thread::get_id(), segment, {});
+
+        ee::LogSnapshot snapshot(now + std::chrono::milliseconds(1), now + std::chrono::milliseconds(3));
+        snapshot.emplace(std::this_thread::get_id()).emplace_back(ee::LogLevel::Info, "", "", "Memory", {},
+                                                                   std::nullopt, now + std::chrono::microseconds(1500));
+        REQUIRE(snapshot.writeToFile("mySnapshot.jsonl", ee::OutputFormat::Json));
+        std::ifstream file("mySnapshot.jsonl");
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        REQUIRE(lines.size() == 3);
+        REQUIRE(lines[0].find("Spilled 1") != std::string::npos);
+        REQUIRE(lines[1].find("Memory") != std::string::npos);
+        REQUIRE(lines[2].find("Spilled 2") != std::string::npos);
+
+        ee::LogSpill::close();
+        REQUIRE(std::remove("mySnapshot.jsonl") == 0);
+        REQUIRE(std::remove("mySnapshot.bin") == 0);
+    }
+}
@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include <ee/LogSpill.hpp>
+#include <ee/Log.hpp>
+#include <fstream>
+
+TEST_CASE("ee::LogSpill") {
+
+    auto now = std::chrono::system_clock::now();
+    std::remove("mySpill.bin");
+    ee::LogSegment segment(256);
+    for (int i = 0; i < 256; i++) {
+        segment.emplace_back(ee::LogLevel::Info, "MyClass", "MyMethod", std::to_string(i), {}, std::nullopt,
+                now + std::chrono::milliseconds(i), static_cast<uint64_t>(i));
+    }
+
+    SECTION("bool open(const std::string&, size_t, const std::chrono::milliseconds&) noexcept") {
+        REQUIRE_FALSE(ee::LogSpill::isOpen());
+        REQUIRE(ee::LogSpill::open("mySpill.bin", 1000, std::chrono::minutes(5)));
+        REQUIRE(ee::LogSpill::isOpen());
+        REQUIRE(ee::LogSpill::getCapacity() == ee::LogSpill::MinCapacity);
+        REQUIRE(ee::LogSpill::getIncidentWindow() == std::chrono::minutes(5));
+        ee::LogSpill::append(std::this_thread::get_id(), segment, {});
+        auto numberOfBytes = ee::LogSpill::getNumberOfBytes();
+        REQUIRE(numberOfBytes > 0);
+
+        // A file with the same capacity is continued
+        ee::LogSpill::close();
+        REQUIRE_FALSE(ee::LogSpill::isOpen());
+        REQUIRE(ee::LogSpill::open("mySpill.bin", 1000));
+        REQUIRE(ee::LogSpill::getNumberOfBytes() == numberOfBytes);
+
+        // Any other file starts empty
+        ee::LogSpill::close();
+        REQUIRE(ee::LogSpill::open("mySpill.bin", 8192));
+        REQUIRE(ee::LogSpill::getNumberOfBytes() == 0);
+        REQUIRE(ee::LogSpill::read(now).empty());
+    }
+
+    SECTION("void append(const std::thread::id&, const LogSegment&, const std::vector<bool>&) noexcept") {
+        // Nothing happens without a file
+        auto spilledBefore = ee::LogSpill::getNumberOfSpilledLogEntries();
+        ee::LogSpill::append(std::this_thread::get_id(), segment, {});
+        REQUIRE(ee::LogSpill::getNumberOfSpilledLogEntries() == spilledBefore);
+
+        // Only the marked log entries are spilled
+        REQUIRE(ee::LogSpill::open("mySpill.bin", 1024 * 1024));
+        std::vector<bool> release(256, false);
+        release[3] = true;
+        release[5] = true;
+        ee::LogSpill::append(std::this_thread::get_id(), segment, release);
+        REQUIRE(ee::LogSpill::getNumberOfSpilledLogEntries() == spilledBefore + 2);
+        auto logEntries = ee::LogSpill::read(now);
+        REQUIRE(logEntries.size() == 2);
+        REQUIRE(logEntries[0].first == std::hash<std::thread::id>()(std::this_thread::get_id()));
+        REQUIRE(logEntries[0].second.getMessage() == "3");
+        REQUIRE(logEntries[1].second.getMessage() == "5");
+    }
+
+    SECTION("std::vector<std::pair<size_t, LogEntry>> read(const std::chrono::system_clock::time_point&, const std::chrono::system_clock::time_point&) noexcept") {
+        // The ring holds only the youngest records and wraps around many times
+        REQUIRE(ee::LogSpill::open("mySpill.bin", ee::LogSpill::MinCapacity));
+        for (int i = 0; i < 20; i++) {
+            ee::LogSpill::append(std::this_thread::get_id(), segment, {});
+            REQUIRE(ee::LogSpill::getNumberOfBytes() <= ee::LogSpill::getCapacity());
+        }
+        auto logEntries = ee::LogSpill::read(now);
+        REQUIRE_FALSE(logEntries.empty());
+        REQUIRE(logEntries.size() < 256);
+        REQUIRE(logEntries.back().second.getMessage() == "255");
+        for (size_t i = 1; i < logEntries.size(); i++) {
+            REQUIRE(logEntries[i - 1].second.getDateOfCreation() <= logEntries[i].second.getDateOfCreation());
+        }
+
+        // Only the log entries of the window are read
+        auto window = ee::LogSpill::read(now + std::chrono::milliseconds(250));
+        REQUIRE(window.size() == 6);
+        REQUIRE(window.front().second.getMessage() == "250");
+        window = ee::LogSpill::read(now + std::chrono::milliseconds(250), now + std::chrono::milliseconds(253));
+        REQUIRE(window.size() == 3);
+        REQUIRE(window.back().second.getMessage() == "252");
+    }
+
+    SECTION("bool writeToFile(const std::string&, const std::chrono::system_clock::time_point&, OutputFormat, const std::chrono::system_clock::time_point&) noexcept") {
+        REQUIRE(ee::LogSpill::open("mySpill.bin", 1024 * 1024));
+        ee::LogSpill::append(std::this_thread::get_id(), segment, {});
+        REQUIRE(ee::LogSpill::writeToFile("mySpill.jsonl", now + std::chrono::milliseconds(246),
+                ee::OutputFormat::Json));
+        std::ifstream file("mySpill.jsonl");
+        std::string line;
+        size_t lines = 0;
+        while (std::getline(file, line)) {
+            REQUIRE(line.find("\"thread\":") != std::string::npos);
+            lines++;
+        }
+        REQUIRE(lines == 10);
+        REQUIRE(std::remove("mySpill.jsonl") == 0);
+    }
+
+    SECTION("Log::releaseLogs() spills the released log entries") {
+        ee::Log::reset();
+        ee::Log::removeLogRetentionPolicies();
+        REQUIRE(ee::LogSpill::open("mySpill.bin", 1024 * 1024));
+        for (int i = 0; i < 64; i++) {
+            ee::Log::log(ee::LogLevel::Info, "MyClass", "SomeMethod", std::to_string(i), {});
+        }
+        ee::Log::registerLogRententionPolicy(std::make_shared<ee::LogRetentionMaxNumber>(32));
+        REQUIRE(ee::Log::releaseLogs() == 32);
+        auto logEntries = ee::LogSpill::read(now);
+        REQUIRE(logEntries.size() == 32);
+        REQUIRE(logEntries.front().second.getMessage() == "0");
+        REQUIRE(logEntries.back().second.getMessage() == "31");
+
+        ee::Log::reset();
+        ee::Log::removeLogRetentionPolicies();
+    }
+
+    ee::LogSpill::close();
+    std::remove("mySpill.bin");
+}
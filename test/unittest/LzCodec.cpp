@@ -0,0 +1,37 @@
+#include "catch.hpp"
+#include <ee/LzCodec.hpp>
+
+TEST_CASE("ee::LzCodec") {
+
+    // Log entries repeat a lot, but the numbers change
+    std::string original;
+    for (int i = 0; i < 1000; i++) {
+        original += "MyClass::myMethod(int) Message number " + std::to_string(i) + '\n';
+    }
+
+    SECTION("void compress(const char*, size_t, std::string&)") {
+        std::string block = "prefix";
+        ee::LzCodec::compress(original.data(), original.size(), block);
+        REQUIRE(block.compare(0, 6, "prefix") == 0);
+        REQUIRE(block.size() < original.size() / 3);
+    }
+
+    SECTION("bool decompress(const char*, size_t, size_t, std::string&) noexcept") {
+        for (auto &input : {original, std::string(), std::string("abc"), std::string(100000, 'x')}) {
+            std::string block;
+            ee::LzCodec::compress(input.data(), input.size(), block);
+            std::string output = "prefix";
+            REQUIRE(ee::LzCodec::decompress(block.data(), block.size(), input.size(), output));
+            REQUIRE(output == "prefix" + input);
+        }
+
+        // Damaged blocks are rejected and leave the buffer unchanged
+        std::string block;
+        ee::LzCodec::compress(original.data(), original.size(), block);
+        std::string output = "prefix";
+        REQUIRE_FALSE(ee::LzCodec::decompress(block.data(), block.size(), original.size() + 1, output));
+        REQUIRE_FALSE(ee::LzCodec::decompress(block.data(), block.size() / 2, original.size(), output));
+        REQUIRE(output == "prefix");
+    }
+
+}
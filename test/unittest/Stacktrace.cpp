@@ -36,4 +36,17 @@ TEST_CASE("ee::Stacktrace") {
         REQUIRE(str.find("Fourthline") == std::string::npos);
     }
 
+    SECTION("size_t getNumberOfBytes() const noexcept") {
+        REQUIRE(stacktrace.getNumberOfBytes() > sizeof(ee::Stacktrace) + 3 * sizeof(std::string));
+
+        // Every line adds to the number of bytes
+        ee::Stacktrace longerStacktrace({
+            {0, "firstline"},
+            {1, "Secondline"},
+            {2, "Thirdline"},
+            {3, std::string(1000, 'x')},
+        });
+        REQUIRE(longerStacktrace.getNumberOfBytes() > stacktrace.getNumberOfBytes() + 1000);
+    }
+
 }
\ No newline at end of file
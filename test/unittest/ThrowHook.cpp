@@ -0,0 +1,67 @@
+#include "catch.hpp"
+#include <ee/ThrowHook.hpp>
+#include <ee/Log.hpp>
+
+TEST_CASE("ee::ThrowHook") {
+
+    ee::Log::reset();
+    ee::Log::removeCallbacks();
+    ee::Log::removeOutstreams();
+    ee::Log::removeLogRetentionPolicies();
+
+    SECTION("static void enable(uint32_t) noexcept") {
+        ee::ThrowHook::enable(4);
+        REQUIRE(ee::ThrowHook::isEnabled());
+        REQUIRE(ee::ThrowHook::getSamplingRate() == 4);
+        ee::ThrowHook::disable();
+        REQUIRE_FALSE(ee::ThrowHook::isEnabled());
+    }
+
+    SECTION("static std::optional<std::shared_ptr<Stacktrace>> getStacktrace(const std::exception&) noexcept") {
+        ee::ThrowHook::enable();
+        try {
+            throw std::runtime_error("thrown");
+        } catch (std::exception& e) {
+            auto stacktrace = ee::ThrowHook::getStacktrace(e);
+            REQUIRE(stacktrace.has_value() == ee::ThrowHook::isAvailable());
+            if (stacktrace.has_value()) {
+                REQUIRE_FALSE(stacktrace->get()->getLines().empty());
+            }
+        }
+
+        // Another exception never gets the stacktrace of the captured one
+        std::runtime_error notThrown("not thrown");
+        REQUIRE_FALSE(ee::ThrowHook::getStacktrace(notThrown).has_value());
+        ee::ThrowHook::disable();
+    }
+
+    SECTION("Only every n-th throw is captured") {
+        ee::ThrowHook::enable(2);
+        size_t captured = 0;
+        for (int i = 0; i < 4; i++) {
+            try {
+                throw std::logic_error("thrown");
+            } catch (std::exception& e) {
+                captured += ee::ThrowHook::getStacktrace(e).has_value() ? 1 : 0;
+            }
+        }
+        REQUIRE(captured == (ee::ThrowHook::isAvailable() ? 2 : 0));
+        ee::ThrowHook::disable();
+    }
+
+    SECTION("Log::log(LogLevel, const std::exception&) uses the stacktrace of the throw site") {
+        ee::ThrowHook::enable();
+        try {
+            throw std::runtime_error("thrown");
+        } catch (std::exception& e) {
+            CATCH(ee::LogLevel::Warning, e);
+        }
+        ee::ThrowHook::disable();
+        auto& logEntry = *ee::Log::getLogThreadMap().at(std::this_thread::get_id()).begin();
+        REQUIRE(logEntry.getStacktrace().has_value());
+        if (ee::ThrowHook::isAvailable()) {
+            REQUIRE(logEntry.getStacktrace()->get()->asString().find("ee::Log::log") == std::string::npos);
+        }
+    }
+
+}
@@ -0,0 +1,79 @@
+#include "catch.hpp"
+#include <ee/ThrowStatistics.hpp>
+#include <thread>
+#include <fstream>
+
+DEFINE_EXCEPTION(MyStatisticsException);
+
+TEST_CASE("ee::ThrowStatistics") {
+
+    ee::ThrowStatistics::setEnabled(true);
+    ee::ThrowStatistics::reset();
+
+    SECTION("static void record(const std::type_info&, const std::string&, const std::optional<std::shared_ptr<Stacktrace>>&) noexcept") {
+        REQUIRE(ee::ThrowStatistics::getThrowSites().empty());
+
+        for (int i = 0; i < 3; i++) {
+            ee::Exception exception("FirstCaller", "message", {});
+        }
+        ee::Exception exception("SecondCaller", "message", {});
+        MyStatisticsException customException("FirstCaller", "message", {});
+
+        auto sites = ee::ThrowStatistics::getThrowSites();
+        REQUIRE(sites.size() == 3);
+        REQUIRE(sites[0].getType() == "ee::Exception");
+        REQUIRE(sites[0].getCaller() == "FirstCaller");
+        REQUIRE(sites[0].getCount() == 3);
+        REQUIRE(sites[0].getFirstOccurrence() <= sites[0].getLastOccurrence());
+        REQUIRE(sites[0].getStacktrace().has_value());
+        REQUIRE(std::count_if(sites.begin(), sites.end(), [](const ee::ThrowSite& site) {
+            return site.getType() == "MyStatisticsException" && site.getCount() == 1;
+        }) == 1);
+    }
+
+    SECTION("Exceptions of multiple threads are counted for the same site") {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([]() {
+                for (int j = 0; j < 100; j++) {
+                    ee::ThrowStatistics::record(typeid(ee::Exception), "ThreadCaller", std::nullopt);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto sites = ee::ThrowStatistics::getThrowSites();
+        REQUIRE(sites.size() == 1);
+        REQUIRE(sites[0].getCount() == 400);
+    }
+
+    SECTION("static void reset() noexcept") {
+        ee::Exception exception("Caller", "message", {});
+        REQUIRE(ee::ThrowStatistics::getThrowSites().size() == 1);
+        ee::ThrowStatistics::reset();
+        REQUIRE(ee::ThrowStatistics::getThrowSites().empty());
+    }
+
+    SECTION("static void setEnabled(bool) noexcept") {
+        ee::ThrowStatistics::setEnabled(false);
+        REQUIRE_FALSE(ee::ThrowStatistics::isEnabled());
+        ee::Exception exception("Caller", "message", {});
+        REQUIRE(ee::ThrowStatistics::getThrowSites().empty());
+        ee::ThrowStatistics::setEnabled(true);
+    }
+
+    SECTION("static bool writeToFile(const std::string&, OutputFormat) noexcept") {
+        ee::Exception exception("Caller", "message", {});
+        REQUIRE(ee::ThrowStatistics::writeToFile("throw-statistics.log", ee::OutputFormat::Json));
+
+        std::ifstream file("throw-statistics.log");
+        std::string line;
+        REQUIRE(std::getline(file, line));
+        REQUIRE(line.find("\"caller\":\"Caller\",\"count\":1") != std::string::npos);
+        file.close();
+        REQUIRE(std::remove("throw-statistics.log") == 0);
+    }
+
+}